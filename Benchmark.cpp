@@ -0,0 +1,152 @@
+#include "Benchmark.h"
+
+// Scenes
+void highTriangleCountScene(Scene& scene, unsigned int gridSize) {
+    scene.defaultScene();
+
+    MemoryArena& arena = scene.getGeometryArena();
+    std::vector<Object3D*> triangles;
+    triangles.reserve(2 * gridSize*gridSize);
+
+    // Bumpy floor on the whole floor of the default scene (x from -2 to 2, z from 0 to -5)
+    auto getFloorPoint = [gridSize](unsigned int indexX, unsigned int indexZ) {
+        double x = -2.0 + 4.0*indexX / gridSize;
+        double z = -5.0*indexZ / gridSize;
+        double y = -1.99 + 0.05*(1 + sin(5 * x)*cos(5 * z));
+        return DoubleVec3D(x, y, z);
+    };
+
+    for (unsigned int indexX = 0; indexX < gridSize; indexX++) {
+        for (unsigned int indexZ = 0; indexZ < gridSize; indexZ++) {
+            DoubleVec3D point00 = getFloorPoint(indexX, indexZ);
+            DoubleVec3D point10 = getFloorPoint(indexX + 1, indexZ);
+            DoubleVec3D point01 = getFloorPoint(indexX, indexZ + 1);
+            DoubleVec3D point11 = getFloorPoint(indexX + 1, indexZ + 1);
+
+            // Counterclockwise when seen from above
+            triangles.push_back(new (arena) Triangle(point00, point11, point01, new (arena) DiffuseMaterial(DoubleVec3D(0.6))));
+            triangles.push_back(new (arena) Triangle(point11, point00, point10, new (arena) DiffuseMaterial(DoubleVec3D(0.6))));
+        }
+    }
+
+    scene.addObjectGroup(Object3DGroup("Bumpy floor", triangles, &arena));
+}
+
+void manyLightsScene(Scene& scene, unsigned int lampsPerSide) {
+    scene.defaultScene();
+
+    std::vector<Object3D*> lamps;
+    double spacing = 3.6 / lampsPerSide;
+    double radius = spacing / 5;
+    // Together, the small lamps emit as much as the default one (emittance 4000, radius 0.5)
+    double emittanceFactor = 4000.0 * 0.5*0.5 / (radius*radius) / (lampsPerSide*lampsPerSide);
+    for (unsigned int indexX = 0; indexX < lampsPerSide; indexX++) {
+        for (unsigned int indexZ = 0; indexZ < lampsPerSide; indexZ++) {
+            DoubleVec3D center(-1.8 + (indexX + 0.5)*spacing, 1.8, -0.5 - (indexZ + 0.5)*spacing);
+            DoubleVec3D emittance = DoubleVec3D(0.5 + indexX % 2, 0.5 + indexZ % 2, 1) * emittanceFactor;
+            lamps.push_back(new Sphere(center, radius, new DiffuseMaterial(DoubleVec3D(0), emittance)));
+        }
+    }
+
+    scene.addObjectGroup(Object3DGroup("Small lamps", lamps));
+}
+
+void refractionHeavyScene(Scene& scene, unsigned int spheresPerSide) {
+    scene.defaultScene();
+
+    std::vector<Object3D*> spheres;
+    double spacing = 3.0 / spheresPerSide;
+    for (unsigned int indexX = 0; indexX < spheresPerSide; indexX++) {
+        for (unsigned int indexY = 0; indexY < spheresPerSide; indexY++) {
+            DoubleVec3D center(-1.5 + (indexX + 0.5)*spacing, -1.5 + (indexY + 0.5)*spacing, -2.5);
+            spheres.push_back(new Sphere(center, spacing*0.4, new RefractiveMaterial(1.5)));
+        }
+    }
+
+    scene.addObjectGroup(Object3DGroup("Glass spheres", spheres));
+}
+
+
+// Benchmark
+json benchmarkScene(Scene& scene, std::string name) {
+    setRandomSeed(BENCHMARK_RANDOM_SEED);
+    Picture* picture = scene.render(false);
+
+    RayCounters rayCounters = scene.getRayCounters();
+    double renderTime = picture->getRenderTime();
+    double numberSamples = (double)picture->getWidth() * picture->getHeight() * scene.getSamplesPerPixel();
+
+    json result = {
+        {"Name", name},
+        {"NumberObjects", scene.getObjects().size()},
+        {"NumberLamps", scene.getLamps().size()},
+        {"KDTreeCreationTime", scene.getKDTreeCreationTime()},
+        {"KDTreeBuiltNodes", scene.getKDTreeBuiltNodes()},
+        {"KDTreeUnbuiltNodes", scene.getKDTreeUnbuiltNodes()},
+        {"SBVHCreationTime", scene.getSBVHCreationTime()},
+        {"SBVHDuplicatedReferences", scene.getSBVHDuplicatedReferences()},
+        {"SBVHSAHCost", scene.getSBVHSAHCost()},
+        {"RenderTime", renderTime},
+        {"Rays", rayCounters},
+        {"PrimaryRaysPerSecond", rayCounters.primaryRays / renderTime},
+        {"SecondaryRaysPerSecond", rayCounters.secondaryRays / renderTime},
+        {"ShadowRaysPerSecond", rayCounters.shadowRays / renderTime},
+        {"RaysPerSecond", rayCounters.getTotalRays() / renderTime},
+        {"SamplesPerSecond", numberSamples / renderTime},
+        {"PeakMemory", getPeakMemoryUsage()}  // Of the whole process, so it never decreases from one scene to the next
+    };
+
+    delete picture;
+    scene.resetAndDeleteObjectGroups();
+    return result;
+}
+
+json runBenchmark(unsigned int width, unsigned int height, unsigned int samplesPerPixel, unsigned int numberThreads) {
+    double beginningTime = getCurrentTimeSeconds();
+
+    auto setParameters = [=](Scene& scene) {
+        scene.getCameraReference().setNumberPixelsX(width);
+        scene.getCameraReference().setNumberPixelsY(height);
+        scene.setSamplesPerPixel(samplesPerPixel);
+        scene.setNumberThreads(numberThreads);
+        scene.setBackupParameters(false);
+        scene.setBackupObjectGroups(false);
+        scene.setBackupPicture(false);
+    };
+
+    json results = json::array();
+    {
+        Scene scene;
+        setParameters(scene);
+        scene.defaultScene();
+        results.push_back(benchmarkScene(scene, "Default"));
+    }
+    {
+        Scene scene;
+        setParameters(scene);
+        highTriangleCountScene(scene, 200);
+        results.push_back(benchmarkScene(scene, "HighTriangleCount"));
+    }
+    {
+        Scene scene;
+        setParameters(scene);
+        manyLightsScene(scene, 8);
+        results.push_back(benchmarkScene(scene, "ManyLights"));
+    }
+    {
+        Scene scene;
+        setParameters(scene);
+        refractionHeavyScene(scene, 6);
+        results.push_back(benchmarkScene(scene, "RefractionHeavy"));
+    }
+
+    return {
+        {"Width", width},
+        {"Height", height},
+        {"SamplesPerPixel", samplesPerPixel},
+        {"NumberThreads", numberThreads},
+        {"Scenes", results},
+        {"TotalTime", getCurrentTimeSeconds() - beginningTime},
+        {"PeakMemory", getPeakMemoryUsage()}
+    };
+}
@@ -0,0 +1,67 @@
+#ifndef DEF_BENCHMARK
+#define DEF_BENCHMARK
+
+#include "Scene.h"
+
+/*!
+    \file Benchmark.h
+    \brief Defines the rendering benchmark.
+    \details The benchmark renders a fixed set of scenes and reports, for each of them, the k-d tree creation time, the number of rays per second by type, the number of samples per second and the peak memory usage. The scenes are always built the same way and the random engine is seeded with BENCHMARK_RANDOM_SEED before each render.
+
+    \var constexpr unsigned int BENCHMARK_RANDOM_SEED
+    \brief Seed given to setRandomSeed() before each benchmark render.
+
+    \var constexpr unsigned int BENCHMARK_DEFAULT_SIZE
+    \brief Default width and height of the benchmark pictures.
+
+    \var constexpr unsigned int BENCHMARK_DEFAULT_SAMPLES_PER_PIXEL
+    \brief Default number of samples per pixel of the benchmark renders.
+
+    \fn void highTriangleCountScene(Scene& scene, unsigned int gridSize)
+    \brief Fills a scene with the default scene and a bumpy floor made of many triangles.
+    \details The floor is allocated in the geometry arena of the scene.
+    \param scene The scene that will be filled.
+    \param gridSize The floor is a grid of gridSize*gridSize squares, each made of two triangles.
+    \sa Scene::defaultScene()
+
+    \fn void manyLightsScene(Scene& scene, unsigned int lampsPerSide)
+    \brief Fills a scene with the default scene and a grid of small lamps under the ceiling.
+    \param scene The scene that will be filled.
+    \param lampsPerSide The lamps form a grid of lampsPerSide*lampsPerSide spheres.
+    \sa Scene::defaultScene()
+
+    \fn void refractionHeavyScene(Scene& scene, unsigned int spheresPerSide)
+    \brief Fills a scene with the default scene and a grid of glass spheres.
+    \param scene The scene that will be filled.
+    \param spheresPerSide The glass spheres form a grid of spheresPerSide*spheresPerSide spheres.
+    \sa Scene::defaultScene()
+
+    \fn json benchmarkScene(Scene& scene, std::string name)
+    \brief Renders a scene and measures its performance.
+    \param scene The scene that will be rendered. Its objects are deleted afterwards.
+    \param name The name of the scene in the results.
+    \return The results of this scene.
+
+    \fn json runBenchmark(unsigned int width, unsigned int height, unsigned int samplesPerPixel, unsigned int numberThreads)
+    \brief Renders all the benchmark scenes.
+    \param width The width of the pictures.
+    \param height The height of the pictures.
+    \param samplesPerPixel The number of samples per pixel.
+    \param numberThreads The number of CPU threads.
+    \return The results of the whole benchmark.
+*/
+
+constexpr unsigned int BENCHMARK_RANDOM_SEED = 42;
+constexpr unsigned int BENCHMARK_DEFAULT_SIZE = 128;
+constexpr unsigned int BENCHMARK_DEFAULT_SAMPLES_PER_PIXEL = 4;
+
+// Scenes
+void highTriangleCountScene(Scene& scene, unsigned int gridSize);
+void manyLightsScene(Scene& scene, unsigned int lampsPerSide);
+void refractionHeavyScene(Scene& scene, unsigned int spheresPerSide);
+
+// Benchmark
+json benchmarkScene(Scene& scene, std::string name);
+json runBenchmark(unsigned int width, unsigned int height, unsigned int samplesPerPixel, unsigned int numberThreads);
+
+#endif
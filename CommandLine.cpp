@@ -0,0 +1,284 @@
+#include "CommandLine.h"
+
+// Usage
+void printCommandLineUsage(std::ostream& stream) {
+    stream << "Usage: PathTracer [arguments]" << std::endl;
+    stream << "Without any argument, the interactive interface is started." << std::endl << std::endl;
+    stream << "  --parameters <file>     load parameters from a " << PARAMETERS_SAVE_EXTENSION << " file (default parameters else)" << std::endl;
+    stream << "  --objects <file>        add the object groups of a " << OBJECTS_SAVE_EXTENSION << " file (can be repeated, default scene if never used)" << std::endl;
+    stream << "  --output <file>         file to which the picture is written (required). A ." << PICTURE_SAVE_EXTENSION_JSON << " file stores the radiance, any other extension is exported" << std::endl;
+    stream << "  --spp <number>          override the number of samples per pixel" << std::endl;
+    stream << "  --threads <number>      override the number of CPU threads" << std::endl;
+    stream << "  --width <number>        override the picture width" << std::endl;
+    stream << "  --height <number>       override the picture height" << std::endl;
+    stream << "  --middle-grey <number>  middle-grey used to export the picture (default 100)" << std::endl;
+    stream << "  --moving-average <n>    size of the moving average used to export the picture (default 0)" << std::endl;
+    stream << "  --benchmark <file>      render the benchmark scenes instead and write the results to a json file (--spp, --threads, --width and --height can be used)" << std::endl;
+    stream << "  --no-backup             do not back up parameters, object groups and picture" << std::endl;
+    stream << "  --help                  print this message" << std::endl;
+}
+
+
+// Files
+bool loadJsonFile(std::string fileName, json& j, std::string& error) {
+    if (!fileExists(fileName)) {
+        error = "The file " + fileName + " does not exist.";
+        return false;
+    }
+
+    std::ifstream file;
+    file.open(fileName);
+    try {
+        file >> j;
+        file.close();
+    }
+    catch (const json::exception& e) {
+        if (file.is_open())
+            file.close();
+        error = "The file " + fileName + " is corrupted. Error: " + e.what();
+        return false;
+    }
+    return true;
+}
+
+
+// Main function
+int renderFromCommandLine(int argc, char* argv[]) {
+    double beginningTime = getCurrentTimeSeconds();
+
+    std::string parametersFileName;
+    std::vector<std::string> objectsFileNames;
+    std::string outputFileName;
+    std::string benchmarkFileName;
+    int samplesPerPixel = -1;  // -1 = no override
+    int numberThreads = -1;
+    int width = -1;
+    int height = -1;
+    double middleGrey = 100.0;
+    unsigned int movingAverageSize = 0;
+    bool noBackup = false;
+
+    json summary;
+    // Prints the error, and the summary so that the caller knows what went wrong without parsing the standard error
+    auto fail = [&summary](int exitCode, const std::string& error) {
+        std::cerr << error << std::endl;
+        summary["Status"] = "Error";
+        summary["ExitCode"] = exitCode;
+        summary["Error"] = error;
+        std::cout << summary.dump() << std::endl;
+        return exitCode;
+    };
+    // The whole value must be a number, so that "3.5" or "2x" are not silently truncated
+    auto parseInt = [](const std::string& value) {
+        std::size_t length;
+        int number = std::stoi(value, &length);
+        if (length != value.size())
+            throw std::invalid_argument(value);
+        return number;
+    };
+    auto parseDouble = [](const std::string& value) {
+        std::size_t length;
+        double number = std::stod(value, &length);
+        if (length != value.size())
+            throw std::invalid_argument(value);
+        return number;
+    };
+
+    // Arguments
+    for (int index = 1; index < argc; index++) {
+        std::string argument = argv[index];
+
+        if (argument == "--help") {
+            printCommandLineUsage(std::cout);
+            return EXIT_CODE_SUCCESS;
+        }
+        if (argument == "--no-backup") {
+            noBackup = true;
+            continue;
+        }
+
+        if (index + 1 >= argc)
+            return fail(EXIT_CODE_INVALID_ARGUMENTS, "The argument " + argument + " needs a value.");
+        std::string value = argv[++index];
+        int number = 0;
+
+        try {
+            if (argument == "--parameters")
+                parametersFileName = value;
+            else if (argument == "--objects")
+                objectsFileNames.push_back(value);
+            else if (argument == "--output")
+                outputFileName = value;
+            else if (argument == "--benchmark")
+                benchmarkFileName = value;
+            else if (argument == "--spp")
+                samplesPerPixel = number = parseInt(value);
+            else if (argument == "--threads")
+                numberThreads = number = parseInt(value);
+            else if (argument == "--width")
+                width = number = parseInt(value);
+            else if (argument == "--height")
+                height = number = parseInt(value);
+            else if (argument == "--middle-grey")
+                middleGrey = parseDouble(value);
+            else if (argument == "--moving-average")
+                number = parseInt(value);
+            else {
+                printCommandLineUsage(std::cerr);
+                return fail(EXIT_CODE_INVALID_ARGUMENTS, "Unknown argument " + argument + ".");
+            }
+        }
+        catch (const std::exception&) {  // std::invalid_argument or std::out_of_range
+            return fail(EXIT_CODE_INVALID_ARGUMENTS, "The value " + value + " of " + argument + " is not a valid number.");
+        }
+
+        // Checked when they are given, as -1 means that there is no override
+        bool isOverride = argument == "--spp" || argument == "--threads" || argument == "--width" || argument == "--height";
+        if ((isOverride && number <= 0) || (argument == "--middle-grey" && middleGrey <= 0))
+            return fail(EXIT_CODE_INVALID_ARGUMENTS, "The value " + value + " of " + argument + " must be strictly positive.");
+        if (argument == "--moving-average") {
+            if (number < 0)
+                return fail(EXIT_CODE_INVALID_ARGUMENTS, "The value " + value + " of " + argument + " must not be negative.");
+            movingAverageSize = number;
+        }
+    }
+
+    // Benchmark
+    if (!benchmarkFileName.empty()) {
+        json results = runBenchmark(width > 0 ? width : BENCHMARK_DEFAULT_SIZE,
+                                    height > 0 ? height : BENCHMARK_DEFAULT_SIZE,
+                                    samplesPerPixel > 0 ? samplesPerPixel : BENCHMARK_DEFAULT_SAMPLES_PER_PIXEL,
+                                    numberThreads > 0 ? numberThreads : omp_get_max_threads());
+
+        std::ofstream file;
+        file.open(benchmarkFileName);
+        file << std::setw(4) << results << std::endl;
+        file.close();
+        if (!fileExists(benchmarkFileName))
+            return fail(EXIT_CODE_OUTPUT_ERROR, "The results could not be written to " + benchmarkFileName + ".");
+
+        std::cout << results.dump() << std::endl;
+        return EXIT_CODE_SUCCESS;
+    }
+
+    if (outputFileName.empty()) {
+        printCommandLineUsage(std::cerr);
+        return fail(EXIT_CODE_INVALID_ARGUMENTS, "No output file was given.");
+    }
+
+    // Scene
+    Scene scene;
+    std::string error;
+    double loadingBeginningTime = getCurrentTimeSeconds();
+
+    if (!parametersFileName.empty()) {
+        json jsonParameters;
+        if (!loadJsonFile(parametersFileName, jsonParameters, error))
+            return fail(EXIT_CODE_INVALID_INPUT_FILE, error);
+        try {
+            scene.setParametersFromJson(jsonParameters);
+        }
+        catch (const json::exception& e) {
+            return fail(EXIT_CODE_INVALID_INPUT_FILE, "The file " + parametersFileName + " is corrupted. Error: " + e.what());
+        }
+    }
+
+    if (objectsFileNames.empty())
+        scene.defaultScene();
+    for (std::string objectsFileName : objectsFileNames) {
+        json jsonObjects;
+        if (!loadJsonFile(objectsFileName, jsonObjects, error))
+            return fail(EXIT_CODE_INVALID_INPUT_FILE, error);
+        try {
+            scene.addObjectGroupsFromJson(jsonObjects);
+        }
+        catch (const json::exception& e) {
+            return fail(EXIT_CODE_INVALID_INPUT_FILE, "The file " + objectsFileName + " is corrupted. Error: " + e.what());
+        }
+    }
+    double loadingTime = getCurrentTimeSeconds() - loadingBeginningTime;
+
+    // Overrides
+    PerspectiveCamera& camera = scene.getCameraReference();
+    if (samplesPerPixel > 0)
+        scene.setSamplesPerPixel(samplesPerPixel);
+    if (numberThreads > 0)
+        scene.setNumberThreads(numberThreads);
+    if (width > 0)
+        camera.setNumberPixelsX(width);
+    if (height > 0)
+        camera.setNumberPixelsY(height);
+    if (noBackup) {
+        scene.setBackupParameters(false);
+        scene.setBackupObjectGroups(false);
+        scene.setBackupPicture(false);
+    }
+
+    std::string ignoredOptionsWarning = scene.getIgnoredOptionsWarning();
+    if (!ignoredOptionsWarning.empty())
+        std::cerr << ignoredOptionsWarning << std::endl;
+
+    // Render
+    double renderBeginningTime = getCurrentTimeSeconds();
+    Picture* picture = scene.render(false);
+    double renderCallTime = getCurrentTimeSeconds() - renderBeginningTime;
+
+    // Output
+    double outputBeginningTime = getCurrentTimeSeconds();
+    std::string outputExtension = outputFileName.substr(outputFileName.find_last_of('.') + 1);
+    try {
+        if (outputExtension == PICTURE_SAVE_EXTENSION_JSON)
+            picture->save2File(outputFileName);
+        else
+            picture->export2File(middleGrey, outputFileName, movingAverageSize, false);
+    }
+    catch (const cimg_library::CImgException& e) {
+        delete picture;
+        return fail(EXIT_CODE_OUTPUT_ERROR, "The picture could not be written to " + outputFileName + ". Error: " + e.what());
+    }
+    if (!fileExists(outputFileName)) {
+        delete picture;
+        return fail(EXIT_CODE_OUTPUT_ERROR, "The picture could not be written to " + outputFileName + ".");
+    }
+    double outputTime = getCurrentTimeSeconds() - outputBeginningTime;
+
+    // Summary
+    summary = {
+        {"Status", "Success"},
+        {"ExitCode", EXIT_CODE_SUCCESS},
+        {"Output", outputFileName},
+        {"Width", picture->getWidth()},
+        {"Height", picture->getHeight()},
+        {"SamplesPerPixel", scene.getSamplesPerPixel()},
+        {"NumberThreads", scene.getNumberThreads()},
+        {"NumberObjects", scene.getObjects().size()},
+        {"NumberLamps", scene.getLamps().size()},
+        {"Rays", scene.getRayCounters()},
+        {"KDTree", {
+            {"MaxDepth", scene.getKDTreeMaxDepth()},
+            {"MaxObjectNumber", scene.getKDTreeMaxObjectNumber()},
+            {"BuiltNodes", scene.getKDTreeBuiltNodes()},
+            {"UnbuiltNodes", scene.getKDTreeUnbuiltNodes()}
+            }
+        },
+        {"SBVH", {
+            {"DuplicatedReferences", scene.getSBVHDuplicatedReferences()},
+            {"SAHCost", scene.getSBVHSAHCost()}
+            }
+        },
+        {"Times", {
+            {"Loading", loadingTime},
+            {"KDTreeCreation", scene.getKDTreeCreationTime()},
+            {"SBVHCreation", scene.getSBVHCreationTime()},
+            {"Render", picture->getRenderTime()},
+            {"RenderCall", renderCallTime},  // Includes backups and the k-d tree or SBVH creation
+            {"Output", outputTime},
+            {"Total", getCurrentTimeSeconds() - beginningTime}
+            }
+        }
+    };
+    std::cout << summary.dump() << std::endl;
+
+    delete picture;
+    return EXIT_CODE_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#ifndef DEF_COMMANDLINE
+#define DEF_COMMANDLINE
+
+#include "Benchmark.h"
+#include "Scene.h"
+
+/*!
+    \file CommandLine.h
+    \brief Defines the non-interactive mode of the program.
+    \details When arguments are given to the program, it does not start the interface. It loads the given files, renders the picture, writes it and exits. A summary is printed as a single line of json on the standard output, so that batch jobs can parse it. Errors and warnings are printed on the standard error.
+
+    \var constexpr int EXIT_CODE_SUCCESS
+    \brief Exit code when the picture was rendered and written.
+
+    \var constexpr int EXIT_CODE_INVALID_ARGUMENTS
+    \brief Exit code when the arguments could not be understood.
+
+    \var constexpr int EXIT_CODE_INVALID_INPUT_FILE
+    \brief Exit code when a parameters or object groups file does not exist or is corrupted.
+
+    \var constexpr int EXIT_CODE_OUTPUT_ERROR
+    \brief Exit code when the picture could not be written.
+
+    \fn void printCommandLineUsage(std::ostream& stream)
+    \brief Prints the available arguments.
+    \param stream The stream on which the usage will be printed.
+
+    \fn bool loadJsonFile(std::string fileName, json& j, std::string& error)
+    \brief Loads a json file.
+    \param fileName The path to the file.
+    \param j The json that will be filled.
+    \param error Filled with a description of the problem if the file could not be loaded.
+    \return True if the file was loaded, false else.
+
+    \fn int renderFromCommandLine(int argc, char* argv[])
+    \brief Renders a scene without any interaction.
+    \details The parameters are loaded from the --parameters file (default ones else), the object groups from every --objects file (the default scene if there is none). Then, the overrides are applied and the picture is rendered and written to the --output file. If its extension is PICTURE_SAVE_EXTENSION_JSON, the radiance is saved, else it is exported with the CImg library. If --benchmark is given, the benchmark is run instead and its results are written to that file and printed on the standard output.
+    \param argc The number of arguments, as given to main().
+    \param argv The arguments, as given to main().
+    \return The exit code of the program.
+    \sa printCommandLineUsage(), Scene::render(), Picture::export2File(), Picture::save2File(), runBenchmark()
+*/
+
+constexpr int EXIT_CODE_SUCCESS = 0;
+constexpr int EXIT_CODE_INVALID_ARGUMENTS = 1;
+constexpr int EXIT_CODE_INVALID_INPUT_FILE = 2;
+constexpr int EXIT_CODE_OUTPUT_ERROR = 3;
+
+void printCommandLineUsage(std::ostream& stream);
+bool loadJsonFile(std::string fileName, json& j, std::string& error);
+int renderFromCommandLine(int argc, char* argv[]);
+
+#endif
@@ -18,24 +18,25 @@ Material* DiffuseMaterial::deepCopy() const {
     return new DiffuseMaterial(albedo, getEmittance());
 }
 
+Material* DiffuseMaterial::deepCopy(MemoryArena& arena) const {
+    return new (arena) DiffuseMaterial(albedo, getEmittance());
+}
+
 DoubleUnitVec3D DiffuseMaterial::getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) const {
-    DoubleUnitVec3D newDirection(randomVectorOnUnitRadiusSphere());
-    if (dotProd(newDirection, normal) < 0) // Wrong hemisphere
-        return -newDirection;
-    return newDirection;
+    return randomCosineWeightedVectorOnHemisphere(normal);
 }
 
 DoubleVec3D DiffuseMaterial::computeCurrentRadiance(const DoubleVec3D& recursiveRadiance, double cosAngleNewDirectionNormal, bool nextEventEstimation /*= false*/) const {
-    DoubleVec3D albedo = getAlbedo();
+    DoubleVec3D reflectedRadiance = elementwiseProd(recursiveRadiance, albedo);
 
-    double neeFactor = 2.0;
-    if (nextEventEstimation)
-        neeFactor = 1.0 / M_PI;
+    // The BRDF is albedo/pi. Directions given by getNewDirection() have a pdf of cos/pi, which cancels out with the BRDF and the cosine
+    if (!nextEventEstimation)
+        return reflectedRadiance;
+    return reflectedRadiance * cosAngleNewDirectionNormal / M_PI;
+}
 
-    return DoubleVec3D(recursiveRadiance.getX()*albedo.getX(),
-                       recursiveRadiance.getY()*albedo.getY(),
-                       recursiveRadiance.getZ()*albedo.getZ())
-                       * cosAngleNewDirectionNormal * neeFactor;
+double DiffuseMaterial::getDirectionPdf(const Ray&, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection) const {
+    return std::max(0.0, dotProd(newDirection, normal)) / M_PI;
 }
 
 bool DiffuseMaterial::worksWithNextEventEstimation() const {
@@ -33,19 +33,34 @@
     \brief Makes a deep copy of this material.
     \return A pointer to a deeply copied version of this material.
 
+    \fn Material* DiffuseMaterial::deepCopy(MemoryArena& arena)
+    \brief Makes a deep copy of this material in an arena.
+    \param arena The arena in which the copy will be allocated.
+    \return A pointer to a deeply copied version of this material.
+
     \fn DoubleUnitVec3D DiffuseMaterial::getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal)
     \brief Computes the new ray direction.
+    \details The direction is importance sampled according to the cosine with the normal.
     \param previousRay The ray that hits this material.
     \param normal The normal at the intersection.
     \return The new ray direction.
+    \sa randomCosineWeightedVectorOnHemisphere()
 
     \fn DoubleVec3D DiffuseMaterial::computeCurrentRadiance(const DoubleVec3D& recursiveRadiance, double cosAngleNewDirectionNormal, bool nextEventEstimation = false)
     \brief Computes the new radiance.
+    \details Without next event estimation, the direction comes from getNewDirection(), so the cosine and the BRDF are cancelled by the pdf and only the albedo remains.
     \param recursiveRadiance The radiance recursively obtained.
     \param cosAngleNewDirectionNormal The cosine of the angle between the direction of the next ray and the normal at the intersection.
     \param nextEventEstimation Whether the radiance is obtained using the next event estimation algorithm.
     \return The new radiance.
 
+    \fn double DiffuseMaterial::getDirectionPdf(const Ray& previousRay, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection)
+    \brief Computes the probability density with which getNewDirection() returns a direction.
+    \param previousRay The ray that hits this material.
+    \param normal The normal at the intersection.
+    \param newDirection The direction of the next ray.
+    \return The cosine between the direction and the normal, divided by pi.
+
     \fn bool DiffuseMaterial::worksWithNextEventEstimation()
     \brief Returns whether this material works with next event estimation.
     \return True.
@@ -72,7 +87,7 @@
 */
 
 
-class DiffuseMaterial : public Material {
+class DiffuseMaterial final : public Material {
 private:
     DoubleVec3D albedo;
 
@@ -84,9 +99,11 @@ public:
     void setAlbedo(const DoubleVec3D& albedo);
 
     Material* deepCopy() const;
+    Material* deepCopy(MemoryArena& arena) const;
 
     DoubleUnitVec3D getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) const;
     DoubleVec3D computeCurrentRadiance(const DoubleVec3D& recursiveRadiance, double cosAngleNewDirectionNormal, bool nextEventEstimation = false) const;
+    double getDirectionPdf(const Ray& previousRay, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection) const;
     bool worksWithNextEventEstimation() const;
 
     std::ostream& getDescription(std::ostream& stream) const;
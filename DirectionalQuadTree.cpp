@@ -0,0 +1,189 @@
+#include "DirectionalQuadTree.h"
+
+// Constructors
+DirectionalQuadTree::DirectionalQuadTree()
+    : samplingNodes(1), recordingNodes(1), recordedSums(4), numberSamples(0) {
+    for (std::atomic<double>& sum : recordedSums)
+        sum.store(0.0);
+}
+
+DirectionalQuadTree::DirectionalQuadTree(const DirectionalQuadTree& tree)
+    : samplingNodes(tree.samplingNodes), samplingTotal(tree.samplingTotal), recordingNodes(tree.recordingNodes), recordedSums(tree.recordedSums.size()), numberSamples(tree.numberSamples.load()) {
+    for (unsigned int i = 0; i < recordedSums.size(); i++)
+        recordedSums[i].store(tree.recordedSums[i].load());
+}
+
+
+// Getters and setters
+unsigned long long DirectionalQuadTree::getNumberSamples() const { return numberSamples.load(); }
+void DirectionalQuadTree::setNumberSamples(unsigned long long numberSamples) { this->numberSamples.store(numberSamples); }
+
+
+// Private method
+unsigned int DirectionalQuadTree::getQuadrant(double& x, double& y) const {
+    unsigned int quadrant = 0;
+    x *= 2.0;
+    y *= 2.0;
+    if (x >= 1.0) {
+        quadrant |= 1;
+        x -= 1.0;
+    }
+    if (y >= 1.0) {
+        quadrant |= 2;
+        y -= 1.0;
+    }
+    return quadrant;
+}
+
+
+// Sampling and learning
+void DirectionalQuadTree::record(const DoubleUnitVec3D& direction, double radiance) {
+    if (!(radiance > 0.0) || radiance == INFINITY)  // Also rejects NaN
+        return;
+
+    double x, y;
+    direction2Square(direction, x, y);
+    unsigned int node = 0;
+    while (true) {
+        unsigned int quadrant = getQuadrant(x, y);
+        unsigned int child = recordingNodes[node].children[quadrant];
+        if (child == 0) {
+            atomicAdd(recordedSums[4*node + quadrant], radiance);
+            break;
+        }
+        node = child;
+    }
+    numberSamples++;
+}
+
+double DirectionalQuadTree::getPdf(const DoubleUnitVec3D& direction) const {
+    if (samplingTotal <= 0.0)
+        return 1.0 / (4.0*M_PI);
+
+    double x, y;
+    direction2Square(direction, x, y);
+    double pdf = 1.0;
+    unsigned int node = 0;
+    while (true) {
+        const Node& currentNode = samplingNodes[node];
+        unsigned int quadrant = getQuadrant(x, y);
+        double total = currentNode.sums[0] + currentNode.sums[1] + currentNode.sums[2] + currentNode.sums[3];
+        if (total <= 0.0)
+            return 0.0;
+        pdf *= 4.0 * currentNode.sums[quadrant] / total;  // A quadrant has a quarter of the area of its node
+
+        if (currentNode.children[quadrant] == 0)
+            break;
+        node = currentNode.children[quadrant];
+    }
+    return pdf / (4.0*M_PI);  // The mapping preserves the areas
+}
+
+DoubleUnitVec3D DirectionalQuadTree::sample() const {
+    if (samplingTotal <= 0.0)
+        return randomVectorOnUnitRadiusSphere();
+
+    double originX = 0.0;
+    double originY = 0.0;
+    double size = 1.0;
+    unsigned int node = 0;
+    while (true) {
+        const Node& currentNode = samplingNodes[node];
+        double total = currentNode.sums[0] + currentNode.sums[1] + currentNode.sums[2] + currentNode.sums[3];
+        double random = randomDouble() * total;
+        unsigned int quadrant = 0;
+        while (quadrant < 3 && random >= currentNode.sums[quadrant]) {
+            random -= currentNode.sums[quadrant];
+            quadrant++;
+        }
+
+        size /= 2.0;
+        originX += (quadrant & 1) * size;
+        originY += (quadrant >> 1) * size;
+        if (currentNode.children[quadrant] == 0)
+            break;
+        node = currentNode.children[quadrant];
+    }
+    return square2Direction(originX + randomDouble()*size, originY + randomDouble()*size);
+}
+
+void DirectionalQuadTree::learn() {
+    // The recorded energy becomes the sampling distribution. Children are always after their parent, so the sums go up the tree in a single loop
+    samplingNodes = recordingNodes;
+    for (int node = samplingNodes.size() - 1; node >= 0; node--) {  // node must be signed
+        for (unsigned int quadrant = 0; quadrant < 4; quadrant++) {
+            unsigned int child = samplingNodes[node].children[quadrant];
+            if (child == 0)
+                samplingNodes[node].sums[quadrant] = recordedSums[4*node + quadrant].load();
+            else {
+                const Node& childNode = samplingNodes[child];
+                samplingNodes[node].sums[quadrant] = childNode.sums[0] + childNode.sums[1] + childNode.sums[2] + childNode.sums[3];
+            }
+        }
+    }
+    const Node& root = samplingNodes[0];
+    samplingTotal = root.sums[0] + root.sums[1] + root.sums[2] + root.sums[3];
+
+    // The new recording quadtree is refined where the energy is
+    if (samplingTotal > 0.0) {
+        struct NodeToRefine {
+            unsigned int newNode;
+            int samplingNode;  // -1 if the sampling tree is not subdivided this deep
+            double fraction;
+            unsigned int depth;
+        };
+
+        std::vector<Node> newNodes(1);
+        std::vector<NodeToRefine> stack = { { 0, 0, 1.0, 0 } };
+        while (!stack.empty()) {
+            NodeToRefine current = stack.back();
+            stack.pop_back();
+            for (unsigned int quadrant = 0; quadrant < 4; quadrant++) {
+                double fraction = current.fraction / 4.0;  // The energy is assumed uniform where nothing is known
+                int samplingChild = -1;
+                if (current.samplingNode != -1) {
+                    fraction = samplingNodes[current.samplingNode].sums[quadrant] / samplingTotal;
+                    unsigned int child = samplingNodes[current.samplingNode].children[quadrant];
+                    if (child != 0)
+                        samplingChild = child;
+                }
+
+                if (fraction > DIRECTIONAL_QUAD_TREE_SUBDIVISION_THRESHOLD && current.depth < DIRECTIONAL_QUAD_TREE_MAX_DEPTH) {
+                    unsigned int newChild = newNodes.size();
+                    newNodes.push_back(Node());
+                    newNodes[current.newNode].children[quadrant] = newChild;
+                    stack.push_back({ newChild, samplingChild, fraction, current.depth + 1 });
+                }
+            }
+        }
+        recordingNodes = newNodes;
+    }
+
+    recordedSums = std::vector<std::atomic<double>>(4 * recordingNodes.size());
+    for (std::atomic<double>& sum : recordedSums)
+        sum.store(0.0);
+    numberSamples.store(0);
+}
+
+
+// Other functions
+void direction2Square(const DoubleUnitVec3D& direction, double& x, double& y) {
+    x = std::min(std::max((direction.getZ() + 1.0) / 2.0, 0.0), 0.9999999999);
+    y = std::atan2(direction.getY(), direction.getX()) / (2.0*M_PI);
+    if (y < 0.0)
+        y += 1.0;
+    y = std::min(y, 0.9999999999);
+}
+
+DoubleUnitVec3D square2Direction(double x, double y) {
+    double cosTheta = 2.0*x - 1.0;
+    double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta*cosTheta));
+    double phi = 2.0*M_PI*y;
+    return DoubleUnitVec3D(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta, true);
+}
+
+void atomicAdd(std::atomic<double>& value, double addend) {
+    // std::atomic<double> has no fetch_add before C++20
+    double current = value.load();
+    while (!value.compare_exchange_weak(current, current + addend));
+}
@@ -0,0 +1,135 @@
+#ifndef DEF_DIRECTIONALQUADTREE
+#define DEF_DIRECTIONALQUADTREE
+
+#include <atomic>
+#include <vector>
+
+#include "DoubleUnitVec3D.h"
+#include "InterfaceGestion.h"
+
+/*!
+    \file DirectionalQuadTree.h
+    \brief Defines the DirectionalQuadTree class and some functions around it.
+
+    \var constexpr double DIRECTIONAL_QUAD_TREE_SUBDIVISION_THRESHOLD
+    \brief Fraction of the total energy above which a cell of the quadtree is subdivided.
+
+    \var constexpr unsigned int DIRECTIONAL_QUAD_TREE_MAX_DEPTH
+    \brief Maximum depth of the quadtree.
+
+    \class DirectionalQuadTree
+    \brief Learns the distribution of the radiance arriving at a region of the scene, and samples directions from it.
+    \details The directions are mapped to the unit square with the cylindrical mapping (cos(theta), phi), which preserves the areas. This square is subdivided by a quadtree, whose cells store the energy arriving from their directions. This is the directional part of the SD-tree of Mueller et al.
+    The tree has two versions. The sampling one was learned during the previous pass and is only read during a pass. The recording one receives the samples of the current pass from all threads, with atomic additions. Between two passes, DirectionalQuadTree::learn() turns the recording version into the sampling one.
+
+    \struct DirectionalQuadTree::Node
+    \brief A node of the quadtree.
+
+    \var unsigned int DirectionalQuadTree::Node::children
+    \brief The indexes of the children of the four quadrants of the node, 0 if the quadrant is a leaf. The root is the node 0, so it cannot be a child.
+
+    \var double DirectionalQuadTree::Node::sums
+    \brief The energy arriving from each quadrant of the node.
+
+    \fn DirectionalQuadTree::DirectionalQuadTree()
+    \brief Default constructor.
+    \details The tree has a single node, and samples directions uniformly until it learned something.
+
+    \fn DirectionalQuadTree::DirectionalQuadTree(const DirectionalQuadTree& tree)
+    \brief Copy constructor.
+    \param tree The tree that will be copied, including what it is recording.
+
+    \fn unsigned long long DirectionalQuadTree::getNumberSamples()
+    \brief Getter for the number of samples.
+    \return The number of samples recorded during the current pass.
+
+    \fn void DirectionalQuadTree::setNumberSamples(unsigned long long numberSamples)
+    \brief Setter for the number of samples.
+    \param numberSamples The new number of samples recorded during the current pass.
+
+    \fn void DirectionalQuadTree::record(const DoubleUnitVec3D& direction, double radiance)
+    \brief Adds a sample of the radiance arriving from a direction. Can be called by several threads at the same time.
+    \param direction The direction from which the radiance arrives.
+    \param radiance The radiance, possibly weighted by a cosine, divided by the probability density with which the direction was sampled.
+
+    \fn double DirectionalQuadTree::getPdf(const DoubleUnitVec3D& direction)
+    \brief Computes the probability density with which DirectionalQuadTree::sample() gives a direction.
+    \param direction The direction.
+    \return The probability density, in solid angle.
+
+    \fn DoubleUnitVec3D DirectionalQuadTree::sample()
+    \brief Samples a direction proportionally to the radiance learned during the previous pass.
+    \return The direction.
+    \sa DirectionalQuadTree::getPdf()
+
+    \fn void DirectionalQuadTree::learn()
+    \brief Turns the samples recorded during the pass into the sampling distribution, and prepares the recording of the next pass.
+    \details The cells of the new recording quadtree are subdivided where more than DIRECTIONAL_QUAD_TREE_SUBDIVISION_THRESHOLD of the energy arrived, and merged elsewhere.
+    \warning Must not be called while a render is running.
+
+    \fn unsigned int DirectionalQuadTree::getQuadrant(double& x, double& y)
+    \brief Finds the quadrant of a point of the unit square, and moves the point to the coordinates of this quadrant.
+    \param x The *x* coordinate of the point. Replaced by its coordinate in the quadrant.
+    \param y The *y* coordinate of the point. Replaced by its coordinate in the quadrant.
+    \return The index of the quadrant, between 0 and 3.
+
+    \fn void direction2Square(const DoubleUnitVec3D& direction, double& x, double& y)
+    \brief Maps a direction to the unit square, preserving the areas.
+    \param direction The direction.
+    \param x Filled with the *x* coordinate, from cos(theta).
+    \param y Filled with the *y* coordinate, from phi.
+    \sa square2Direction()
+
+    \fn DoubleUnitVec3D square2Direction(double x, double y)
+    \brief Maps a point of the unit square to a direction, preserving the areas.
+    \param x The *x* coordinate of the point.
+    \param y The *y* coordinate of the point.
+    \return The direction.
+    \sa direction2Square()
+
+    \fn void atomicAdd(std::atomic<double>& value, double addend)
+    \brief Adds a number to a double that can be modified by several threads at the same time.
+    \param value The double that will be modified.
+    \param addend The number that will be added.
+*/
+
+constexpr double DIRECTIONAL_QUAD_TREE_SUBDIVISION_THRESHOLD = 0.01;
+constexpr unsigned int DIRECTIONAL_QUAD_TREE_MAX_DEPTH = 20;
+
+class DirectionalQuadTree {
+public:
+    struct Node {
+        unsigned int children[4] = { 0, 0, 0, 0 };
+        double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+    };
+
+private:
+    std::vector<Node> samplingNodes;
+    double samplingTotal = 0.0;
+
+    std::vector<Node> recordingNodes;
+    std::vector<std::atomic<double>> recordedSums;  // Four per recording node, only used by the leaves
+    std::atomic<unsigned long long> numberSamples;
+
+    unsigned int getQuadrant(double& x, double& y) const;
+
+public:
+    DirectionalQuadTree();
+    DirectionalQuadTree(const DirectionalQuadTree& tree);
+
+    unsigned long long getNumberSamples() const;
+    void setNumberSamples(unsigned long long numberSamples);
+
+    void record(const DoubleUnitVec3D& direction, double radiance);
+    double getPdf(const DoubleUnitVec3D& direction) const;
+    DoubleUnitVec3D sample() const;
+    void learn();
+
+    DirectionalQuadTree& operator=(const DirectionalQuadTree& tree) = delete;
+};
+
+void direction2Square(const DoubleUnitVec3D& direction, double& x, double& y);
+DoubleUnitVec3D square2Direction(double x, double y);
+void atomicAdd(std::atomic<double>& value, double addend);
+
+#endif
@@ -54,3 +54,25 @@ DoubleUnitVec3D randomVectorOnUnitRadiusSphere() {
                            newRadius*sin(angle),
                            z, true);  // Already normalised
 }
+
+void buildOrthonormalBasis(const DoubleUnitVec3D& normal, DoubleUnitVec3D& tangent, DoubleUnitVec3D& bitangent) {
+    // Using "Building an Orthonormal Basis, Revisited" (Duff et al., 2017)
+    double sign = std::copysign(1.0, normal.getZ());
+    double a = -1.0 / (sign + normal.getZ());
+    double b = normal.getX()*normal.getY()*a;
+    tangent = DoubleUnitVec3D(1.0 + sign*normal.getX()*normal.getX()*a, sign*b, -sign*normal.getX(), true);
+    bitangent = DoubleUnitVec3D(b, sign + normal.getY()*normal.getY()*a, -normal.getY(), true);
+}
+
+DoubleUnitVec3D randomCosineWeightedVectorOnHemisphere(const DoubleUnitVec3D& normal) {
+    // Malley's method: a uniform point on the unit disk, projected on the hemisphere
+    double radius = sqrt(randomDouble());
+    double angle = 2*M_PI*randomDouble();
+    double x = radius*cos(angle);
+    double y = radius*sin(angle);
+    double z = sqrt(std::max(0.0, 1 - x*x - y*y));
+
+    DoubleUnitVec3D tangent, bitangent;
+    buildOrthonormalBasis(normal, tangent, bitangent);
+    return DoubleUnitVec3D(tangent*x + bitangent*y + normal*z, true);  // Already normalised
+}
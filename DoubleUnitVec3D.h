@@ -55,7 +55,21 @@
     \brief Generates a random unit vector on a sphere.
     \details Every vector has the same probability to show up. We can combine this function with a dot product between the resulting vector and a normal to a surface. If we inverse the vector when the dot product is negative, then we get a random vector on a unit hemisphere.
     \return A random unit vector on a sphere.
-    \sa Sphere::getRandomPoint()
+    \sa Sphere::getRandomPoint(), randomCosineWeightedVectorOnHemisphere()
+
+    \fn void buildOrthonormalBasis(const DoubleUnitVec3D& normal, DoubleUnitVec3D& tangent, DoubleUnitVec3D& bitangent)
+    \brief Builds two unit vectors that make an orthonormal basis with a given one.
+    \details Uses the branchless method of Duff et al. (2017), which is stable for every normal, even close to the z-axis.
+    \param normal The third vector of the basis.
+    \param tangent Set to the first vector of the basis.
+    \param bitangent Set to the second vector of the basis.
+
+    \fn DoubleUnitVec3D randomCosineWeightedVectorOnHemisphere(const DoubleUnitVec3D& normal)
+    \brief Generates a random unit vector on a hemisphere, with a probability proportional to its cosine with the normal.
+    \details Uniformly samples a point on the unit disk, and projects it up on the hemisphere (Malley's method). The probability density of a direction is cos(angle)/pi.
+    \param normal The normal that gives the hemisphere.
+    \return A random unit vector on the hemisphere.
+    \sa buildOrthonormalBasis(), DiffuseMaterial::getNewDirection()
 */
 
 class DoubleUnitVec3D : public DoubleVec3D {
@@ -71,5 +85,7 @@ public:
 
 DoubleUnitVec3D operator-(const DoubleUnitVec3D& vec);
 DoubleUnitVec3D randomVectorOnUnitRadiusSphere();
+void buildOrthonormalBasis(const DoubleUnitVec3D& normal, DoubleUnitVec3D& tangent, DoubleUnitVec3D& bitangent);
+DoubleUnitVec3D randomCosineWeightedVectorOnHemisphere(const DoubleUnitVec3D& normal);
 
 #endif
@@ -133,6 +133,10 @@ double dotProd(const DoubleVec3D& vec1, const DoubleVec3D& vec2) {
     return vec1.getX()*vec2.getX() + vec1.getY()*vec2.getY() + vec1.getZ()*vec2.getZ();
 }
 
+DoubleVec3D elementwiseProd(const DoubleVec3D& vec1, const DoubleVec3D& vec2) {
+    return DoubleVec3D(vec1.getX()*vec2.getX(), vec1.getY()*vec2.getY(), vec1.getZ()*vec2.getZ());
+}
+
 double length(const DoubleVec3D& vec) { return sqrt(dotProd(vec, vec)); }
 
 
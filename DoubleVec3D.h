@@ -168,6 +168,13 @@
     \return The dot product between vec1 and vec2.
     \sa length()
 
+    \fn DoubleVec3D elementwiseProd(const DoubleVec3D& vec1, const DoubleVec3D& vec2)
+    \brief Elementwise product.
+    \details Multiplies each coordinate of vec1 by the same coordinate of vec2. This is how colours are multiplied, for example a radiance by an albedo.
+    \param vec1 The first vector for the product.
+    \param vec2 The second vector for the product.
+    \return The vector (vec1.x*vec2.x, vec1.y*vec2.y, vec1.z*vec2.z).
+
     \fn double length(const DoubleVec3D& vec)
     \brief Gives the norm of the vector.
     \details Uses the dotProd() method.
@@ -230,6 +237,7 @@ std::ostream& operator<<(std::ostream& stream, const DoubleVec3D& vec);
 
 DoubleVec3D crossProd(const DoubleVec3D& vec1, const DoubleVec3D& vec2);
 double dotProd(const DoubleVec3D& vec1, const DoubleVec3D& vec2);
+DoubleVec3D elementwiseProd(const DoubleVec3D& vec1, const DoubleVec3D& vec2);
 double length(const DoubleVec3D& vec);
 
 void to_json(json& j, const DoubleVec3D& vec);
@@ -0,0 +1,40 @@
+#include "HaltonSampler.h"
+
+const unsigned int HaltonSampler::primes[HALTON_NUMBER_PRIMES] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+    59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131,
+    137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+    227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311
+};
+
+// Constructor
+HaltonSampler::HaltonSampler(unsigned int samplesPerPixel, unsigned int seed)
+    : Sampler(samplesPerPixel, seed) {}
+
+
+// Virtual methods
+double HaltonSampler::computeDouble(unsigned int dimension) {
+    unsigned int haltonDimension = currentGroup*SAMPLER_DIMENSIONS_PER_GROUP + dimension;
+    if (haltonDimension >= HALTON_NUMBER_PRIMES)
+        return getIndependentDouble();
+
+    double offset = unsignedInt2Double(hashCombine(pixelSeed, hashUnsignedInt(haltonDimension)));
+    double result = radicalInverse(primes[haltonDimension], sampleIndex) + offset;
+    return result < 1.0 ? result : result - 1.0;
+}
+
+std::string HaltonSampler::getType() const { return "Halton"; }
+
+
+// Other function
+double radicalInverse(unsigned int base, unsigned int index) {
+    double inverseBase = 1.0 / base;
+    double digitWeight = inverseBase;
+    double result = 0.0;
+    while (index > 0) {
+        result += (index % base) * digitWeight;
+        index /= base;
+        digitWeight *= inverseBase;
+    }
+    return result;
+}
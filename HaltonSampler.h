@@ -0,0 +1,55 @@
+#ifndef DEF_HALTONSAMPLER
+#define DEF_HALTONSAMPLER
+
+#include "Sampler.h"
+
+/*!
+    \file HaltonSampler.h
+    \brief Defines the HaltonSampler class.
+
+    \var constexpr unsigned int HALTON_NUMBER_PRIMES
+    \brief Number of dimensions of the Halton sequence. The following dimensions get independent random numbers, since the Halton sequence is badly distributed with large prime bases.
+
+    \class HaltonSampler
+    \brief Sampler using the Halton sequence.
+    \details Every pixel uses the beginning of the sequence, rotated by a random offset (Cranley-Patterson rotation) which depends on the pixel and on the dimension.
+
+    \fn HaltonSampler::HaltonSampler(unsigned int samplesPerPixel, unsigned int seed)
+    \brief Main constructor.
+    \param samplesPerPixel The number of samples per pixel of the render.
+    \param seed The seed of the render.
+
+    \fn std::string HaltonSampler::getType()
+    \brief Returns "Halton".
+    \return "Halton".
+
+    \fn double HaltonSampler::computeDouble(unsigned int dimension)
+    \brief Computes the number of a dimension of the current group.
+    \param dimension The dimension in the current group.
+    \return The rotated point of the Halton sequence.
+
+    \fn double radicalInverse(unsigned int base, unsigned int index)
+    \brief Mirrors the digits of an index around the decimal point.
+    \param base The base in which the digits are written.
+    \param index The index that will be mirrored.
+    \return The radical inverse of index, between 0 and 1.
+*/
+
+constexpr unsigned int HALTON_NUMBER_PRIMES = 64;
+
+class HaltonSampler : public Sampler {
+private:
+    static const unsigned int primes[HALTON_NUMBER_PRIMES];
+
+protected:
+    double computeDouble(unsigned int dimension);
+
+public:
+    HaltonSampler(unsigned int samplesPerPixel, unsigned int seed);
+
+    std::string getType() const;
+};
+
+double radicalInverse(unsigned int base, unsigned int index);
+
+#endif
@@ -0,0 +1,13 @@
+#include "IndependentSampler.h"
+
+// Constructor
+IndependentSampler::IndependentSampler(unsigned int samplesPerPixel, unsigned int seed)
+    : Sampler(samplesPerPixel, seed) {}
+
+
+// Virtual methods
+double IndependentSampler::computeDouble(unsigned int) {
+    return getIndependentDouble();
+}
+
+std::string IndependentSampler::getType() const { return "Independent"; }
@@ -0,0 +1,39 @@
+#ifndef DEF_INDEPENDENTSAMPLER
+#define DEF_INDEPENDENTSAMPLER
+
+#include "Sampler.h"
+
+/*!
+    \file IndependentSampler.h
+    \brief Defines the IndependentSampler class.
+
+    \class IndependentSampler
+    \brief Sampler giving independent uniform random numbers.
+    \details This is what was used before the other samplers existed. It is the reference to which they can be compared.
+
+    \fn IndependentSampler::IndependentSampler(unsigned int samplesPerPixel, unsigned int seed)
+    \brief Main constructor.
+    \param samplesPerPixel The number of samples per pixel of the render.
+    \param seed The seed of the render.
+
+    \fn std::string IndependentSampler::getType()
+    \brief Returns "Independent".
+    \return "Independent".
+
+    \fn double IndependentSampler::computeDouble(unsigned int dimension)
+    \brief Computes the number of a dimension of the current group.
+    \param dimension The dimension in the current group.
+    \return A random double between 0 and 1.
+*/
+
+class IndependentSampler : public Sampler {
+protected:
+    double computeDouble(unsigned int dimension);
+
+public:
+    IndependentSampler(unsigned int samplesPerPixel, unsigned int seed);
+
+    std::string getType() const;
+};
+
+#endif
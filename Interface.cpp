@@ -132,31 +132,7 @@ void executeParametersCommands(char command) {
             file >> jsonInput;
             file.close();
 
-            json jsonCamera = jsonInput["Camera"];
-            camera.setNumberPixelsX(jsonCamera["NumberPixelsX"].get<unsigned int>());
-            camera.setNumberPixelsY(jsonCamera["NumberPixelsY"].get<unsigned int>());
-            camera.setOrigin(jsonCamera["Origin"].get<DoubleVec3D>());
-            camera.setFocal(jsonCamera["Focal"].get<DoubleVec3D>());
-
-            json jsonBasicParameters = jsonInput["BasicParameters"];
-            scene.setSamplesPerPixel(jsonBasicParameters["SamplesPerPixel"].get<unsigned int>());
-            scene.setMinBounces(jsonBasicParameters["MinBounces"].get<unsigned int>());
-
-            json jsonOptimisationParameters = jsonInput["OptimisationParameters"];
-            scene.setNumberThreads(jsonOptimisationParameters["NumberThreads"].get<unsigned int>());
-            scene.setRussianRoulette(jsonOptimisationParameters["RussianRoulette"].get<bool>());
-            scene.setRrStopProbability(jsonOptimisationParameters["RrStopProbability"].get<double>());
-            scene.setNextEventEstimation(jsonOptimisationParameters["NextEventEstimation"].get<bool>());
-            scene.setKDTree(jsonOptimisationParameters["KDTree"].get<bool>());
-            scene.setKDMaxDepth(jsonOptimisationParameters["KDMaxDepth"].get<unsigned int>());
-            scene.setKDMaxObjectNumber(jsonOptimisationParameters["KDMaxObjectNumber"].get<unsigned int>());
-
-            json jsonBackupParameters = jsonInput["BackupParameters"];
-            scene.setBackupFileName(jsonBackupParameters["BackupFileName"].get<std::string>());
-            scene.setBackupParameters(jsonBackupParameters["BackupParameters"].get<bool>());
-            scene.setBackupObjectGroups(jsonBackupParameters["BackupObjectGroups"].get<bool>());
-            scene.setBackupPicture(jsonBackupParameters["BackupPicture"].get<bool>());
-            scene.setLeastRenderTime4PictureBackup(jsonBackupParameters["LeastRenderTime4PictureBackup"].get<double>());
+            scene.setParametersFromJson(jsonInput);
 
             std::cout << "\rSuccessfully loaded parameters from " << fileName << " in " << getCurrentTimeSeconds() - beginningTime << " seconds." << std::endl << std::endl;
         }
@@ -173,7 +149,7 @@ void executeParametersCommands(char command) {
         // Modify a parameter
         while (true) {
             int index = getIntFromUser("What is the index of the parameter you want to modify? (-1 = cancel)");
-            if (0 <= index && index <= 17)
+            if (0 <= index && index <= 36)
                 std::cout << std::endl;
             switch (index) {
             case -1: return;
@@ -202,15 +178,53 @@ void executeParametersCommands(char command) {
                     }
                     std::cout << "This number is not between 0 and 1!" << std::endl << std::endl;
                 }
-            case 9: scene.setNextEventEstimation(getBoolFromUser("Will the next event estimation algorithm be used? " + BOOL_INFO)); return;
-            case 10: scene.setKDTree(getBoolFromUser("Will a k-d tree be used? " + BOOL_INFO)); return;
-            case 11: scene.setKDMaxDepth(getUnsignedIntFromUser("What is the new maximum k-d tree depth? " + POSITIVE_INT_INFO)); return;
-            case 12: scene.setKDMaxObjectNumber(getUnsignedIntFromUser("What is the new maximum of objects contained in a k-d tree leaf? " + POSITIVE_INT_INFO)); return;
-            case 13: scene.setBackupFileName(getStringFromUser("What is the new name of the backup files? (every backup will have the same name, but a different file extension)")); return;
-            case 14: scene.setBackupParameters(getBoolFromUser("Will the parameters be backed up before the rendering? " + BOOL_INFO)); return;
-            case 15: scene.setBackupObjectGroups(getBoolFromUser("Will the object groups be backed up before the rendering? " + BOOL_INFO)); return;
-            case 16: scene.setBackupPicture(getBoolFromUser("Will the picture be backed up after the rendering? " + BOOL_INFO)); return;
-            case 17: scene.setLeastRenderTime4PictureBackup(getPositiveDoubleFromUser("The picture will be backed up if the render takes more than how many seconds? " + POSITIVE_DOUBLE_INFO)); return;
+            case 9: scene.setRrThroughputBased(getBoolFromUser("Will the russian roulette stop dark paths sooner than bright ones? " + BOOL_INFO)); return;
+            case 10: scene.setNextEventEstimation(getBoolFromUser("Will the next event estimation algorithm be used? " + BOOL_INFO)); return;
+            case 11: scene.setMultipleImportanceSampling(getBoolFromUser("Will multiple importance sampling be used to weight the lamps hit by chance against the next event estimation? " + BOOL_INFO)); return;
+            case 12:
+                while (true) {
+                    unsigned int sampler = getUnsignedIntFromUser("Which sampler will give the random numbers? (0 = independent, 1 = stratified, 2 = Halton, 3 = Sobol)");
+                    if (sampler <= SAMPLER_SOBOL) {
+                        scene.setSamplerType((SamplerType)sampler);
+                        return;
+                    }
+                    std::cout << "This sampler does not exist!" << std::endl << std::endl;
+                }
+            case 13: scene.setKDTree(getBoolFromUser("Will a k-d tree be used? " + BOOL_INFO)); return;
+            case 14:
+                scene.setKDMaxDepth(getUnsignedIntFromUser("What is the new maximum k-d tree depth? " + POSITIVE_INT_INFO));
+                scene.setKDAutoParameters(false);  // It would else be replaced during the render
+                return;
+            case 15: scene.setKDMaxObjectNumber(getUnsignedIntFromUser("What is the new maximum of objects contained in a k-d tree leaf? " + POSITIVE_INT_INFO)); return;
+            case 16: scene.setKDAutoParameters(getBoolFromUser("Will the maximum k-d tree depth be chosen from the number of objects before the render? " + BOOL_INFO)); return;
+            case 17: scene.setKDCalibration(getBoolFromUser("Will the automatic k-d tree parameters be refined by timing a few paths with several trees? " + BOOL_INFO)); return;
+            case 18: scene.setKDLazyBuild(getBoolFromUser("Will the k-d tree nodes only be split when a ray first enters them? " + BOOL_INFO)); return;
+            case 19: scene.setKDTreeCache(getBoolFromUser("Will the k-d tree be saved to a file, and loaded back when the objects did not change? " + BOOL_INFO)); return;
+            case 20: scene.setSBVH(getBoolFromUser("Will a bounding volume hierarchy with spatial splits be used instead of the k-d tree? " + BOOL_INFO)); return;
+            case 21:
+                while (true) {
+                    double alpha = getPositiveDoubleFromUser("What is the new overlap budget of the SBVH? (positive number between 0 and 1, smaller gives more spatial splits)");
+                    if (alpha >= 0 && alpha <= 1) {
+                        scene.setSBVHAlpha(alpha);
+                        return;
+                    }
+                    std::cout << "This number is not between 0 and 1!" << std::endl << std::endl;
+                }
+            case 22: scene.setRadianceCache(getBoolFromUser("Will a radiance cache be used to interpolate the indirect light on diffuse objects? (biased, but faster) " + BOOL_INFO)); return;
+            case 23: scene.setRadianceCacheErrorThreshold(getPositiveDoubleFromUser("What is the new largest error with which a record of the radiance cache can be used? (smaller is more accurate but slower) " + POSITIVE_DOUBLE_INFO)); return;
+            case 24: scene.setRadianceCacheMaxRecords(getUnsignedIntFromUser("What is the new maximum number of records of the radiance cache? " + POSITIVE_INT_INFO)); return;
+            case 25: scene.setPathGuiding(getBoolFromUser("Will the diffuse bounces be guided towards the light learned during the previous passes? " + BOOL_INFO)); return;
+            case 26: scene.setCausticPhotonMapping(getBoolFromUser("Will caustics on diffuse objects be computed with photons traced from the lamps? (biased, but faster) " + BOOL_INFO)); return;
+            case 27: scene.setCausticPhotons(getUnsignedIntFromUser("What is the new number of caustic photons emitted by the lamps? " + POSITIVE_INT_INFO)); return;
+            case 28: scene.setCausticPhotonRadius(getPositiveDoubleFromUser("What is the new radius around a point in which caustic photons are used? (smaller is sharper but noisier) " + POSITIVE_DOUBLE_INFO)); return;
+            case 29: scene.setBidirectionalPathTracing(getBoolFromUser("Will the render trace paths from the lamps too, and link them to the paths from the camera? " + BOOL_INFO)); return;
+            case 30: scene.setRayPacketSize(getUnsignedIntFromUser("How many primary rays will go through the k-d tree together? (1 to trace them one by one, 4, 8 or 16 else) " + POSITIVE_INT_INFO)); return;
+            case 31: scene.setWavefrontPathTracing(getBoolFromUser("Will the paths be traced in waves, each stage being done for all of them before the next one? " + BOOL_INFO)); return;
+            case 32: scene.setBackupFileName(getStringFromUser("What is the new name of the backup files? (every backup will have the same name, but a different file extension)")); return;
+            case 33: scene.setBackupParameters(getBoolFromUser("Will the parameters be backed up before the rendering? " + BOOL_INFO)); return;
+            case 34: scene.setBackupObjectGroups(getBoolFromUser("Will the object groups be backed up before the rendering? " + BOOL_INFO)); return;
+            case 35: scene.setBackupPicture(getBoolFromUser("Will the picture be backed up after the rendering? " + BOOL_INFO)); return;
+            case 36: scene.setLeastRenderTime4PictureBackup(getPositiveDoubleFromUser("The picture will be backed up if the render takes more than how many seconds? " + POSITIVE_DOUBLE_INFO)); return;
             default: std::cout << "This index is invalid!" << std::endl << std::endl;
             }
         }
@@ -244,8 +258,8 @@ void executeObjectsCommands(char command) {
     switch (command) {
     case 'a': {
         Object3DGroup newGroup = Object3DGroup::create();
-        objectGroups.push_back(newGroup);
-        objectGroups[objectGroups.size() - 1].modify();
+        scene.addObjectGroup(newGroup);
+        scene.modifyObjectGroup(objectGroups.size() - 1);
         return;
     }
     case 'd': {
@@ -264,10 +278,8 @@ void executeObjectsCommands(char command) {
                 if (index >= 0 && index < objectGroups.size()) {
                     std::cout << std::endl;
                     bool confirmation = getBoolFromUser("Do you confirm the deletion of this object group? " + BOOL_INFO);
-                    if (confirmation) {
-                        objectGroups[index].resetAndDeleteObjects();
-                        objectGroups.erase(objectGroups.begin() + index);
-                    }
+                    if (confirmation)
+                        scene.deleteObjectGroup(index);
                     return;
                 }
                 std::cout << "This index is invalid!" << std::endl << std::endl;
@@ -294,14 +306,7 @@ void executeObjectsCommands(char command) {
                         else if (index2 >= 0 && index2 < objectGroups.size()) {
                             std::cout << std::endl;
                             std::string newName = getStringFromUser("What is the name of the merged object group?");
-                            objectGroups[index1].merge(objectGroups[index2]);
-                            Object3DGroup newObject = objectGroups[index1];
-
-                            objectGroups.erase(objectGroups.begin() + std::max(index1, index2));
-                            objectGroups.erase(objectGroups.begin() + std::min(index1, index2));
-
-                            newObject.setName(newName);
-                            objectGroups.push_back(newObject);
+                            scene.mergeObjectGroups(index1, index2, newName);
                             return;
                         }
                         else
@@ -356,9 +361,7 @@ void executeObjectsCommands(char command) {
             file >> jsonInput;
             file.close();
 
-            for (json jsonGroup : jsonInput) {
-                objectGroups.push_back(jsonGroup.get<Object3DGroup>());
-            }
+            scene.addObjectGroupsFromJson(jsonInput);
             std::cout << "\rSuccessfully loaded objects from " << fileName << " in " << getCurrentTimeSeconds() - beginningTime << " seconds." << std::endl << std::endl;
 
         }
@@ -380,7 +383,7 @@ void executeObjectsCommands(char command) {
                     return;
 
                 if (index < objectGroups.size()) {
-                    objectGroups[index].modify();
+                    scene.modifyObjectGroup(index);
                     return;
                 }
                 else {
@@ -16,6 +16,7 @@
 
     \var static std::vector<Object3DGroup>& objectGroups
     \brief A reference to the vector of object groups from the scene.
+    \details It is only read. The groups are changed through the methods of the scene, so that it knows when its objects must be computed again.
     \sa Scene::getObjectGroupsReference()
 
     \var static bool isParametersPage
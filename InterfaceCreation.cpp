@@ -110,23 +110,23 @@ DoubleVec3D getRGBDoubleVec3DFromUser(std::string question /*= ""*/, std::string
 
 
 // Material creation
-Material* createDiffuseMaterial(const DoubleVec3D& emittance) {
+Material* createDiffuseMaterial(const DoubleVec3D& emittance, MemoryArena* arena /*= nullptr*/) {
     DoubleVec3D albedo = getRGBDoubleVec3DFromUser("What is the albedo of this diffuse material? (each component should be between 0 and 1)");
     std::cout << std::endl;
-    return new DiffuseMaterial(albedo, emittance);
+    return newInArenaOrHeap<DiffuseMaterial>(arena, albedo, emittance);
 }
 
-Material* createRefractiveMaterial(const DoubleVec3D& emittance) {
+Material* createRefractiveMaterial(const DoubleVec3D& emittance, MemoryArena* arena /*= nullptr*/) {
     double refractiveIndex = getPositiveDoubleFromUser("What is the refractive index of this material? (1 = no refraction / 1.5 = glass)");
     std::cout << std::endl;
-    return new RefractiveMaterial(refractiveIndex, emittance);
+    return newInArenaOrHeap<RefractiveMaterial>(arena, refractiveIndex, emittance);
 }
 
-Material* createSpecularMaterial(const DoubleVec3D& emittance) {
-    return new SpecularMaterial(emittance);
+Material* createSpecularMaterial(const DoubleVec3D& emittance, MemoryArena* arena /*= nullptr*/) {
+    return newInArenaOrHeap<SpecularMaterial>(arena, emittance);
 }
 
-Material* createMaterial() {
+Material* createMaterial(MemoryArena* arena /*= nullptr*/) {
     while (true) {
         char command = getLowerCaseCharFromUser("Do you want a (d)iffuse material, a (r)efractive material or a (s)pecular material?");
         if (command == 'd' || command == 'r' || command == 's') {
@@ -135,9 +135,9 @@ Material* createMaterial() {
             std::cout << std::endl;
 
             switch (command) {
-            case 'd': return createDiffuseMaterial(emittance);
-            case 'r': return createRefractiveMaterial(emittance);
-            case 's': return createSpecularMaterial(emittance);
+            case 'd': return createDiffuseMaterial(emittance, arena);
+            case 'r': return createRefractiveMaterial(emittance, arena);
+            case 's': return createSpecularMaterial(emittance, arena);
             }
         }
         else
@@ -147,16 +147,16 @@ Material* createMaterial() {
 
 
 // Object creation
-Object3D* createSphere(Material* material) {
+Object3D* createSphere(Material* material, MemoryArena* arena /*= nullptr*/) {
     DoubleVec3D center = getXYZDoubleVec3DFromUser("What is the center of the sphere?");
     std::cout << std::endl;
     double radius = getPositiveDoubleFromUser("What is the radius of the sphere?");
     std::cout << std::endl;
 
-    return new Sphere(center, radius, material);
+    return newInArenaOrHeap<Sphere>(arena, center, radius, material);
 }
 
-Object3D* createTriangle(Material* material) {
+Object3D* createTriangle(Material* material, MemoryArena* arena /*= nullptr*/) {
     DoubleVec3D vertex0 = getXYZDoubleVec3DFromUser("What is the first vertex of the triangle? (Order is important for the normal, give them counterclockwise from where they are visible.)");
     std::cout << std::endl;
     DoubleVec3D vertex1 = getXYZDoubleVec3DFromUser("What is the second vertex of the triangle?");
@@ -164,19 +164,19 @@ Object3D* createTriangle(Material* material) {
     DoubleVec3D vertex2 = getXYZDoubleVec3DFromUser("What is the third vertex of the triangle?");
     std::cout << std::endl;
 
-    return new Triangle(vertex0, vertex1, vertex2, material);
+    return newInArenaOrHeap<Triangle>(arena, vertex0, vertex1, vertex2, material);
 }
 
-Object3D* createObject3D() {
+Object3D* createObject3D(MemoryArena* arena /*= nullptr*/) {
     while (true) {
         char command = getLowerCaseCharFromUser("Do you want a (s)phere or a (t)riangle?");
         if (command == 's' || command == 't') {
             std::cout << std::endl;
-            Material* material = createMaterial();
+            Material* material = createMaterial(arena);
 
             switch (command) {
-            case 's': return createSphere(material);
-            case 't': return createTriangle(material);
+            case 's': return createSphere(material, arena);
+            case 't': return createTriangle(material, arena);
             }
         }
         else
@@ -190,16 +190,16 @@ void to_json(json& j, const Material& mat) {
     j = json{ {"MaterialType", mat.getType()},  {"Emittance", mat.getEmittance()}, {"SpecificParameters", mat.getSpecificParametersJson()} };
 }
 
-Material* importMaterialFromJson(const json& j) {
+Material* importMaterialFromJson(const json& j, MemoryArena* arena /*= nullptr*/) {
     std::string materialType = j["MaterialType"].get<std::string>();
     Material* mat = nullptr;
 
     if (materialType == "Diffuse")
-        mat = new DiffuseMaterial;
+        mat = newInArenaOrHeap<DiffuseMaterial>(arena);
     else if (materialType == "Refractive")
-        mat = new RefractiveMaterial;
+        mat = newInArenaOrHeap<RefractiveMaterial>(arena);
     else if (materialType == "Specular")  // Use obj.getType static?
-        mat = new SpecularMaterial;
+        mat = newInArenaOrHeap<SpecularMaterial>(arena);
 
 
     mat->setEmittance(j["Emittance"].get<DoubleVec3D>());
@@ -212,16 +212,15 @@ void to_json(json& j, const Object3D& obj) {
     j = json{ {"ObjectType", obj.getType()}, {"Material", *(obj.getMaterial())}, {"Location", obj.getLocationJson()} };
 }
 
-Object3D* importObject3DFromJson(const json& j) {
+Object3D* importObject3DFromJson(const json& j, MemoryArena* arena /*= nullptr*/) {
     std::string objectType = j["ObjectType"].get<std::string>();
     Object3D* obj = nullptr;
+    Material* material = importMaterialFromJson(j["Material"], arena);  // Given to the constructor, so that no default material is allocated
 
     if (objectType == "Sphere")
-        obj = new Sphere;
+        obj = newInArenaOrHeap<Sphere>(arena, DoubleVec3D(0.0), 1.0, material);
     else if (objectType == "Triangle")
-        obj = new Triangle;
-
-    obj->setMaterial(importMaterialFromJson(j["Material"]));
+        obj = newInArenaOrHeap<Triangle>(arena, DoubleVec3D(1, 0, 0), DoubleVec3D(0, 1, 0), DoubleVec3D(0, 0, 1), material);
     obj->setLocationJson(j["Location"]);
 
     return obj;
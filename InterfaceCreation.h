@@ -95,45 +95,52 @@
     \return The vector the user gave.
     \sa getPositiveDoubleFromUser()
 
-    \fn Material* createDiffuseMaterial(const DoubleVec3D& emittance)
+    \fn Material* createDiffuseMaterial(const DoubleVec3D& emittance, MemoryArena* arena = nullptr)
     \brief Interactive creation of a DiffuseMaterial.
     \param emittance The emittance of the material.
+    \param arena The arena in which the material will be allocated. If it is nullptr, the material is allocated on the heap.
     \return A pointer to the created diffuse material.
     \sa createRefractiveMaterial(), createSpecularMaterial(), createMaterial()
 
-    \fn Material* createRefractiveMaterial(const DoubleVec3D& emittance)
+    \fn Material* createRefractiveMaterial(const DoubleVec3D& emittance, MemoryArena* arena = nullptr)
     \brief Interactive creation of a RefractiveMaterial.
     \param emittance The emittance of the material.
+    \param arena The arena in which the material will be allocated. If it is nullptr, the material is allocated on the heap.
     \return A pointer to the created refractive material.
     \sa createDiffuseMaterial(), createSpecularMaterial(), createMaterial()
 
-    \fn Material* createSpecularMaterial(const DoubleVec3D& emittance)
+    \fn Material* createSpecularMaterial(const DoubleVec3D& emittance, MemoryArena* arena = nullptr)
     \brief Interactive creation of a SpecularMaterial.
     \param emittance The emittance of the material.
+    \param arena The arena in which the material will be allocated. If it is nullptr, the material is allocated on the heap.
     \return A pointer to the created specular material.
     \sa createDiffuseMaterial(), createRefractiveMaterial(), createMaterial()
 
-    \fn Material* createMaterial()
+    \fn Material* createMaterial(MemoryArena* arena = nullptr)
     \brief Interactive creation of a Material.
     \details Gets the main parameters of a material, and then calls createDiffuseMaterial(), createRefractiveMaterial() or createSpecularMaterial().
+    \param arena The arena in which the material will be allocated. If it is nullptr, the material is allocated on the heap.
     \return A pointer to the created material.
     \sa createDiffuseMaterial(), createRefractiveMaterial(), createSpecularMaterial()
 
-    \fn Object3D* createSphere(Material* material)
+    \fn Object3D* createSphere(Material* material, MemoryArena* arena = nullptr)
     \brief Interactive creation of a Sphere.
     \param material The material of this sphere.
+    \param arena The arena in which the object will be allocated. If it is nullptr, the object is allocated on the heap.
     \return A pointer to the created sphere.
     \sa createTriangle(), createObject3D()
 
-    \fn Object3D* createTriangle(Material* material)
+    \fn Object3D* createTriangle(Material* material, MemoryArena* arena = nullptr)
     \brief Interactive creation of a Triangle.
     \param material The material of this triangle.
+    \param arena The arena in which the object will be allocated. If it is nullptr, the object is allocated on the heap.
     \return A pointer to the created triangle.
     \sa createSphere(), createObject3D()
 
-    \fn Object3D* createObject3D()
+    \fn Object3D* createObject3D(MemoryArena* arena = nullptr)
     \brief Interactive creation of an Object3D.
     \details Gets the main parameters of an object, and then calls createSphere() or createTriangle().
+    \param arena The arena in which the object and its material will be allocated. If it is nullptr, they are allocated on the heap.
     \return A pointer to the created object.
     \sa createSphere(), createTriangle()
 
@@ -143,9 +150,10 @@
     \param mat The material that will be converted.
     \sa importMaterialFromJson()
 
-    \fn Material* importMaterialFromJson(const json& j)
+    \fn Material* importMaterialFromJson(const json& j, MemoryArena* arena = nullptr)
     \brief Material conversion from json
     \param j Json input.
+    \param arena The arena in which the material will be allocated. If it is nullptr, the material is allocated on the heap.
     \return A pointer to the material stored in the json.
     \sa to_json(json& j, const Material& mat)
 
@@ -155,9 +163,11 @@
     \param obj The object that will be converted.
     \sa importObject3DFromJson()
 
-    \fn Object3D* importObject3DFromJson(const json& j)
+    \fn Object3D* importObject3DFromJson(const json& j, MemoryArena* arena = nullptr)
     \brief Object3D conversion from json
+    \details The material is allocated in the same arena as the object.
     \param j Json input.
+    \param arena The arena in which the object will be allocated. If it is nullptr, the object is allocated on the heap.
     \return A pointer to the object stored in the json.
     \sa to_json(json& j, const Object3D& obj)
 */
@@ -176,18 +186,18 @@ bool getBoolFromUser(std::string question = "", std::string prompt = PROMPT);
 DoubleVec3D getXYZDoubleVec3DFromUser(std::string question = "", std::string prompt = PROMPT);
 DoubleVec3D getRGBDoubleVec3DFromUser(std::string question = "", std::string prompt = PROMPT);
 
-Material* createDiffuseMaterial(const DoubleVec3D& emittance);
-Material* createRefractiveMaterial(const DoubleVec3D& emittance);
-Material* createSpecularMaterial(const DoubleVec3D& emittance);
-Material* createMaterial();
+Material* createDiffuseMaterial(const DoubleVec3D& emittance, MemoryArena* arena = nullptr);
+Material* createRefractiveMaterial(const DoubleVec3D& emittance, MemoryArena* arena = nullptr);
+Material* createSpecularMaterial(const DoubleVec3D& emittance, MemoryArena* arena = nullptr);
+Material* createMaterial(MemoryArena* arena = nullptr);
 
-Object3D* createSphere(Material* material);
-Object3D* createTriangle(Material* material);
-Object3D* createObject3D();
+Object3D* createSphere(Material* material, MemoryArena* arena = nullptr);
+Object3D* createTriangle(Material* material, MemoryArena* arena = nullptr);
+Object3D* createObject3D(MemoryArena* arena = nullptr);
 
 void to_json(json& j, const Material& mat);
-Material* importMaterialFromJson(const json& j);
+Material* importMaterialFromJson(const json& j, MemoryArena* arena = nullptr);
 void to_json(json& j, const Object3D& obj);
-Object3D* importObject3DFromJson(const json& j);
+Object3D* importObject3DFromJson(const json& j, MemoryArena* arena = nullptr);
 
 #endif
\ No newline at end of file
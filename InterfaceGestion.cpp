@@ -1,8 +1,14 @@
 #include "InterfaceGestion.h"
 
+#include "Sampler.h"
+
 // Common parts in interface
 void clearScreenPrintHeader() {
+#ifdef _WIN32
     std::system("cls");
+#else
+    std::system("clear");
+#endif
 
     std::cout << "Joachim Favre's Maturity Work" << std::endl;
     std::cout << "Path Tracer" << std::endl;
@@ -18,12 +24,16 @@ void availableCommandsHeader() {
 }
 
 void showCMDCursor(bool show) {
+#ifdef _WIN32
     // From: https://stackoverflow.com/a/18028927/12637970 (see the documentation or the report for complete bibliography)
     HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
     CONSOLE_CURSOR_INFO cursorInfo;
     GetConsoleCursorInfo(out, &cursorInfo);
     cursorInfo.bVisible = show;
     SetConsoleCursorInfo(out, &cursorInfo);
+#else
+    std::cout << (show ? "\033[?25h" : "\033[?25l") << std::flush;
+#endif
 }
 
 
@@ -39,8 +49,31 @@ double getCurrentTimeSeconds() {
 }
 
 
+// Memory
+size_t getPeakMemoryUsage() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memoryCounters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+        return 0;
+    return memoryCounters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss * 1024;  // In kilobytes on Linux
+#endif
+}
+
+
 // Random
+void setRandomSeed(unsigned int seed) {
+    re.seed(seed);
+}
+
 double randomDouble() {
+    Sampler* sampler = Sampler::getThreadSampler();
+    if (sampler != nullptr)
+        return sampler->getNextDouble();
     return unif(re);
 }
 
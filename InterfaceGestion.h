@@ -1,6 +1,7 @@
 #ifndef DEF_INTERFACEGESTION
 #define DEF_INTERFACEGESTION
 
+#include <cfloat>  // DBL_EPSILON
 #include <chrono>
 #include <fstream>
 #include <random>
@@ -15,8 +16,13 @@ using json = nlohmann::json;
 
 #include <fbxsdk.h>
 
+#ifdef _WIN32
 #define NOMINMAX  // So that window.h does not interfere with std::min and std::max
 #include <windows.h>  // To hide CMD cursor
+#include <psapi.h>  // For the peak memory usage
+#else
+#include <sys/resource.h>  // For the peak memory usage
+#endif
 
 /*!
     \file InterfaceGestion.h
@@ -58,6 +64,10 @@ using json = nlohmann::json;
     \brief Custom file extension to save parameters.
     \sa PICTURE_EXTENSION, FBX_EXTENSION, PICTURE_SAVE_EXTENSION_JSON, OBJECTS_SAVE_EXTENSION
 
+    \var const std::string STATISTICS_SAVE_EXTENSION
+    \brief Custom file extension to save the statistics of a render.
+    \sa RenderStatistics::saveTotal2File()
+
     \var static std::uniform_real_distribution<double> unif
     \brief Uniform distribution used by the randomDouble() function.
     \details This distribution gives a random double between 0 and 1.
@@ -77,7 +87,7 @@ using json = nlohmann::json;
 
     \fn void showCMDCursor(bool show)
     \brief Shows or hide the cursor in the interface.
-    \details Used code from Captain Obvlious. Remove blinking underscore on console / cmd prompt. [Accessed 28th December 2020]. Stackoverflow. 3rd August 2013. Available from: https://stackoverflow.com/a/18028927/12637970.
+    \details On other systems than Windows, ANSI escape codes are used. Used code from Captain Obvlious. Remove blinking underscore on console / cmd prompt. [Accessed 28th December 2020]. Stackoverflow. 3rd August 2013. Available from: https://stackoverflow.com/a/18028927/12637970.
     \param show Whether the cursor will be shown or hidden.
 
     \fn std::string bool2string(bool b)
@@ -89,11 +99,21 @@ using json = nlohmann::json;
     \brief Gives the number of seconds since 1st January 1970.
     \return The time since 1st January 1970 in seconds.
 
+    \fn size_t getPeakMemoryUsage()
+    \brief Gives the largest amount of memory this process used since it started.
+    \return The peak resident memory (the peak working set on Windows) in bytes.
+
+    \fn void setRandomSeed(unsigned int seed)
+    \brief Sets the seed of the random engine used by randomDouble().
+    \details Used to make benchmarks reproducible. The seed of the samplers of a render is taken from this engine, so that renders are reproducible whatever the number of threads.
+    \param seed The new seed.
+    \sa re, randomDouble()
+
     \fn double randomDouble()
     \brief Computes a random double between 0 and 1
-    \details Simply calls unif(re).
+    \details During a render, gives the next number of the sampler of the calling thread. Else, simply calls unif(re).
     \return A random double between 0 and 1 generated following a uniform distrbution.
-    \sa unif, re
+    \sa unif, re, Sampler::getThreadSampler()
 
     \fn bool fileExists(std::string fileName)
     \brief Verifies if the file exists.
@@ -120,6 +140,7 @@ const std::string FBX_EXTENSION = "fbx";
 const std::string PICTURE_SAVE_EXTENSION_JSON = "ptpict";
 const std::string OBJECTS_SAVE_EXTENSION = "ptobj";
 const std::string PARAMETERS_SAVE_EXTENSION = "ptparam";
+const std::string STATISTICS_SAVE_EXTENSION = "ptstats";
 
 static std::uniform_real_distribution<double> unif = std::uniform_real_distribution<double>(0, 1);
 static std::default_random_engine re = std::default_random_engine(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
@@ -132,6 +153,8 @@ void showCMDCursor(bool show);
 
 std::string bool2string(bool b);
 double getCurrentTimeSeconds();
+size_t getPeakMemoryUsage();
+void setRandomSeed(unsigned int seed);
 double randomDouble();
 
 bool fileExists(std::string fileName);
@@ -0,0 +1,93 @@
+#include "KDTreeCache.h"
+
+// Key
+unsigned long long hashBytes(unsigned long long hash, const void* bytes, size_t size) {
+    const unsigned char* byte = static_cast<const unsigned char*>(bytes);
+    for (size_t index = 0; index < size; index++) {
+        hash ^= byte[index];
+        hash *= 1099511628211ull;  // FNV prime
+    }
+    return hash;
+}
+
+unsigned long long computeKDTreeCacheKey(const std::vector<Object3D*>& objects, unsigned int maxObjectNumber, unsigned int maxDepth) {
+    unsigned long long hash = 14695981039346656037ull;  // FNV offset basis
+    unsigned int parameters[4] = {KD_TREE_CACHE_VERSION, maxObjectNumber, maxDepth, (unsigned int)objects.size()};
+    hash = hashBytes(hash, parameters, sizeof(parameters));
+
+    for (const Object3D* object : objects) {
+        DoubleVec3D minCoord = object->getMinCoord();
+        DoubleVec3D maxCoord = object->getMaxCoord();
+        DoubleVec3D center = object->getCenter();
+        double coordinates[9] = {minCoord.getX(), minCoord.getY(), minCoord.getZ(),
+                                 maxCoord.getX(), maxCoord.getY(), maxCoord.getZ(),
+                                 center.getX(), center.getY(), center.getZ()};
+        hash = hashBytes(hash, coordinates, sizeof(coordinates));
+    }
+    return hash;
+}
+
+std::string getKDTreeCacheFileName(unsigned long long key) {
+    std::ostringstream fileName;
+    fileName << "kdtree_" << std::hex << std::setw(16) << std::setfill('0') << key << ".ptkdtree";
+    return fileName.str();
+}
+
+
+// Saving and loading
+bool saveKDTreeCache(const KDTreeNode& root, const std::vector<Object3D*>& objects, unsigned long long key, const std::string& fileName) {
+    std::unordered_map<const Object3D*, unsigned int> objectIndexes;
+    for (unsigned int objectIndex = 0; objectIndex < objects.size(); objectIndex++)
+        objectIndexes[objects[objectIndex]] = objectIndex;
+
+    std::vector<KDTreeNode::FlatNode> flatNodes;
+    std::vector<unsigned int> objectIndices;
+    root.flatten(flatNodes, objectIndices, objectIndexes);
+
+    KDTreeCacheHeader header;
+    std::memcpy(header.magic, "PTKDTREE", sizeof(header.magic));
+    header.version = KD_TREE_CACHE_VERSION;
+    header.flatNodeSize = sizeof(KDTreeNode::FlatNode);
+    header.key = key;
+    header.nodeNumber = flatNodes.size();
+    header.objectIndexNumber = objectIndices.size();
+
+    std::ofstream file;
+    file.open(fileName, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(flatNodes.data()), flatNodes.size() * sizeof(KDTreeNode::FlatNode));
+    file.write(reinterpret_cast<const char*>(objectIndices.data()), objectIndices.size() * sizeof(unsigned int));
+    file.close();
+    return !file.fail();
+}
+
+KDTreeNode* loadKDTreeCache(const std::string& fileName, unsigned long long key, const std::vector<Object3D*>& objects, MemoryArena& arena) {
+    MappedFile file(fileName);
+    if (!file.isOpen() || file.getSize() < sizeof(KDTreeCacheHeader))
+        return nullptr;
+
+    const KDTreeCacheHeader* header = reinterpret_cast<const KDTreeCacheHeader*>(file.getData());
+    if (std::memcmp(header->magic, "PTKDTREE", sizeof(header->magic)) != 0 || header->version != KD_TREE_CACHE_VERSION || header->flatNodeSize != sizeof(KDTreeNode::FlatNode) || header->key != key)
+        return nullptr;
+    if (header->nodeNumber == 0 || file.getSize() != sizeof(KDTreeCacheHeader) + (size_t)header->nodeNumber * sizeof(KDTreeNode::FlatNode) + (size_t)header->objectIndexNumber * sizeof(unsigned int))
+        return nullptr;
+
+    // The header is a multiple of 8 bytes long, so that the arrays are aligned in the mapped file
+    const KDTreeNode::FlatNode* flatNodes = reinterpret_cast<const KDTreeNode::FlatNode*>(file.getData() + sizeof(KDTreeCacheHeader));
+    const unsigned int* objectIndices = reinterpret_cast<const unsigned int*>(flatNodes + header->nodeNumber);
+
+    // The first child is always the next node and the second one comes after it, so a valid file cannot make the construction loop
+    for (unsigned int nodeIndex = 0; nodeIndex < header->nodeNumber; nodeIndex++) {
+        const KDTreeNode::FlatNode& flatNode = flatNodes[nodeIndex];
+        if (flatNode.secondChild != 0 && (flatNode.secondChild <= nodeIndex + 1 || flatNode.secondChild >= header->nodeNumber))
+            return nullptr;
+        if ((size_t)flatNode.firstObject + flatNode.objectNumber > header->objectIndexNumber)
+            return nullptr;
+    }
+    for (unsigned int index = 0; index < header->objectIndexNumber; index++) {
+        if (objectIndices[index] >= objects.size())
+            return nullptr;
+    }
+
+    return new (arena) KDTreeNode(flatNodes, 0, objectIndices, objects, arena);
+}
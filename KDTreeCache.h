@@ -0,0 +1,97 @@
+#ifndef DEF_KDTREECACHE
+#define DEF_KDTREECACHE
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "KDTreeNode.h"
+#include "MappedFile.h"
+
+/*!
+    \file KDTreeCache.h
+    \brief Defines the KDTreeCacheHeader struct and the functions that save k-d trees to cache files and load them back.
+    \details A cache file holds a flattened k-d tree: a KDTreeCacheHeader, then the KDTreeNode::FlatNode of the tree, then the object indices of its leaves. Its name is made of the key of the tree, so that a scene whose objects did not move finds the tree it built during a previous run.
+
+    \var constexpr unsigned int KD_TREE_CACHE_VERSION
+    \brief Version of the format of the cache files. It must be incremented whenever the format or the construction of the k-d tree changes, so that older files are not loaded.
+
+    \struct KDTreeCacheHeader
+    \brief The beginning of a cache file.
+
+    \var char KDTreeCacheHeader::magic[8]
+    \brief "PTKDTREE", without null character.
+
+    \var unsigned int KDTreeCacheHeader::version
+    \brief The version of the format, KD_TREE_CACHE_VERSION.
+
+    \var unsigned int KDTreeCacheHeader::flatNodeSize
+    \brief sizeof(KDTreeNode::FlatNode), so that a file written by a build with another layout is not loaded.
+
+    \var unsigned long long KDTreeCacheHeader::key
+    \brief The key of the tree, given by computeKDTreeCacheKey().
+
+    \var unsigned int KDTreeCacheHeader::nodeNumber
+    \brief The number of nodes of the tree.
+
+    \var unsigned int KDTreeCacheHeader::objectIndexNumber
+    \brief The number of object indices stored in the leaves.
+
+    \fn unsigned long long hashBytes(unsigned long long hash, const void* bytes, size_t size)
+    \brief Mixes some bytes into a hash, with the 64 bits FNV-1a hash.
+    \param hash The current hash.
+    \param bytes The bytes.
+    \param size The number of bytes.
+    \return The new hash.
+
+    \fn unsigned long long computeKDTreeCacheKey(const std::vector<Object3D*>& objects, unsigned int maxObjectNumber, unsigned int maxDepth)
+    \brief Computes the key of the k-d tree that would be built from some objects.
+    \details The construction only uses the order of the objects, their bounding boxes and their centers, so they are all that is hashed along with the parameters. The primitives of the leaves are made from the objects when the tree is loaded, which keeps the materials and the exact shapes up to date.
+    \param objects The objects from which the tree is built.
+    \param maxObjectNumber The maximum number of objects in a leaf.
+    \param maxDepth The maximum depth of the tree.
+    \return The key.
+
+    \fn std::string getKDTreeCacheFileName(unsigned long long key)
+    \brief Gives the name of the cache file of a k-d tree.
+    \param key The key of the tree.
+    \return "kdtree_", the key in hexadecimal, and the ".ptkdtree" extension.
+
+    \fn bool saveKDTreeCache(const KDTreeNode& root, const std::vector<Object3D*>& objects, unsigned long long key, const std::string& fileName)
+    \brief Writes a k-d tree in a cache file.
+    \param root The root of the tree, which must not be lazy.
+    \param objects The objects from which the tree was built.
+    \param key The key of the tree.
+    \param fileName The name of the file, which is overwritten.
+    \return Whether the file could be written.
+
+    \fn KDTreeNode* loadKDTreeCache(const std::string& fileName, unsigned long long key, const std::vector<Object3D*>& objects, MemoryArena& arena)
+    \brief Maps a cache file in memory and rebuilds its k-d tree.
+    \details The file is checked before anything is built: its header must match the key and the current format, and every index must be in range.
+    \param fileName The name of the file.
+    \param key The key of the expected tree.
+    \param objects The objects from which the tree is built.
+    \param arena The arena in which the tree is allocated.
+    \return The root of the tree, or nullptr if the file does not exist or cannot be used.
+    \sa KDTreeNode::KDTreeNode(const KDTreeNode::FlatNode* flatNodes, unsigned int nodeIndex, const unsigned int* objectIndices, const std::vector<Object3D*>& objects, MemoryArena& arena, KDTreeNode* parent = nullptr)
+*/
+
+constexpr unsigned int KD_TREE_CACHE_VERSION = 1;
+
+struct KDTreeCacheHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int flatNodeSize;
+    unsigned long long key;
+    unsigned int nodeNumber;
+    unsigned int objectIndexNumber;
+};
+
+unsigned long long hashBytes(unsigned long long hash, const void* bytes, size_t size);
+unsigned long long computeKDTreeCacheKey(const std::vector<Object3D*>& objects, unsigned int maxObjectNumber, unsigned int maxDepth);
+std::string getKDTreeCacheFileName(unsigned long long key);
+bool saveKDTreeCache(const KDTreeNode& root, const std::vector<Object3D*>& objects, unsigned long long key, const std::string& fileName);
+KDTreeNode* loadKDTreeCache(const std::string& fileName, unsigned long long key, const std::vector<Object3D*>& objects, MemoryArena& arena);
+
+#endif
@@ -1,5 +1,7 @@
 #include "KDTreeNode.h"
 
+#include "RenderStatistics.h"
+
 
 // Intersection struct
 KDTreeNode::Intersection::Intersection(Object3D* object /*= nullptr*/, double distance /*= INFINITY*/, const KDTreeNode* kdTreeNode /*= nullptr*/)
@@ -8,105 +10,63 @@ KDTreeNode::Intersection::Intersection(Object3D* object /*= nullptr*/, double di
 
 // Constructors and destructors
 KDTreeNode::KDTreeNode() 
-    : depth(0), minCoord(0.0), maxCoord(0.0) {}
-
-KDTreeNode::KDTreeNode(std::vector<Object3D*> objects, unsigned int maxObjectNumber, unsigned int maxDepth, KDTreeNode* parent /*= nullptr*/, unsigned int depth /*= 0*/) 
-    : KDTreeNode(objects, getMinPoint(objects), getMaxPoint(objects), maxObjectNumber, maxDepth, parent, depth) {}
-
-KDTreeNode::KDTreeNode(std::vector<Object3D*> objects, DoubleVec3D minCoord, DoubleVec3D maxCoord, unsigned int maxObjectNumber, unsigned int maxDepth, KDTreeNode* parent /*= nullptr*/, unsigned int depth /*= 0*/) 
-    : objects(objects), minCoord(minCoord), maxCoord(maxCoord), parent(parent), depth(depth) {
-
-    // Recursion
-    if (objects.size() > maxObjectNumber && depth < maxDepth) {
-        // Pick all centers, to know where to cut
-        std::vector<double> centers;
-        unsigned int currentBasis = depth % 3;  // we alternate basis. First x, then y, and finally z. Then loop again.
-
-        for (Object3D* object : objects) {
-            DoubleVec3D center = object->getCenter();
-
-            if (currentBasis == 0)
-                centers.push_back(center.getX());
-            else if (currentBasis == 1)
-                centers.push_back(center.getY());
-            else // currentBasis == 2
-                centers.push_back(center.getZ());
+    : depth(0), minCoord(0.0), maxCoord(0.0), built(true) {}
+
+KDTreeNode::KDTreeNode(const std::vector<Object3D*>& objects, unsigned int maxObjectNumber, unsigned int maxDepth, MemoryArena& arena, KDTreeNode* parent /*= nullptr*/, unsigned int depth /*= 0*/, bool lazy /*= false*/) 
+    : KDTreeNode(objects, getMinPoint(objects), getMaxPoint(objects), maxObjectNumber, maxDepth, arena, parent, depth, lazy) {}
+
+KDTreeNode::KDTreeNode(const std::vector<Object3D*>& objects, DoubleVec3D minCoord, DoubleVec3D maxCoord, unsigned int maxObjectNumber, unsigned int maxDepth, MemoryArena& arena, KDTreeNode* parent /*= nullptr*/, unsigned int depth /*= 0*/, bool lazy /*= false*/) 
+    : depth(depth), minCoord(minCoord), maxCoord(maxCoord), objectNumber(objects.size()), parent(parent), maxObjectNumber(maxObjectNumber), maxDepth(maxDepth), built(!lazy) {
+    this->objects = arena.allocateArray<Object3D*>(objectNumber);
+    std::copy(objects.begin(), objects.end(), this->objects);
+
+    if (lazy) {
+        // Only the ropes of the root cannot be given by a parent
+        this->arena = &arena;
+        if (parent == nullptr) {
+            const KDTreeNode* rootRopes[6] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};  // Nothing is outside the root
+            buildRopes(rootRopes, arena);
         }
+        return;
+    }
 
-        // We cut at the median of centers
-        double cut = 0.0;
-        std::sort(centers.begin(), centers.end());
-        unsigned int centersSize = centers.size();
-        
-        if (centersSize % 2 == 0)
-            cut = centers[centersSize / 2];
-        else
-            cut = (centers[(centersSize - 1) / 2] + centers[(centersSize + 1) / 2]) / 2;
-
-        // Compute min/max coordinates for children
-        DoubleVec3D maxCoordChildSmaller(maxCoord);
-        DoubleVec3D minCoordChildGreater(minCoord);
-
-        if (currentBasis == 0) {
-            maxCoordChildSmaller.setVals(cut, maxCoordChildSmaller.getY(), maxCoordChildSmaller.getZ());
-            minCoordChildGreater.setVals(cut, minCoordChildGreater.getY(), minCoordChildGreater.getZ());
-        } else if (currentBasis == 1) {
-            maxCoordChildSmaller.setVals(maxCoordChildSmaller.getX(), cut, maxCoordChildSmaller.getZ());
-            minCoordChildGreater.setVals(minCoordChildGreater.getX(), cut, minCoordChildGreater.getZ());
-        } else { // currentBasis == 2
-            maxCoordChildSmaller.setVals(maxCoordChildSmaller.getX(), maxCoordChildSmaller.getY(), cut);
-            minCoordChildGreater.setVals(minCoordChildGreater.getX(), minCoordChildGreater.getY(), cut);
-        }
+    // Recursion
+    if (objects.size() > maxObjectNumber && depth < maxDepth)
+        createChildren(arena, false);
 
-        // We split the objects according to their position to the cut
-        std::vector<Object3D*> objectsChildSmaller;
-        std::vector<Object3D*> objectsChildGreater;
+    // The ropes need the whole tree, so they are built from the root once it is finished
+    if (parent == nullptr) {
+        const KDTreeNode* rootRopes[6] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};  // Nothing is outside the root
+        buildRopes(rootRopes, arena);
+    }
 
-        for (Object3D* object : objects) {
-            double minCoord;
-            double maxCoord;
-            if (currentBasis == 0) {
-                minCoord = object->getMinCoord().getX();
-                maxCoord = object->getMaxCoord().getX();
-            }
-            else if (currentBasis == 1) {
-                minCoord = object->getMinCoord().getY();
-                maxCoord = object->getMaxCoord().getY();
-            }
-            else { // currentBasis == 2
-                minCoord = object->getMinCoord().getZ();
-                maxCoord = object->getMaxCoord().getZ();
-            }
+    if (childSmaller == nullptr)
+        storePrimitives(arena);
+}
 
-            if (maxCoord < cut)
-                objectsChildSmaller.push_back(object);
-            else if (minCoord > cut)
-                objectsChildGreater.push_back(object);
-            else {
-                objectsChildSmaller.push_back(object);
-                objectsChildGreater.push_back(object);
-            }
-        }
+KDTreeNode::KDTreeNode(const FlatNode* flatNodes, unsigned int nodeIndex, const unsigned int* objectIndices, const std::vector<Object3D*>& objects, MemoryArena& arena, KDTreeNode* parent /*= nullptr*/)
+    : depth(flatNodes[nodeIndex].depth),
+      minCoord(flatNodes[nodeIndex].minCoord[0], flatNodes[nodeIndex].minCoord[1], flatNodes[nodeIndex].minCoord[2]),
+      maxCoord(flatNodes[nodeIndex].maxCoord[0], flatNodes[nodeIndex].maxCoord[1], flatNodes[nodeIndex].maxCoord[2]),
+      parent(parent), built(true) {
+    const FlatNode& flatNode = flatNodes[nodeIndex];
+    if (flatNode.secondChild != 0) {
+        childSmaller = new (arena) KDTreeNode(flatNodes, nodeIndex + 1, objectIndices, objects, arena, this);
+        childGreater = new (arena) KDTreeNode(flatNodes, flatNode.secondChild, objectIndices, objects, arena, this);
+    }
 
-        // Create the children
-        childSmaller = new KDTreeNode(objectsChildSmaller, minCoord, maxCoordChildSmaller, maxObjectNumber, maxDepth, this, depth + 1);
-        childGreater = new KDTreeNode(objectsChildGreater, minCoordChildGreater, maxCoord, maxObjectNumber, maxDepth, this, depth + 1);
-
-        // Remove useless children. This should not be useful if the k-d tree has good recursion parameters.
-        if (childSmaller->getChildSmaller() == nullptr && childGreater->getChildSmaller() == nullptr) {
-            if (objectsChildSmaller.size() == objects.size() && objectsChildGreater.size() == objects.size()) {
-                delete childSmaller;
-                childSmaller = nullptr;
-                delete childGreater;
-                childGreater = nullptr;
-            }
-        }
+    if (parent == nullptr) {
+        const KDTreeNode* rootRopes[6] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};  // Nothing is outside the root
+        buildRopes(rootRopes, arena);
     }
-}
 
-KDTreeNode::~KDTreeNode() {
-    delete childSmaller;
-    delete childGreater;
+    if (childSmaller == nullptr) {
+        objectNumber = flatNode.objectNumber;
+        this->objects = arena.allocateArray<Object3D*>(objectNumber);
+        for (unsigned int objectIndex = 0; objectIndex < objectNumber; objectIndex++)
+            this->objects[objectIndex] = objects[objectIndices[flatNode.firstObject + objectIndex]];
+        storePrimitives(arena);
+    }
 }
 
 
@@ -114,12 +74,29 @@ KDTreeNode::~KDTreeNode() {
 unsigned int KDTreeNode::getDepth() const { return depth; }
 DoubleVec3D KDTreeNode::getMinCoord() const { return minCoord; }
 DoubleVec3D KDTreeNode::getMaxCoord() const { return maxCoord; }
-std::vector<Object3D*> KDTreeNode::getObjects() const { return objects; }
+std::vector<Object3D*> KDTreeNode::getObjects() const { return std::vector<Object3D*>(objects, objects + objectNumber); }
+unsigned int KDTreeNode::getObjectNumber() const { return objectNumber; }
 KDTreeNode* KDTreeNode::getParent() const { return parent; }
 KDTreeNode* KDTreeNode::getChildSmaller() const { return childSmaller; }
 KDTreeNode* KDTreeNode::getChildGreater() const { return childGreater; }
 
 // Methods
+unsigned int KDTreeNode::getBuiltNodeNumber() const {
+    if (!built.load(std::memory_order_acquire))
+        return 0;
+    if (childSmaller == nullptr)
+        return 1;
+    return 1 + childSmaller->getBuiltNodeNumber() + childGreater->getBuiltNodeNumber();
+}
+
+unsigned int KDTreeNode::getUnbuiltNodeNumber() const {
+    if (!built.load(std::memory_order_acquire))
+        return 1;
+    if (childSmaller == nullptr)
+        return 0;
+    return childSmaller->getUnbuiltNodeNumber() + childGreater->getUnbuiltNodeNumber();
+}
+
 unsigned int KDTreeNode::getMaxDepth() const {
     if (childSmaller == nullptr)
         return depth;
@@ -128,11 +105,12 @@ unsigned int KDTreeNode::getMaxDepth() const {
 
 unsigned int KDTreeNode::getMaxObjectNumberLeaf() const {
     if (childSmaller == nullptr)
-        return objects.size();
+        return objectNumber;
     return std::max(childSmaller->getMaxObjectNumberLeaf(), childGreater->getMaxObjectNumberLeaf());
 }
 
 double KDTreeNode::intersectionDistance(const Ray& ray) const {
+    STATISTICS_INCREMENT(boxTests);
     DoubleVec3D rayOrigin = ray.getOrigin();
     DoubleVec3D rayDirection = ray.getDirection();
     double smallestPositiveDistance = INFINITY;
@@ -202,7 +180,35 @@ bool KDTreeNode::isIn(DoubleVec3D point) const {
     return false;
 }
 
+void KDTreeNode::flatten(std::vector<FlatNode>& flatNodes, std::vector<unsigned int>& objectIndices, const std::unordered_map<const Object3D*, unsigned int>& objectIndexes) const {
+    FlatNode flatNode;
+    for (unsigned int basis = 0; basis < 3; basis++) {
+        flatNode.minCoord[basis] = getCoordinate(minCoord, basis);
+        flatNode.maxCoord[basis] = getCoordinate(maxCoord, basis);
+    }
+    flatNode.depth = depth;
+    flatNode.secondChild = 0;
+    flatNode.firstObject = objectIndices.size();
+    flatNode.objectNumber = 0;
+    if (childSmaller == nullptr) {
+        flatNode.objectNumber = objectNumber;
+        for (unsigned int objectIndex = 0; objectIndex < objectNumber; objectIndex++)
+            objectIndices.push_back(objectIndexes.at(objects[objectIndex]));
+    }
+
+    // The index is kept, since the recursive calls may reallocate the vector
+    unsigned int nodeIndex = flatNodes.size();
+    flatNodes.push_back(flatNode);
+    if (childSmaller != nullptr) {
+        childSmaller->flatten(flatNodes, objectIndices, objectIndexes);
+        flatNodes[nodeIndex].secondChild = flatNodes.size();
+        childGreater->flatten(flatNodes, objectIndices, objectIndexes);
+    }
+}
+
 KDTreeNode::Intersection KDTreeNode::getIntersectionForward(const Ray& ray) const {
+    STATISTICS_INCREMENT(nodeVisits);
+    ensureBuilt();
     if (childSmaller != nullptr) {  // both children are nullptr at the same time
         double distanceChildSmaller = childSmaller->intersectionDistance(ray);
         double distanceChildGreater = childGreater->intersectionDistance(ray);
@@ -249,54 +255,342 @@ KDTreeNode::Intersection KDTreeNode::getIntersectionForward(const Ray& ray) cons
             return childGreater->getIntersectionForward(ray);
     }
     else {
-        double smallestPositiveDistance = INFINITY;  // Has to be strictly positive -> we don't want it to intersect with same object
+        double smallestPositiveDistance = INFINITY;
         Object3D* closestObject = nullptr;
-        for (Object3D* object : objects) {
-            double distance = object->smallestPositiveIntersection(ray);
-            if (distance > 0.00001 && distance < smallestPositiveDistance) {
-                smallestPositiveDistance = distance;
-                closestObject = object;
+        intersectPrimitives(ray, spheres, sphereNumber, smallestPositiveDistance, closestObject);
+        intersectPrimitives(ray, triangles, triangleNumber, smallestPositiveDistance, closestObject);
+        return Intersection(closestObject, smallestPositiveDistance, this);
+    }
+}
+
+KDTreeNode::Intersection KDTreeNode::getIntersectionWithRopes(const Ray& ray) const {
+    DoubleVec3D rayOrigin = ray.getOrigin();
+    DoubleUnitVec3D rayDirection = ray.getDirection();
+    double origin[3] = {rayOrigin.getX(), rayOrigin.getY(), rayOrigin.getZ()};
+    double direction[3] = {rayDirection.getX(), rayDirection.getY(), rayDirection.getZ()};
+
+    // Rays that do not start in this node, such as camera rays, enter the tree through the root
+    const KDTreeNode* node = this;
+    double entryDistance = 0.0;
+    if (!isIn(rayOrigin)) {
+        while (node->parent != nullptr)
+            node = node->parent;
+        STATISTICS_INCREMENT(boxTests);
+        double exitDistance = INFINITY;
+        entryDistance = -INFINITY;
+        for (unsigned int basis = 0; basis < 3; basis++) {
+            if (direction[basis] > -DBL_EPSILON && direction[basis] < DBL_EPSILON) {  // parallel with the planes
+                if (origin[basis] < getCoordinate(node->minCoord, basis) || origin[basis] > getCoordinate(node->maxCoord, basis))
+                    return Intersection(nullptr, INFINITY, node);
+                continue;
             }
+            double distanceMin = (getCoordinate(node->minCoord, basis) - origin[basis]) / direction[basis];
+            double distanceMax = (getCoordinate(node->maxCoord, basis) - origin[basis]) / direction[basis];
+            entryDistance = std::max(entryDistance, std::min(distanceMin, distanceMax));
+            exitDistance = std::min(exitDistance, std::max(distanceMin, distanceMax));
         }
-        return Intersection(closestObject, smallestPositiveDistance, this);
+        if (entryDistance > exitDistance || exitDistance <= 0.00001)
+            return Intersection(nullptr, INFINITY, node);
+        entryDistance = std::max(entryDistance, 0.0);
+    }
+
+    double smallestPositiveDistance = INFINITY;
+    Object3D* closestObject = nullptr;
+    while (true) {
+        // Down to the leaf containing the point where the ray enters the node
+        STATISTICS_INCREMENT(nodeVisits);
+        node->ensureBuilt();
+        while (node->childSmaller != nullptr) {
+            unsigned int basis = node->depth % 3;
+            double cut = getCoordinate(node->childSmaller->maxCoord, basis);
+            double entryCoordinate = origin[basis] + direction[basis]*entryDistance;
+            if (entryCoordinate < cut || (entryCoordinate == cut && direction[basis] < 0.0))
+                node = node->childSmaller;
+            else
+                node = node->childGreater;
+            STATISTICS_INCREMENT(nodeVisits);
+            node->ensureBuilt();
+        }
+
+        intersectPrimitives(ray, node->spheres, node->sphereNumber, smallestPositiveDistance, closestObject);
+        intersectPrimitives(ray, node->triangles, node->triangleNumber, smallestPositiveDistance, closestObject);
+
+        // Find the face through which the ray leaves the leaf
+        STATISTICS_INCREMENT(boxTests);
+        double exitDistance = INFINITY;
+        unsigned int exitFace = 0;
+        for (unsigned int basis = 0; basis < 3; basis++) {
+            double distance;
+            if (direction[basis] > DBL_EPSILON)
+                distance = (getCoordinate(node->maxCoord, basis) - origin[basis]) / direction[basis];
+            else if (direction[basis] < -DBL_EPSILON)
+                distance = (getCoordinate(node->minCoord, basis) - origin[basis]) / direction[basis];
+            else
+                continue;  // parallel with the planes
+            if (distance < exitDistance) {
+                exitDistance = distance;
+                exitFace = 2*basis + ((direction[basis] > 0.0) ? 1 : 0);
+            }
+        }
+
+        // An intersection in this leaf cannot be hidden by one in the next leaves
+        if (smallestPositiveDistance <= exitDistance || node->ropes[exitFace] == nullptr)
+            return Intersection(closestObject, smallestPositiveDistance, node);
+        node = node->ropes[exitFace];
+        entryDistance = std::max(entryDistance, exitDistance);  // Rounding errors must not make the ray go back
+    }
+}
+
+void KDTreeNode::getPacketIntersections(const RayPacket& packet, Intersection* intersections) const {
+    double distances[RAY_PACKET_MAX_SIZE];
+    for (unsigned int ray = 0; ray < packet.getSize(); ray++) {
+        intersections[ray] = Intersection(nullptr, INFINITY, this);
+        distances[ray] = INFINITY;
+    }
+
+    // The rays that were active in the parent are tested again when the node is popped, as closer intersections may have been found meanwhile
+    std::vector<std::pair<const KDTreeNode*, unsigned int>> stack;
+    stack.reserve(64);
+    stack.push_back(std::make_pair(this, packet.getAllRaysMask()));
+    while (!stack.empty()) {
+        const KDTreeNode* node = stack.back().first;
+        unsigned int testedRays = stack.back().second;
+        stack.pop_back();
+        for (unsigned int ray = 0; ray < packet.getSize(); ray++) {  // Counted per ray, so that it can be compared with single rays
+            if ((testedRays >> ray) & 1u)
+                STATISTICS_INCREMENT(boxTests);
+        }
+        unsigned int activeRays = packet.intersectBox(node->minCoord, node->maxCoord, testedRays, distances);
+        if (activeRays == 0)
+            continue;
+        STATISTICS_INCREMENT(nodeVisits);
+        node->ensureBuilt();
+
+        if (node->childSmaller != nullptr) {
+            // The node was cut along the same basis as in the constructor
+            unsigned int firstActiveRay = 0;
+            while (((activeRays >> firstActiveRay) & 1u) == 0)
+                firstActiveRay++;
+            DoubleUnitVec3D direction = packet.getRay(firstActiveRay).getDirection();
+            unsigned int currentBasis = node->depth % 3;
+            double directionAlongBasis = (currentBasis == 0) ? direction.getX() : ((currentBasis == 1) ? direction.getY() : direction.getZ());
+
+            // The closest child is pushed last, so that it is visited first
+            if (directionAlongBasis >= 0.0) {
+                stack.push_back(std::make_pair(node->childGreater, activeRays));
+                stack.push_back(std::make_pair(node->childSmaller, activeRays));
+            }
+            else {
+                stack.push_back(std::make_pair(node->childSmaller, activeRays));
+                stack.push_back(std::make_pair(node->childGreater, activeRays));
+            }
+        }
+        else {
+            for (unsigned int ray = 0; ray < packet.getSize(); ray++) {
+                if (((activeRays >> ray) & 1u) == 0)
+                    continue;
+                Object3D* closestObject = nullptr;
+                intersectPrimitives(packet.getRay(ray), node->spheres, node->sphereNumber, distances[ray], closestObject);
+                intersectPrimitives(packet.getRay(ray), node->triangles, node->triangleNumber, distances[ray], closestObject);
+                if (closestObject != nullptr)
+                    intersections[ray] = Intersection(closestObject, distances[ray], node);
+            }
+        }
+    }
+
+    // An object can be in several leaves, and be found in one that does not contain the intersection point
+    for (unsigned int ray = 0; ray < packet.getSize(); ray++) {
+        if (intersections[ray].object == nullptr)
+            continue;
+        DoubleVec3D intersectionPoint = packet.getRay(ray).getOrigin() + packet.getRay(ray).getDirection()*distances[ray];
+        if (!intersections[ray].kdTreeNode->isIn(intersectionPoint))
+            intersections[ray].kdTreeNode = getLeafContaining(intersectionPoint);
     }
 }
 
-KDTreeNode::Intersection KDTreeNode::getIntersectionBackwards(const Ray& ray, const KDTreeNode* ignore /*= nullptr*/) const {
+void KDTreeNode::buildRopes(const KDTreeNode* const* nodeRopes, MemoryArena& arena) {  // private
+    const KDTreeNode* optimisedRopes[6];
+    for (unsigned int face = 0; face < 6; face++)
+        optimisedRopes[face] = optimiseRope(nodeRopes[face], face);
+
     if (childSmaller == nullptr) {
-        Intersection intersection = getIntersectionForward(ray);
-        if (intersection.object != nullptr && isIn(ray.getOrigin() + ray.getDirection()*intersection.distance))
-            return intersection;
+        ropes = arena.allocateArray<const KDTreeNode*>(6);
+        std::copy(optimisedRopes, optimisedRopes + 6, ropes);
+        return;
+    }
 
-        if (parent == nullptr)
-            return Intersection(nullptr, INFINITY, this);
+    // Each child is the neighbour of the other through the cut
+    unsigned int basis = depth % 3;
+    const KDTreeNode* childRopes[6];
+    std::copy(optimisedRopes, optimisedRopes + 6, childRopes);
+    childRopes[2*basis + 1] = childGreater;
+    childSmaller->buildRopes(childRopes, arena);
+    childRopes[2*basis + 1] = optimisedRopes[2*basis + 1];
+    childRopes[2*basis] = childSmaller;
+    childGreater->buildRopes(childRopes, arena);
+}
+
+const KDTreeNode* KDTreeNode::optimiseRope(const KDTreeNode* rope, unsigned int face) const {  // private
+    // Goes down the neighbour as long as a single one of its children touches the face. A lazy neighbour may be built by another thread, its children are only read once it is built.
+    unsigned int faceBasis = face / 2;
+    while (rope != nullptr && rope->built.load(std::memory_order_acquire) && rope->childSmaller != nullptr) {
+        unsigned int ropeBasis = rope->depth % 3;
+        double cut = getCoordinate(rope->childSmaller->maxCoord, ropeBasis);
+        if (ropeBasis == faceBasis)
+            rope = (face % 2 == 1) ? rope->childSmaller : rope->childGreater;
+        else if (cut <= getCoordinate(minCoord, ropeBasis))
+            rope = rope->childGreater;
+        else if (cut >= getCoordinate(maxCoord, ropeBasis))
+            rope = rope->childSmaller;
         else
-            return parent->getIntersectionBackwards(ray, this);
+            break;
     }
-    // One of the children must be ignored
-    if (childSmaller == ignore) {
-        Intersection intersection = childGreater->getIntersectionForward(ray);
-        if((intersection.object == nullptr || !childGreater->isIn(ray.getOrigin() + ray.getDirection()*intersection.distance)) && parent != nullptr)
-            return parent->getIntersectionBackwards(ray, this);
-        return intersection;
+    return rope;
+}
+
+const KDTreeNode* KDTreeNode::getLeafContaining(const DoubleVec3D& point) const {
+    const KDTreeNode* node = this;
+    node->ensureBuilt();
+    while (node->childSmaller != nullptr) {
+        node = node->childSmaller->isIn(point) ? node->childSmaller : node->childGreater;
+        node->ensureBuilt();
     }
-    if (childGreater == ignore) {
-        Intersection intersection = childSmaller->getIntersectionForward(ray);
-        if ((intersection.object == nullptr || !childSmaller->isIn(ray.getOrigin() + ray.getDirection()*intersection.distance)) && parent != nullptr)
-            return parent->getIntersectionBackwards(ray, this);
-        return intersection;
+    return node;
+}
+
+void KDTreeNode::createChildren(MemoryArena& arena, bool lazy) {  // private
+    std::vector<Object3D*> objects(this->objects, this->objects + objectNumber);
+
+    // Pick all centers, to know where to cut
+    std::vector<double> centers;
+    unsigned int currentBasis = depth % 3;  // we alternate basis. First x, then y, and finally z. Then loop again.
+
+    for (Object3D* object : objects) {
+        DoubleVec3D center = object->getCenter();
+
+        if (currentBasis == 0)
+            centers.push_back(center.getX());
+        else if (currentBasis == 1)
+            centers.push_back(center.getY());
+        else // currentBasis == 2
+            centers.push_back(center.getZ());
     }
 
-    // No child must be ignored
-    Intersection intersection = getIntersectionForward(ray);
-    if (intersection.object != nullptr && isIn(ray.getOrigin() + ray.getDirection()*intersection.distance))
-        return intersection;
-    if (parent != nullptr)
-        return parent->getIntersectionBackwards(ray, this);
-    return intersection;
+    // We cut at the median of centers
+    double cut = 0.0;
+    std::sort(centers.begin(), centers.end());
+    unsigned int centersSize = centers.size();
+    
+    if (centersSize % 2 == 0)
+        cut = centers[centersSize / 2];
+    else
+        cut = (centers[(centersSize - 1) / 2] + centers[(centersSize + 1) / 2]) / 2;
+
+    // Compute min/max coordinates for children
+    DoubleVec3D maxCoordChildSmaller(maxCoord);
+    DoubleVec3D minCoordChildGreater(minCoord);
+
+    if (currentBasis == 0) {
+        maxCoordChildSmaller.setVals(cut, maxCoordChildSmaller.getY(), maxCoordChildSmaller.getZ());
+        minCoordChildGreater.setVals(cut, minCoordChildGreater.getY(), minCoordChildGreater.getZ());
+    } else if (currentBasis == 1) {
+        maxCoordChildSmaller.setVals(maxCoordChildSmaller.getX(), cut, maxCoordChildSmaller.getZ());
+        minCoordChildGreater.setVals(minCoordChildGreater.getX(), cut, minCoordChildGreater.getZ());
+    } else { // currentBasis == 2
+        maxCoordChildSmaller.setVals(maxCoordChildSmaller.getX(), maxCoordChildSmaller.getY(), cut);
+        minCoordChildGreater.setVals(minCoordChildGreater.getX(), minCoordChildGreater.getY(), cut);
+    }
+
+    // We split the objects according to their position to the cut
+    std::vector<Object3D*> objectsChildSmaller;
+    std::vector<Object3D*> objectsChildGreater;
+
+    for (Object3D* object : objects) {
+        double minCoord;
+        double maxCoord;
+        if (currentBasis == 0) {
+            minCoord = object->getMinCoord().getX();
+            maxCoord = object->getMaxCoord().getX();
+        }
+        else if (currentBasis == 1) {
+            minCoord = object->getMinCoord().getY();
+            maxCoord = object->getMaxCoord().getY();
+        }
+        else { // currentBasis == 2
+            minCoord = object->getMinCoord().getZ();
+            maxCoord = object->getMaxCoord().getZ();
+        }
+
+        if (maxCoord < cut)
+            objectsChildSmaller.push_back(object);
+        else if (minCoord > cut)
+            objectsChildGreater.push_back(object);
+        else {
+            objectsChildSmaller.push_back(object);
+            objectsChildGreater.push_back(object);
+        }
+    }
+
+    // Create the children
+    childSmaller = new (arena) KDTreeNode(objectsChildSmaller, minCoord, maxCoordChildSmaller, maxObjectNumber, maxDepth, arena, this, depth + 1, lazy);
+    childGreater = new (arena) KDTreeNode(objectsChildGreater, minCoordChildGreater, maxCoord, maxObjectNumber, maxDepth, arena, this, depth + 1, lazy);
+
+    // Remove useless children. This should not be useful if the k-d tree has good recursion parameters.
+    // Lazy children are not split yet, but they would only stay leaves at the maximum depth
+    bool childrenAreLeaves = lazy ? depth + 1 >= maxDepth : (childSmaller->getChildSmaller() == nullptr && childGreater->getChildSmaller() == nullptr);
+    if (childrenAreLeaves) {
+        if (objectsChildSmaller.size() == objects.size() && objectsChildGreater.size() == objects.size()) {
+            // Their memory is freed with the arena
+            childSmaller = nullptr;
+            childGreater = nullptr;
+        }
+    }
+}
+
+void KDTreeNode::storePrimitives(MemoryArena& arena) {  // private
+    // Only the leaves are intersected
+    std::vector<SpherePrimitive> spherePrimitives;
+    std::vector<TrianglePrimitive> trianglePrimitives;
+    splitIntoPrimitives(std::vector<Object3D*>(objects, objects + objectNumber), spherePrimitives, trianglePrimitives);
+
+    sphereNumber = spherePrimitives.size();
+    spheres = arena.allocateArray<SpherePrimitive>(sphereNumber);
+    std::uninitialized_copy(spherePrimitives.begin(), spherePrimitives.end(), spheres);
+    triangleNumber = trianglePrimitives.size();
+    triangles = arena.allocateArray<TrianglePrimitive>(triangleNumber);
+    std::uninitialized_copy(trianglePrimitives.begin(), trianglePrimitives.end(), triangles);
+}
+
+void KDTreeNode::ensureBuilt() const {  // private
+    if (built.load(std::memory_order_acquire))
+        return;
+
+    // A node entered by several threads at once is built only once, the other threads wait for its children
+    KDTreeNode* node = const_cast<KDTreeNode*>(this);  // Building a node does not change the intersections it gives
+    if (node->building.test_and_set(std::memory_order_acquire)) {
+        while (!built.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        return;
+    }
+
+    if (objectNumber > maxObjectNumber && depth < maxDepth)
+        node->createChildren(*arena, true);
+    if (childSmaller != nullptr)
+        node->buildRopes(ropes, *arena);  // The children are not split yet, so that they get their own ropes
+    else
+        node->storePrimitives(*arena);
+    node->built.store(true, std::memory_order_release);
 }
 
 // Functions
+double getCoordinate(const DoubleVec3D& vector, unsigned int basis) {
+    if (basis == 0)
+        return vector.getX();
+    if (basis == 1)
+        return vector.getY();
+    return vector.getZ();  // basis == 2
+}
+
 DoubleVec3D getMinPoint(std::vector<Object3D*> objects) {
     double minX = INFINITY;
     double minY = INFINITY;
@@ -1,7 +1,13 @@
 #ifndef DEF_KDTREENODE
 #define DEF_KDTREENODE
 
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
 #include "InterfaceCreation.h"
+#include "Primitive.h"
+#include "RayPacket.h"
 
 /*!
     \file KDTreeNode.h
@@ -10,6 +16,7 @@
     \class KDTreeNode
     \brief A node of a k-d tree.
     \details See my TM's report for further information on this data structure. 
+    A tree can also be built lazily: a node only stores its objects until a ray first enters it, and is then split (or made a leaf) under a flag that the threads check before reading its children. Parts of the scene that no ray reaches are never split.
 
     \struct KDTreeNode::Intersection
     \brief A struct binding a pointer to an Object3D, a distance, and a pointer to a KDTreeNode.
@@ -29,32 +36,68 @@
     \param distance The distance between the ray origin and the intersection point.
     \param kdTreeNode The KDTreeNode in which the ray and the object intersect.
 
+    \struct KDTreeNode::FlatNode
+    \brief A node of a tree stored without pointers, as in the cache files.
+    \details The nodes are stored depth first, so that the first child of a node is the next one. The objects are given by their indices in the vector from which the tree was built.
+    \sa KDTreeNode::flatten(), saveKDTreeCache()
+
+    \var double KDTreeNode::FlatNode::minCoord[3]
+    \brief The minimum coordinate of the node.
+
+    \var double KDTreeNode::FlatNode::maxCoord[3]
+    \brief The maximum coordinate of the node.
+
+    \var unsigned int KDTreeNode::FlatNode::depth
+    \brief The depth of the node, which gives the basis along which it is cut.
+
+    \var unsigned int KDTreeNode::FlatNode::secondChild
+    \brief The index of the greater child, 0 for leaves.
+
+    \var unsigned int KDTreeNode::FlatNode::firstObject
+    \brief The position of the first object index of the leaf in the array of object indices.
+
+    \var unsigned int KDTreeNode::FlatNode::objectNumber
+    \brief The number of objects of the leaf, 0 for the other nodes.
+
     \fn KDTreeNode::KDTreeNode()
     \brief Default constructor. Everything is set to 0 by default.
 
-    \fn KDTreeNode::KDTreeNode(std::vector<Object3D*> objects, unsigned int maxObjectNumber, unsigned int maxDepth, KDTreeNode* parent = nullptr, unsigned int depth = 0)
+    \fn KDTreeNode::KDTreeNode(const std::vector<Object3D*>& objects, unsigned int maxObjectNumber, unsigned int maxDepth, MemoryArena& arena, KDTreeNode* parent = nullptr, unsigned int depth = 0, bool lazy = false)
     \brief One of the main constructors.
     \details Computes the minimum and maximum coordinates according to the objects in parameters using getMinPoint(std::vector<Object3D*> objects) and getMaxPoint(std::vector<Object3D*> objects). Then calls the other main constructor.
     \param objects The objects that are in this node.
     \param maxObjectNumber Maximum number of objects in a k-d tree leaf. One of the two recursion stop conditions. If one of them is fulfilled, stops the recursion.
     \param maxDepth Maximum recursion depth. One of the two recursion stop conditions. If one of them is fulfilled, stops the recursion.
+    \param arena The arena in which the children and the objects arrays are allocated.
     \param parent A pointer to this node's parent.
     \param depth The current recursive depth.
+    \param lazy Whether the node is only split when a ray first enters it.
     \sa getMinPoint(std::vector<Object3D*> objects), getMaxPoint(std::vector<Object3D*> objects)
 
-    \fn KDTreeNode::KDTreeNode(std::vector<Object3D*> objects, DoubleVec3D minCoord, DoubleVec3D maxCoord, unsigned int maxObjectNumber, unsigned int maxDepth, KDTreeNode* parent = nullptr, unsigned int depth = 0)
+    \fn KDTreeNode::KDTreeNode(const std::vector<Object3D*>& objects, DoubleVec3D minCoord, DoubleVec3D maxCoord, unsigned int maxObjectNumber, unsigned int maxDepth, MemoryArena& arena, KDTreeNode* parent = nullptr, unsigned int depth = 0, bool lazy = false)
     \brief One of the main constructors.
-    \details Recursively creates children. See the list of parameters to know when the recursion stops. After having finished, deletes leaves (node that do not have any child) that have the exact same number of objects as their parent.
+    \details Recursively creates children. See the list of parameters to know when the recursion stops. After having finished, removes leaves (node that do not have any child) that have the exact same number of objects as their parent. The leaves then store their objects by value, as one array of SpherePrimitive and one of TrianglePrimitive, which the intersections go through instead of calling the virtual methods of Object3D.
     \param objects The objects that are in this node.
     \param minCoord The minimum coordinate of this node.
     \param maxCoord The maximum coordinate of this node.
     \param maxObjectNumber Maximum number of objects in a k-d tree leaf. One of the two recursion stop conditions. If one of them is fulfilled, stops the recursion.
     \param maxDepth Maximum recursion depth. One of the two recursion stop conditions. If one of them is fulfilled, stops the recursion.
+    \param arena The arena in which the children and the objects arrays are allocated.
     \param parent A pointer to this node's parent.
     \param depth The current recursive depth.
-    
-    \fn KDTreeNode::~KDTreeNode()
-    \brief Destructor.
+    \param lazy Whether the node is only split when a ray first enters it. If so, the constructor only copies the objects, and KDTreeNode::ensureBuilt() does the rest later.
+    \warning A tree is never deleted node by node: the whole tree is freed at once by releasing its arena (see MemoryArena::release()).
+
+    \fn KDTreeNode::KDTreeNode(const KDTreeNode::FlatNode* flatNodes, unsigned int nodeIndex, const unsigned int* objectIndices, const std::vector<Object3D*>& objects, MemoryArena& arena, KDTreeNode* parent = nullptr)
+    \brief Constructor rebuilding a node and its children from a flattened tree, without choosing any cut.
+    \details Only the leaves get their objects back, the other nodes have none. The root then builds the ropes.
+    \param flatNodes The flattened tree, which must be valid.
+    \param nodeIndex The index of this node in flatNodes.
+    \param objectIndices The object indices of the leaves.
+    \param objects The objects to which the indices refer.
+    \param arena The arena in which the children and the objects arrays are allocated.
+    \param parent A pointer to this node's parent.
+    \sa loadKDTreeCache()
 
     \fn unsigned int KDTreeNode::getDepth()
     \brief Getter for this node's depth.
@@ -70,8 +113,13 @@
 
     \fn std::vector<Object3D*> KDTreeNode::getObjects()
     \brief Getter for this node's objects.
+    \details The objects are stored contiguously in the tree's arena, this makes a copy of them.
     \return The objects contained in this node.
 
+    \fn unsigned int KDTreeNode::getObjectNumber()
+    \brief Getter for this node's number of objects.
+    \return The number of objects contained in this node.
+
     \fn KDTreeNode* KDTreeNode::getParent()
     \brief Getter for this node's parent.
     \return The parent of this node.
@@ -86,10 +134,22 @@
     \details The greater child and the smaller one are distinguished by their position to the cut.
     \return The greater child of this node.
 
+    \fn unsigned int KDTreeNode::getBuiltNodeNumber()
+    \brief Counts the nodes of this subtree that were built.
+    \details Always all of them if the tree is not lazy.
+    \return The number of built nodes.
+    \sa KDTreeNode::getUnbuiltNodeNumber()
+
+    \fn unsigned int KDTreeNode::getUnbuiltNodeNumber()
+    \brief Counts the nodes of this subtree that were never entered by a ray, in a lazy tree.
+    \details Each of them stands for a whole subtree that was never split.
+    \return The number of nodes that are not built.
+    \sa KDTreeNode::getBuiltNodeNumber()
+
     \fn unsigned int KDTreeNode::getMaxDepth()
     \brief Gives the maximum depth of this tree.
     \details This function must be called from the root node of a tree.
-    \return Its own depth, if it has no child; the maximum between the maximum depth of both its children, else.
+    \return Its own depth, if it has no child; the maximum between the maximum depth of both its children, else. In a lazy tree, only the nodes built so far are taken into account.
     \sa KDTreeNode::getMaxObjectNumberLeaf()
 
     \fn unsigned int KDTreeNode::getMaxObjectNumberLeaf()
@@ -108,17 +168,68 @@
     \param point The point for which we want this information.
     \return Whether a point is inside this node.
 
+    \fn void KDTreeNode::flatten(std::vector<KDTreeNode::FlatNode>& flatNodes, std::vector<unsigned int>& objectIndices, const std::unordered_map<const Object3D*, unsigned int>& objectIndexes)
+    \brief Appends this node and its children to a flattened tree.
+    \details The tree must be completely built, so it cannot be lazy.
+    \param flatNodes The flattened nodes, to which this subtree is appended depth first.
+    \param objectIndices The object indices of the leaves, to which the ones of this subtree are appended.
+    \param objectIndexes The index of every object in the vector from which the tree was built.
+
     \fn KDTreeNode::Intersection KDTreeNode::getIntersectionForward(const Ray& ray)
     \brief Computes the intersection going from the top to the bottom of the tree.
     \param ray The ray with which the intersection is computed.
     \return The intersection.
 
-    \fn KDTreeNode::Intersection KDTreeNode::getIntersectionBackwards(const Ray& ray, const KDTreeNode* ignore = nullptr)
-    \brief Computes the intersection going from the bottom to the top of the tree.
-    \details Starts at a bottom node and alternates between backwards and forward intersection.
+    \fn KDTreeNode::Intersection KDTreeNode::getIntersectionWithRopes(const Ray& ray)
+    \brief Computes the intersection going from leaf to leaf through the ropes, starting from this node.
+    \details If the ray origin is in this node, the ray goes down to the leaf containing it, so that a ray starting where the previous one stopped only visits the leaves it crosses. Else, it enters the tree through the root. In every leaf, the ray leaves through one of the six faces, and the rope of this face gives the next node. No stack is needed and no node is visited twice.
     \param ray The ray with which the intersection is computed.
-    \param ignore A KDTreeNode that will be ignored when computing a forward intersection.
-    \return The intersection.
+    \return The intersection. Its node is the leaf in which the search stopped, which contains the intersection point.
+
+    \fn void KDTreeNode::getPacketIntersections(const RayPacket& packet, KDTreeNode::Intersection* intersections)
+    \brief Computes the intersections of a packet of rays, going from the top to the bottom of the tree.
+    \details The rays go through the tree together, with a stack instead of recursion. A node is visited if at least one ray enters it before its closest intersection found so far; the children are visited in the order of the first active ray. In a leaf, only the active rays are tested against the objects.
+    This function must be called from the root node of a tree.
+    \param packet The rays.
+    \param intersections Filled with the intersection of every ray of the packet. Its node contains the intersection point, so that the next rays can start from it with KDTreeNode::getIntersectionWithRopes().
+
+    \fn const KDTreeNode* KDTreeNode::getLeafContaining(const DoubleVec3D& point)
+    \brief Finds the leaf in which a point is, going from this node to the bottom of the tree.
+    \param point The point, which must be inside this node.
+    \return The leaf.
+
+    \fn void KDTreeNode::createChildren(MemoryArena& arena, bool lazy)
+    \brief Cuts this node at the median of the centers of its objects and creates its two children.
+    \details The children are not kept if they both have all the objects of this node and are leaves.
+    \param arena The arena in which the children are allocated.
+    \param lazy Whether the children are built lazily, else they are recursively built.
+
+    \fn void KDTreeNode::storePrimitives(MemoryArena& arena)
+    \brief Copies the objects of this leaf as SpherePrimitive and TrianglePrimitive.
+    \param arena The arena in which the primitives are allocated.
+
+    \fn void KDTreeNode::ensureBuilt()
+    \brief Builds this node if it is lazy and was not built yet: it gets its children and gives them their ropes, or it becomes a leaf.
+    \details Every traversal calls it before reading the children of a node. The first thread that enters the node builds it, and the other ones wait for it to be built, since they need its children. Different nodes are built at the same time by different threads, only their allocations are locked by the arena of the tree (see MemoryArena::setSynchronised()).
+
+    \fn void KDTreeNode::buildRopes(const KDTreeNode* const* nodeRopes, MemoryArena& arena)
+    \brief Recursively gives every leaf its six ropes.
+    \details In a lazy tree, a node that is not built yet is taken as a leaf, and its ropes are given to its children once it is built. Since the neighbours may not be built either, the ropes may point to larger nodes than in a full tree, which the traversal goes down from.
+    Called by the constructor of the root, once the whole tree exists (Vlastimil Havran et al. "Kd-tree Based Fast Ray Tracing for Scenes with Dynamic Objects", as used by Stefan Popov et al. "Stackless KD-Tree Traversal for High Performance GPU Ray Tracing" (2007)).
+    \param nodeRopes The ropes of this node, in the order of the faces: minimum x, maximum x, minimum y, maximum y, minimum z, maximum z. nullptr if the face is on the border of the tree.
+    \param arena The arena in which the ropes of the leaves are allocated.
+
+    \fn const KDTreeNode* KDTreeNode::optimiseRope(const KDTreeNode* rope, unsigned int face)
+    \brief Makes a rope point to the smallest node that contains all the neighbours of a face of this node.
+    \param rope The node on the other side of the face.
+    \param face The index of the face, as in KDTreeNode::buildRopes().
+    \return The smallest node on the other side of the face, whose volume contains the whole face.
+
+    \fn double getCoordinate(const DoubleVec3D& vector, unsigned int basis)
+    \brief Gives a coordinate of a vector from its basis.
+    \param vector The vector.
+    \param basis 0 for x, 1 for y and 2 for z.
+    \return The coordinate.
 
     \fn DoubleVec3D getMinPoint(std::vector<Object3D*> objects)
     \brief Computes the minimum point of a cuboid containing all the objects.
@@ -142,12 +253,31 @@ private:
     unsigned int depth;
     DoubleVec3D minCoord;
     DoubleVec3D maxCoord;
-    std::vector<Object3D*> objects;
+    Object3D** objects = nullptr;  // Allocated in the arena
+    unsigned int objectNumber = 0;
+    SpherePrimitive* spheres = nullptr;  // Only in leaves, allocated in the arena
+    unsigned int sphereNumber = 0;
+    TrianglePrimitive* triangles = nullptr;  // Only in leaves, allocated in the arena
+    unsigned int triangleNumber = 0;
+    const KDTreeNode** ropes = nullptr;  // Six neighbours, only in leaves and unbuilt nodes, allocated in the arena
 
     KDTreeNode* parent = nullptr;
     KDTreeNode* childSmaller = nullptr;
     KDTreeNode* childGreater = nullptr;
 
+    // Lazy construction
+    unsigned int maxObjectNumber = 0;
+    unsigned int maxDepth = 0;
+    MemoryArena* arena = nullptr;  // Only in lazy nodes
+    std::atomic<bool> built;
+    std::atomic_flag building = ATOMIC_FLAG_INIT;  // Taken by the thread that builds a lazy node
+
+    void createChildren(MemoryArena& arena, bool lazy);
+    void storePrimitives(MemoryArena& arena);
+    void ensureBuilt() const;
+    void buildRopes(const KDTreeNode* const* nodeRopes, MemoryArena& arena);
+    const KDTreeNode* optimiseRope(const KDTreeNode* rope, unsigned int face) const;
+
 public:
     struct Intersection {
         Object3D* object;
@@ -157,28 +287,44 @@ public:
         Intersection(Object3D* object = nullptr, double distance = INFINITY, const KDTreeNode* kdTreeNode = nullptr);
     };
 
+    struct FlatNode {
+        double minCoord[3];
+        double maxCoord[3];
+        unsigned int depth;
+        unsigned int secondChild;
+        unsigned int firstObject;
+        unsigned int objectNumber;
+    };
+
     KDTreeNode();
-    KDTreeNode(std::vector<Object3D*> objects, unsigned int maxObjectNumber, unsigned int maxDepth, KDTreeNode* parent = nullptr, unsigned int depth = 0);
-    KDTreeNode(std::vector<Object3D*> objects, DoubleVec3D minCoord, DoubleVec3D maxCoord, unsigned int maxObjectNumber, unsigned int maxDepth, KDTreeNode* parent = nullptr, unsigned int depth = 0);
-    ~KDTreeNode();
+    KDTreeNode(const std::vector<Object3D*>& objects, unsigned int maxObjectNumber, unsigned int maxDepth, MemoryArena& arena, KDTreeNode* parent = nullptr, unsigned int depth = 0, bool lazy = false);
+    KDTreeNode(const std::vector<Object3D*>& objects, DoubleVec3D minCoord, DoubleVec3D maxCoord, unsigned int maxObjectNumber, unsigned int maxDepth, MemoryArena& arena, KDTreeNode* parent = nullptr, unsigned int depth = 0, bool lazy = false);
+    KDTreeNode(const FlatNode* flatNodes, unsigned int nodeIndex, const unsigned int* objectIndices, const std::vector<Object3D*>& objects, MemoryArena& arena, KDTreeNode* parent = nullptr);
 
     unsigned int getDepth() const;
     DoubleVec3D getMinCoord() const;
     DoubleVec3D getMaxCoord() const;
     std::vector<Object3D*> getObjects() const;
+    unsigned int getObjectNumber() const;
     KDTreeNode* getParent() const;
     KDTreeNode* getChildSmaller() const;
     KDTreeNode* getChildGreater() const;
 
+    unsigned int getBuiltNodeNumber() const;
+    unsigned int getUnbuiltNodeNumber() const;
     unsigned int getMaxDepth() const;
     unsigned int getMaxObjectNumberLeaf() const;
 
     double intersectionDistance(const Ray& ray) const;
     bool isIn(DoubleVec3D point) const;
+    void flatten(std::vector<FlatNode>& flatNodes, std::vector<unsigned int>& objectIndices, const std::unordered_map<const Object3D*, unsigned int>& objectIndexes) const;
     Intersection getIntersectionForward(const Ray& ray) const;
-    Intersection getIntersectionBackwards(const Ray& ray, const KDTreeNode* ignore = nullptr) const;
+    Intersection getIntersectionWithRopes(const Ray& ray) const;
+    void getPacketIntersections(const RayPacket& packet, Intersection* intersections) const;
+    const KDTreeNode* getLeafContaining(const DoubleVec3D& point) const;
 };
 
+double getCoordinate(const DoubleVec3D& vector, unsigned int basis);
 DoubleVec3D getMinPoint(std::vector<Object3D*> objects);
 DoubleVec3D getMaxPoint(std::vector<Object3D*> objects);
 
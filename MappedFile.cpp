@@ -0,0 +1,55 @@
+#include "MappedFile.h"
+
+// Constructor and destructor
+MappedFile::MappedFile(const std::string& fileName) {
+#ifdef _WIN32
+    file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        return;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+        return;
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+        return;
+    data = static_cast<const char*>(view);
+    size = (size_t)fileSize.QuadPart;
+#else
+    file = open(fileName.c_str(), O_RDONLY);
+    if (file == -1)
+        return;
+    struct stat fileStatus;
+    if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+        return;
+    void* view = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED)
+        return;
+    data = static_cast<const char*>(view);
+    size = (size_t)fileStatus.st_size;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data != nullptr)
+        UnmapViewOfFile(data);
+    if (mapping != nullptr)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+#else
+    if (data != nullptr)
+        munmap(const_cast<char*>(data), size);
+    if (file != -1)
+        close(file);
+#endif
+}
+
+
+// Getters
+bool MappedFile::isOpen() const { return data != nullptr; }
+const char* MappedFile::getData() const { return data; }
+size_t MappedFile::getSize() const { return size; }
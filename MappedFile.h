@@ -0,0 +1,71 @@
+#ifndef DEF_MAPPEDFILE
+#define DEF_MAPPEDFILE
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // So that window.h does not interfere with std::min and std::max
+#endif
+#include <windows.h>  // To map the file
+#else
+#include <fcntl.h>  // To open the file
+#include <sys/mman.h>  // To map the file
+#include <sys/stat.h>  // To know its size
+#include <unistd.h>  // To close the file
+#endif
+
+/*!
+    \file MappedFile.h
+    \brief Defines the MappedFile class.
+
+    \class MappedFile
+    \brief A file mapped in memory, read-only.
+    \details The operating system only reads the pages that are accessed, and they stay in its cache from one run to the next, so reading a big binary file does not copy it through a stream first.
+
+    \fn MappedFile::MappedFile(const std::string& fileName)
+    \brief Main constructor. Maps the file.
+    \param fileName The name of the file. If it cannot be opened or is empty, the MappedFile is not open.
+
+    \fn MappedFile::~MappedFile()
+    \brief Destructor. Unmaps the file.
+    \warning The pointers given by MappedFile::getData() become invalid.
+
+    \fn bool MappedFile::isOpen()
+    \brief Returns whether the file was mapped.
+    \return True if the file could be opened and mapped, false else.
+
+    \fn const char* MappedFile::getData()
+    \brief Getter for the content of the file.
+    \return A pointer to the first byte of the file, nullptr if it is not open.
+
+    \fn size_t MappedFile::getSize()
+    \brief Getter for the size of the file.
+    \return The size of the file in bytes, 0 if it is not open.
+*/
+
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int file = -1;
+#endif
+
+public:
+    MappedFile(const std::string& fileName);
+    MappedFile(const MappedFile& mappedFile) = delete;
+    ~MappedFile();
+
+    bool isOpen() const;
+    const char* getData() const;
+    size_t getSize() const;
+
+    MappedFile& operator=(const MappedFile& mappedFile) = delete;
+};
+
+#endif
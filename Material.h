@@ -1,6 +1,7 @@
 #ifndef DEF_MATERIAL
 #define DEF_MATERIAL
 
+#include "MemoryArena.h"
 #include "Ray.h"
 
 /*!
@@ -30,6 +31,12 @@
     \brief Makes a deep copy of this material.
     \return A pointer to a deeply copied version of this material.
 
+    \fn virtual Material* Material::deepCopy(MemoryArena& arena) = 0
+    \brief Makes a deep copy of this material in an arena.
+    \param arena The arena in which the copy will be allocated.
+    \return A pointer to a deeply copied version of this material.
+    \sa MemoryArena
+
     \fn virtual DoubleUnitVec3D Material::getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) = 0
     \brief Computes the new ray direction.
     \param previousRay The ray that hits this material.
@@ -43,6 +50,14 @@
     \param nextEventEstimation Whether the radiance is obtained using the next event estimation algorithm.
     \return The new radiance.
 
+    \fn virtual double Material::getDirectionPdf(const Ray& previousRay, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection) = 0
+    \brief Computes the probability density with which Material::getNewDirection() returns a direction.
+    \details Used by multiple importance sampling to weight the contributions of BSDF sampling and light sampling.
+    \param previousRay The ray that hits this material.
+    \param normal The normal at the intersection.
+    \param newDirection The direction of the next ray.
+    \return The probability density, with respect to solid angle. 0 if the direction cannot be sampled by another strategy (for a Dirac distribution, for example).
+
     \fn virtual bool Material::worksWithNextEventEstimation() = 0
     \brief Returns whether this material works with next event estimation.
     \return True if this material works with the next event estimation algorithm, false else.
@@ -86,9 +101,11 @@ public:
     void setEmittance(DoubleVec3D emittance);
 
     virtual Material* deepCopy() const = 0;
+    virtual Material* deepCopy(MemoryArena& arena) const = 0;
     
     virtual DoubleUnitVec3D getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) const = 0;
     virtual DoubleVec3D computeCurrentRadiance(const DoubleVec3D& recursiveRadiance, double cosAngleNewDirectionNormal, bool nextEventEstimation = false) const = 0;
+    virtual double getDirectionPdf(const Ray& previousRay, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection) const = 0;
     virtual bool worksWithNextEventEstimation() const = 0;
 
     virtual std::ostream& getDescription(std::ostream& stream) const = 0;
@@ -0,0 +1,74 @@
+#include "MemoryArena.h"
+
+#include <algorithm>
+
+// Constructors and destructor
+MemoryArena::MemoryArena(size_t blockSize /*= DEFAULT_BLOCK_SIZE*/)
+    : blockSize(blockSize) {}
+
+MemoryArena::~MemoryArena() {
+    release();
+}
+
+
+// Getters
+size_t MemoryArena::getBlockSize() const { return blockSize; }
+size_t MemoryArena::getAllocatedBytes() const { return allocatedBytes; }
+size_t MemoryArena::getReservedBytes() const { return reservedBytes; }
+bool MemoryArena::isSynchronised() const { return synchronised; }
+
+
+// Setters
+void MemoryArena::setSynchronised(bool synchronised) { this->synchronised = synchronised; }
+
+
+// Allocation
+void* MemoryArena::allocate(size_t size, size_t alignment /*= alignof(std::max_align_t)*/) {
+    if (!synchronised)
+        return allocateUnsynchronised(size, alignment);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocateUnsynchronised(size, alignment);
+}
+
+void* MemoryArena::allocateUnsynchronised(size_t size, size_t alignment) {  // private
+    // Padding needed so that the returned address is aligned (alignment is a power of two)
+    size_t padding = (alignment - ((size_t)(currentBlock + currentOffset) & (alignment - 1))) & (alignment - 1);
+
+    if (currentBlock == nullptr || currentOffset + padding + size > currentBlockSize) {
+        // The worst case padding is alignment - 1
+        size_t newBlockSize = std::max(blockSize, size + alignment);
+        currentBlock = new char[newBlockSize];
+        currentBlockSize = newBlockSize;
+        currentOffset = 0;
+        blocks.push_back(currentBlock);
+        reservedBytes += newBlockSize;
+
+        padding = (alignment - ((size_t)currentBlock & (alignment - 1))) & (alignment - 1);
+    }
+
+    void* result = currentBlock + currentOffset + padding;
+    currentOffset += padding + size;
+    allocatedBytes += size;
+    return result;
+}
+
+void MemoryArena::release() {
+    for (char* block : blocks)
+        delete[] block;
+    blocks.clear();
+
+    currentBlock = nullptr;
+    currentBlockSize = 0;
+    currentOffset = 0;
+    allocatedBytes = 0;
+    reservedBytes = 0;
+}
+
+
+// Placement operators
+void* operator new(size_t size, MemoryArena& arena) {
+    return arena.allocate(size);
+}
+
+void operator delete(void*, MemoryArena&) {}  // Freed with the arena
@@ -0,0 +1,144 @@
+#ifndef DEF_MEMORYARENA
+#define DEF_MEMORYARENA
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*!
+    \file MemoryArena.h
+    \brief Defines the MemoryArena class and some functions around it.
+
+    \class MemoryArena
+    \brief Bump allocator that hands out memory from big blocks and frees everything at once.
+    \details Allocating many small objects one by one (triangles, materials, k-d tree nodes) is slow and scatters them across the heap. An arena allocates them contiguously and releases them all in one call. The destructors of the objects are not called by the arena, and it cannot tell whether a pointer comes from it: its users must remember what they allocated in it, see Object3DGroup::getArena().
+
+    \var static constexpr size_t MemoryArena::DEFAULT_BLOCK_SIZE
+    \brief The default size of a block, in bytes.
+
+    \fn MemoryArena::MemoryArena(size_t blockSize = DEFAULT_BLOCK_SIZE)
+    \brief Main constructor.
+    \details No memory is allocated before the first call to MemoryArena::allocate().
+    \param blockSize The size of the blocks that will be allocated, in bytes. Bigger allocations get a block of their own.
+
+    \fn MemoryArena::~MemoryArena()
+    \brief Destructor.
+    \details Calls MemoryArena::release().
+
+    \fn size_t MemoryArena::getBlockSize()
+    \brief Getter for the block size.
+    \return The size of the blocks that are allocated, in bytes.
+
+    \fn size_t MemoryArena::getAllocatedBytes()
+    \brief Getter for the number of bytes given to the users of this arena.
+    \return The number of bytes that were allocated since the last release.
+
+    \fn size_t MemoryArena::getReservedBytes()
+    \brief Getter for the number of bytes reserved by this arena.
+    \return The total size of the blocks this arena currently holds.
+
+    \fn bool MemoryArena::isSynchronised()
+    \brief Getter for the synchronisation of the allocations.
+    \return Whether several threads can allocate in this arena at the same time.
+
+    \fn void MemoryArena::setSynchronised(bool synchronised)
+    \brief Setter for the synchronisation of the allocations.
+    \details If true, each allocation locks a mutex of the arena. It is only needed when several threads allocate at the same time, such as the render threads building a lazy k-d tree.
+    \param synchronised Whether several threads can allocate in this arena at the same time.
+
+    \fn void* MemoryArena::allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    \brief Allocates memory in this arena.
+    \param size The number of bytes that are needed.
+    \param alignment The alignment of the returned address. Must be a power of two.
+    \return A pointer to the allocated memory. It stays valid until MemoryArena::release() is called.
+
+    \fn T* MemoryArena::allocateArray(size_t number)
+    \brief Allocates an array of trivially destructible objects in this arena.
+    \details The elements are not initialised.
+    \param number The number of elements.
+    \return A pointer to the first element, or nullptr if number is 0.
+
+    \fn void* MemoryArena::allocateUnsynchronised(size_t size, size_t alignment)
+    \brief Allocates memory in this arena without locking it.
+    \param size The number of bytes that are needed.
+    \param alignment The alignment of the returned address. Must be a power of two.
+    \return A pointer to the allocated memory.
+
+    \fn void MemoryArena::release()
+    \brief Frees all the blocks at once.
+    \warning All the pointers given by this arena become invalid. Destructors are not called.
+
+    \fn void* operator new(size_t size, MemoryArena& arena)
+    \brief Placement new operator allocating in an arena.
+    \details Allows to write new (arena) Triangle(...).
+    \param size The size of the object.
+    \param arena The arena in which the object will be allocated.
+    \return A pointer to the memory of the object.
+
+    \fn void operator delete(void* pointer, MemoryArena& arena)
+    \brief Placement delete operator matching operator new(size_t size, MemoryArena& arena).
+    \details Only called if a constructor throws. Does nothing, the memory is freed with the arena.
+    \param pointer The pointer that would be freed.
+    \param arena The arena in which the object was allocated.
+
+    \fn T* newInArenaOrHeap(MemoryArena* arena, Args&&... args)
+    \brief Creates an object in an arena, or on the heap if no arena is given.
+    \param arena The arena in which the object will be allocated, or nullptr to use the heap.
+    \param args The arguments given to the constructor.
+    \return A pointer to the created object.
+*/
+
+class MemoryArena {
+private:
+    size_t blockSize;
+    std::vector<char*> blocks;
+    char* currentBlock = nullptr;
+    size_t currentBlockSize = 0;
+    size_t currentOffset = 0;
+    size_t allocatedBytes = 0;
+    size_t reservedBytes = 0;
+    bool synchronised = false;
+    std::mutex mutex;  // Only locked if synchronised
+
+    void* allocateUnsynchronised(size_t size, size_t alignment);
+
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 20;  // 1 MiB
+
+    MemoryArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    MemoryArena(const MemoryArena& arena) = delete;
+    ~MemoryArena();
+
+    size_t getBlockSize() const;
+    size_t getAllocatedBytes() const;
+    size_t getReservedBytes() const;
+    bool isSynchronised() const;
+
+    void setSynchronised(bool synchronised);
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T* allocateArray(size_t number) {
+        if (number == 0)
+            return nullptr;
+        return static_cast<T*>(allocate(number * sizeof(T), alignof(T)));
+    }
+
+    void release();
+
+    MemoryArena& operator=(const MemoryArena& arena) = delete;
+};
+
+void* operator new(size_t size, MemoryArena& arena);
+void operator delete(void* pointer, MemoryArena& arena);
+
+template <typename T, typename... Args>
+T* newInArenaOrHeap(MemoryArena* arena, Args&&... args) {
+    if (arena == nullptr)
+        return new T(std::forward<Args>(args)...);
+    return new (*arena) T(std::forward<Args>(args)...);
+}
+
+#endif
@@ -20,6 +20,21 @@ double Object3D::getArea() const { return area; }
 void Object3D::setMaterial(Material* material) { this->material = material; }
 
 
+// Light sampling
+DoubleVec3D Object3D::sampleLightPoint(const DoubleVec3D& origin, double& pdf) const {
+    DoubleVec3D point = getRandomPoint();
+    pdf = getLightPdf(origin, point);
+    return point;
+}
+
+double Object3D::getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject) const {
+    DoubleVec3D pointToOrigin = origin - pointOnObject;
+    double squaredDistance = dotProd(pointToOrigin, pointToOrigin);
+    double cosAngleLamp = fabs(dotProd(getNormal(pointOnObject), pointToOrigin)) / sqrt(squaredDistance);
+    return squaredDistance / (area * cosAngleLamp);
+}
+
+
 // Ostream operator
 std::ostream& operator<<(std::ostream& stream, const Object3D& object) {
     return object.getDescription(stream) << std::endl << "-> " << *(object.getMaterial());
@@ -56,6 +56,13 @@
     \brief Makes a deep copy of this object.
     \return A pointer to a deeply copied version of this object.
 
+    \fn virtual Object3D* Object3D::deepCopy(MemoryArena& arena) = 0
+    \brief Makes a deep copy of this object in an arena.
+    \details The material is copied in the same arena.
+    \param arena The arena in which the copy will be allocated.
+    \return A pointer to a deeply copied version of this object.
+    \sa MemoryArena
+
     \fn virtual double Object3D::smallestPositiveIntersection(const Ray& ray) = 0
     \brief Computes the smallest positive intersection between the ray and this object.
     \param ray The ray with wich we want to compute the intersection.
@@ -71,6 +78,21 @@
     \details Every point has the same probability to show up.
     \return A random point on this object.
 
+    \fn virtual DoubleVec3D Object3D::sampleLightPoint(const DoubleVec3D& origin, double& pdf)
+    \brief Computes a random point on the object, when it is used as a lamp seen from origin.
+    \details By default, uses Object3D::getRandomPoint(). Objects can override it to only sample the part of them that can be seen from origin.
+    \param origin The point from which the lamp is sampled.
+    \param pdf Set to the probability density of the point, with respect to solid angle as seen from origin.
+    \return A random point on this object.
+    \sa Object3D::getLightPdf()
+
+    \fn virtual double Object3D::getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject)
+    \brief Computes the probability density with which Object3D::sampleLightPoint() returns a point.
+    \details By default, the density with respect to area given by Object3D::getRandomPoint(), which is 1/area, is converted to a density with respect to solid angle. It is also used by multiple importance sampling.
+    \param origin The point from which the lamp is sampled.
+    \param pointOnObject The sampled point on this object.
+    \return The probability density, with respect to solid angle.
+
     \fn virtual std::ostream& Object3D::getDescription(std::ostream& stream) = 0
     \brief Returns this object's description.
     \param stream The current stream.
@@ -137,10 +159,13 @@ public:
 
     virtual void computeArea() = 0;
     virtual Object3D* deepCopy() const = 0;
+    virtual Object3D* deepCopy(MemoryArena& arena) const = 0;
 
     virtual double smallestPositiveIntersection(const Ray& ray) const = 0;
     virtual DoubleUnitVec3D getNormal(const DoubleVec3D& point) const = 0;
     virtual DoubleVec3D getRandomPoint() const = 0;
+    virtual DoubleVec3D sampleLightPoint(const DoubleVec3D& origin, double& pdf) const;
+    virtual double getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject) const;
     virtual std::ostream& getDescription(std::ostream& stream) const = 0;
     virtual DoubleVec3D getCenter() const = 0;
     virtual DoubleVec3D getMinCoord() const = 0;
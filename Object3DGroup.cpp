@@ -4,8 +4,8 @@
 Object3DGroup::Object3DGroup()
     : name("None"), objects(), center(0.0) {}
 
-Object3DGroup::Object3DGroup(const std::string& name, std::vector<Object3D*> objects /* = {}*/)
-    : name(name) {
+Object3DGroup::Object3DGroup(const std::string& name, std::vector<Object3D*> objects /* = {}*/, MemoryArena* arena /*= nullptr*/)
+    : name(name), arena(arena) {
     setObjects(objects);
 }
 
@@ -22,6 +22,7 @@ Object3DGroup::~Object3DGroup() {
 std::string Object3DGroup::getName() const { return name; }
 std::vector<Object3D*> Object3DGroup::getObjects() const { return objects; }
 DoubleVec3D Object3DGroup::getCenter() const { return center; }
+MemoryArena* Object3DGroup::getArena() const { return arena; }
 
 
 // Setters
@@ -53,13 +54,27 @@ void Object3DGroup::addObjects(const std::vector<Object3D*>& newObjects) {
 
 void Object3DGroup::merge(const Object3DGroup& group) {    addObjects(group.getObjects()); }
 
+void Object3DGroup::moveToArena(MemoryArena& arena) {
+    if (this->arena == &arena)
+        return;
+
+    for (Object3D*& object : objects) {
+        Object3D* arenaObject = object->deepCopy(arena);
+        delete object;
+        object = arenaObject;
+    }
+    this->arena = &arena;
+}
+
 void Object3DGroup::resetObjects() {
     objects.clear();
 }
 
 void Object3DGroup::resetAndDeleteObjects() {
-    for (Object3D* object : objects)
-        delete object;
+    if (arena == nullptr) {  // Else they are freed with the arena
+        for (Object3D* object : objects)
+            delete object;
+    }
     resetObjects();
 }
 
@@ -94,9 +109,10 @@ void Object3DGroup::printAll() const {
 }
 
 
-void Object3DGroup::modify() {
+bool Object3DGroup::modify() {
     hide = objects.size() >= MIN_OBJECTS_HIDE;
     bool commandWasInvalid = false;
+    bool objectsChanged = false;
     while (true) {
         printAll();
 
@@ -116,11 +132,12 @@ void Object3DGroup::modify() {
 
         switch (command) {
         case 'a': {
-            Object3D* newObject = createObject3D();
+            Object3D* newObject = createObject3D(arena);
             addObject(newObject);
+            objectsChanged = true;
             break;
         }
-        case 'b': return;
+        case 'b': return objectsChanged;
         case 'd': {
             if (objects.size() >= 1) {
                 while (true) {
@@ -131,9 +148,8 @@ void Object3DGroup::modify() {
                         std::cout << std::endl;
                         bool confirmation = getBoolFromUser("Do you confirm the deletion of all the objects? " + BOOL_INFO);
                         if (confirmation) {
-                            for (Object3D* object : objects)
-                                delete object;
-                            objects.clear();
+                            resetAndDeleteObjects();
+                            objectsChanged = true;
                         }
                         break;
                     }
@@ -141,8 +157,10 @@ void Object3DGroup::modify() {
                         std::cout << std::endl;
                         bool confirmation = getBoolFromUser("Do you confirm the deletion of this object? " + BOOL_INFO);
                         if (confirmation) {
-                            delete objects[index];
+                            if (arena == nullptr)  // Else freed with the arena
+                                delete objects[index];
                             objects.erase(objects.begin() + index);
+                            objectsChanged = true;
                         }
                         break;
                     }
@@ -168,15 +186,17 @@ void Object3DGroup::modify() {
                         break;
                     if (index == -2) {
                         std::cout << std::endl;
-                        Material* newMaterial = createMaterial();
+                        Material* newMaterial = createMaterial(arena);
                         for (Object3D* object : objects)
                             object->setMaterial(newMaterial);
+                        objectsChanged = true;  // The lamps may have changed
                         break;
                     }
                     if (index >= 0 && index < objects.size()) {
                         std::cout << std::endl;
-                        Material* newMaterial = createMaterial();
+                        Material* newMaterial = createMaterial(arena);
                         objects[index]->setMaterial(newMaterial);
+                        objectsChanged = true;  // The lamps may have changed
                         break;
                     }
                     std::cout << "This index is invalid!" << std::endl << std::endl;
@@ -240,12 +260,15 @@ void to_json(json& j, const Object3DGroup& group) {
 
 
 void from_json(const json& j, Object3DGroup& group) {
+    group = importObject3DGroupFromJson(j, nullptr);
+}
+
+Object3DGroup importObject3DGroupFromJson(const json& j, MemoryArena* arena) {
     std::vector<Object3D*> objects;
-    for (json jObject : j["Objects"]) {
-        objects.push_back(importObject3DFromJson(jObject));
+    objects.reserve(j["Objects"].size());
+    for (const json& jObject : j["Objects"]) {
+        objects.push_back(importObject3DFromJson(jObject, arena));
     }
-    group.addObjects(objects);
-    
-    std::string name = j["Name"].get<std::string>();
-    group.setName(name);
+
+    return Object3DGroup(j["Name"].get<std::string>(), objects, arena);
 }
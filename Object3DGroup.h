@@ -12,15 +12,17 @@
     \class Object3DGroup
     \brief Group of objects.
     \details It is used to make the interface clearer. Instead of having all the objects at the same place, they are grouped and have a common name.
+    The objects of a group and their materials are either all on the heap, or all in the same MemoryArena. The objects in an arena are never deleted one by one, they are freed with it.
 
     \fn Object3DGroup::Object3DGroup()
     \brief Default constructor.
     \details The name is "none" by default.
 
-    \fn Object3DGroup::Object3DGroup(const std::string& name, std::vector<Object3D*> objects = {})
+    \fn Object3DGroup::Object3DGroup(const std::string& name, std::vector<Object3D*> objects = {}, MemoryArena* arena = nullptr)
     \brief Main constructor.
     \param name The name of this object group.
     \param objects The std::vector of Object3D pointers that are in this group.
+    \param arena The arena in which the objects and their materials are allocated, nullptr if they are on the heap.
 
     \fn Object3DGroup::Object3DGroup(const Object3DGroup& group)
     \brief Copy constructor.
@@ -47,6 +49,10 @@
     \details The center is computed by taking the average of the center of each object.
     \return The center of this object group.
 
+    \fn MemoryArena* Object3DGroup::getArena()
+    \brief Getter for the arena of the objects.
+    \return The arena in which the objects and their materials are allocated, nullptr if they are on the heap.
+
     \fn void Object3DGroup::setName(const std::string& name)
     \brief Setter for the name.
     \param name The new name of this object group.
@@ -70,7 +76,13 @@
     \brief Merge with an other object group.
     \details Keeps the current name, but adds the objects of the second one. 
     \param group The group from which the objects will be copied.
-    \warning The pointers are not deeply copied.
+    \warning The pointers are not deeply copied. Both groups must have the same arena, see Object3DGroup::moveToArena().
+
+    \fn void Object3DGroup::moveToArena(MemoryArena& arena)
+    \brief Moves the objects of this group and their materials to an arena.
+    \details The objects are deeply copied in the arena, and the ones on the heap are deleted. Does nothing if the objects are already in this arena.
+    \param arena The arena in which the objects will be.
+    \warning The objects must be on the heap or already in this arena.
 
     \fn void Object3DGroup::resetObjects()
     \brief Resets all objects of this object group.
@@ -79,7 +91,7 @@
 
     \fn void Object3DGroup::resetAndDeleteObjects()
     \brief Deletes all pointers to the objects of this object group, then reset its objects.
-    \details Calls the function Object3DGroup::resetObjects().
+    \details Calls the function Object3DGroup::resetObjects(). The objects in an arena are not deleted, they are freed with it.
     \sa Object3DGroup::resetObjects()
 
     \fn static Object3DGroup Object3DGroup::create()
@@ -91,9 +103,11 @@
     \details Clears the page, prints the header, information and the available commands.
     \sa clearScreenPrintHeader()
 
-    \fn void Object3DGroup::modify()
+    \fn bool Object3DGroup::modify()
     \brief Interactive modification of this object group.
-    \details This is a page on its own.
+    \details This is a page on its own. The objects and materials it creates are allocated where the other ones of the group are.
+    \return Whether objects were added or deleted, or materials were changed. Renaming the group does not count.
+    \sa Scene::modifyObjectGroup()
 
     \fn std::ostream& operator<<(std::ostream& stream, const Object3DGroup& group)
     \brief Ostream operator.
@@ -114,9 +128,17 @@
 
     \fn void from_json(const json& j, Object3DGroup& group)
     \brief Conversion from json.
-    \details Used for the .get<Object3DGroup>() function.
+    \details Used for the .get<Object3DGroup>() function. The objects are allocated on the heap.
     \param j Json input.
     \param group The ouput object group.
+    \sa importObject3DGroupFromJson()
+
+    \fn Object3DGroup importObject3DGroupFromJson(const json& j, MemoryArena* arena)
+    \brief Conversion from json, allocating the objects in an arena.
+    \param j Json input.
+    \param arena The arena in which the objects and their materials will be allocated. If it is nullptr, they are allocated on the heap.
+    \return The imported object group, whose arena is the given one.
+    \sa from_json(const json& j, Object3DGroup& group), Scene::addObjectGroupsFromJson()
 */
 
 class Object3DGroup {
@@ -127,16 +149,18 @@ private:
     std::string name;
     std::vector<Object3D*> objects;
     DoubleVec3D center;
+    MemoryArena* arena = nullptr;  // Where the objects and their materials are allocated, nullptr for the heap
 
 public:
     Object3DGroup();
-    Object3DGroup(const std::string& name, std::vector<Object3D*> objects = {});
+    Object3DGroup(const std::string& name, std::vector<Object3D*> objects = {}, MemoryArena* arena = nullptr);
     Object3DGroup(const Object3DGroup& group);
     ~Object3DGroup();
 
     std::string getName() const;
     std::vector<Object3D*> getObjects() const;
     DoubleVec3D getCenter() const;
+    MemoryArena* getArena() const;
 
     void setName(const std::string& name);
     void setObjects(const std::vector<Object3D*>& newObjects);
@@ -144,12 +168,13 @@ public:
     void addObject(Object3D* object);
     void addObjects(const std::vector<Object3D*>& newObjects);
     void merge(const Object3DGroup& group);
+    void moveToArena(MemoryArena& arena);
     void resetObjects();
     void resetAndDeleteObjects();
 
     static Object3DGroup create();
     void printAll() const;
-    void modify();
+    bool modify();
 };
 
 std::ostream& operator<<(std::ostream& stream, const Object3DGroup& group);
@@ -158,5 +183,6 @@ std::vector<Object3D*> split(const std::vector<Object3DGroup>& groups);
 
 void to_json(json& j, const Object3DGroup& group);
 void from_json(const json& j, Object3DGroup& group);
+Object3DGroup importObject3DGroupFromJson(const json& j, MemoryArena* arena);
 
 #endif
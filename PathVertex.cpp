@@ -0,0 +1,36 @@
+#include "PathVertex.h"
+
+// Constructor
+PathVertex::PathVertex(PathVertexType type, const DoubleVec3D& point, const DoubleVec3D& beta)
+    : type(type), point(point), beta(beta) {}
+
+
+// Methods
+bool PathVertex::isConnectible() const {
+    return !delta;
+}
+
+DoubleVec3D PathVertex::getBsdf(const DoubleVec3D& toEye, const DoubleVec3D& toLight) const {
+    // Only reflection: the eye and the light must both be on the side of the normal
+    if (type != PATH_VERTEX_SURFACE || delta || dotProd(toEye, normal) <= 0.0 || dotProd(toLight, normal) <= 0.0)
+        return DoubleVec3D(0.0);
+    return object->getMaterial()->computeCurrentRadiance(DoubleVec3D(1.0), 1.0, true);  // With a cosine of 1, this is the BSDF
+}
+
+double PathVertex::getDirectionPdf(const PathVertex& previous, const PathVertex& next) const {
+    if (type != PATH_VERTEX_SURFACE || delta)
+        return 0.0;
+    DoubleUnitVec3D toNext = next.point - point;
+    double directionPdf = object->getMaterial()->getDirectionPdf(Ray(previous.point, point - previous.point), normal, toNext);
+    return convertDensity(directionPdf, next);
+}
+
+double PathVertex::convertDensity(double directionPdf, const PathVertex& next) const {
+    DoubleVec3D toNext = next.point - point;
+    double squaredDistance = dotProd(toNext, toNext);
+    if (squaredDistance == 0.0)
+        return 0.0;
+    if (next.type == PATH_VERTEX_CAMERA)  // The camera is a point, it has no area
+        return directionPdf / squaredDistance;
+    return directionPdf * std::abs(dotProd(toNext, next.normal)) / (squaredDistance * std::sqrt(squaredDistance));
+}
@@ -0,0 +1,104 @@
+#ifndef DEF_PATHVERTEX
+#define DEF_PATHVERTEX
+
+#include "KDTreeNode.h"
+
+/*!
+    \file PathVertex.h
+    \brief Defines the PathVertex struct and the PathVertexType enum.
+
+    \var constexpr unsigned int BIDIRECTIONAL_MAX_BOUNCES
+    \brief Maximum number of bounces of a path of the bidirectional path tracer when russian roulette is used.
+
+    \enum PathVertexType
+    \brief The kinds of vertices a subpath of the bidirectional path tracer can have.
+
+    \struct PathVertex
+    \brief A vertex of a camera or light subpath, used by the bidirectional path tracer.
+    \details The probability densities are with respect to area, so that subpaths can be compared whatever the side from which they were generated. The BSDF is the one of traceRay(): a diffuse object only reflects the light arriving on the side of its normal, and it can send it to both sides.
+    \sa Scene::getBidirectionalPathTracing()
+
+    \var PathVertexType PathVertex::type
+    \brief Whether the vertex is the camera, the point of a lamp that starts a light subpath, or a point on an object.
+
+    \var DoubleVec3D PathVertex::point
+    \brief The position of the vertex.
+
+    \var DoubleUnitVec3D PathVertex::normal
+    \brief The normal of the object at the vertex. Unused for the camera.
+
+    \var const Object3D* PathVertex::object
+    \brief The object on which the vertex is, nullptr for the camera.
+
+    \var const KDTreeNode* PathVertex::kdTreeNode
+    \brief The k-d tree node in which the vertex is, nullptr if it is unknown.
+
+    \var DoubleVec3D PathVertex::beta
+    \brief The throughput of the subpath up to this vertex, divided by the probability density with which it was generated.
+
+    \var bool PathVertex::delta
+    \brief Whether the material of the vertex scatters in a single direction (specular and refractive materials). Such vertices cannot be connected.
+
+    \var double PathVertex::pdfForward
+    \brief The probability density, with respect to area, with which the subpath that contains the vertex generated it.
+
+    \var double PathVertex::pdfReverse
+    \brief The probability density, with respect to area, with which the other subpath would have generated the vertex.
+
+    \fn PathVertex::PathVertex(PathVertexType type, const DoubleVec3D& point, const DoubleVec3D& beta)
+    \brief Main constructor.
+    \param type The type of the vertex.
+    \param point The position of the vertex.
+    \param beta The throughput of the subpath up to this vertex.
+
+    \fn bool PathVertex::isConnectible()
+    \brief Returns whether a vertex of the other subpath can be linked to this one with a shadow ray.
+    \return False for specular and refractive objects, true else.
+
+    \fn DoubleVec3D PathVertex::getBsdf(const DoubleVec3D& toEye, const DoubleVec3D& toLight)
+    \brief Evaluates the BSDF of a surface vertex.
+    \param toEye The direction towards the vertex on the camera side of the path.
+    \param toLight The direction towards the vertex on the light side of the path.
+    \return The BSDF, 0 if the eye or the light is behind the object (so that they are on different sides of it) or if the vertex is not connectible.
+
+    \fn double PathVertex::getDirectionPdf(const PathVertex& previous, const PathVertex& next)
+    \brief Computes the probability density, with respect to area, with which a surface vertex samples the next one.
+    \param previous The vertex from which the path arrived.
+    \param next The vertex that would be sampled.
+    \return The probability density, with respect to the area around next.
+
+    \fn double PathVertex::convertDensity(double directionPdf, const PathVertex& next)
+    \brief Converts a probability density with respect to solid angle around this vertex into one with respect to area around the next vertex.
+    \param directionPdf The probability density of the direction going from this vertex to next.
+    \param next The vertex that is sampled.
+    \return The probability density with respect to the area around next.
+*/
+
+constexpr unsigned int BIDIRECTIONAL_MAX_BOUNCES = 64;
+
+enum PathVertexType {
+    PATH_VERTEX_CAMERA,
+    PATH_VERTEX_LIGHT,
+    PATH_VERTEX_SURFACE
+};
+
+struct PathVertex {
+    PathVertexType type;
+    DoubleVec3D point;
+    DoubleUnitVec3D normal;
+    const Object3D* object = nullptr;
+    const KDTreeNode* kdTreeNode = nullptr;
+    DoubleVec3D beta;
+    bool delta = false;
+    double pdfForward = 0.0;
+    double pdfReverse = 0.0;
+
+    PathVertex(PathVertexType type, const DoubleVec3D& point, const DoubleVec3D& beta);
+
+    bool isConnectible() const;
+    DoubleVec3D getBsdf(const DoubleVec3D& toEye, const DoubleVec3D& toLight) const;
+    double getDirectionPdf(const PathVertex& previous, const PathVertex& next) const;
+    double convertDensity(double directionPdf, const PathVertex& next) const;
+};
+
+#endif
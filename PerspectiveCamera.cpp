@@ -48,3 +48,39 @@ Ray PerspectiveCamera::getRayGoingThrough(double pixelX, double pixelY) const {
     DoubleUnitVec3D rayDirection = 1.0/numberPixelsX*((pixelX - numberPixelsX/2)*baseX - (pixelY - numberPixelsY/2)*baseY) + focal;
     return Ray(origin, rayDirection);
 }
+
+RayPacket PerspectiveCamera::getRayPacketGoingThrough(const double* pixelsX, const double* pixelsY, unsigned int numberRays) const {
+    DoubleVec3D stepX = baseX / numberPixelsX;
+    DoubleVec3D stepY = baseY / numberPixelsX;  // The pixels are square
+    DoubleVec3D topLeft = focal - stepX*(numberPixelsX/2) + stepY*(numberPixelsY/2);
+
+    RayPacket packet;
+    for (unsigned int ray = 0; ray < numberRays; ray++)
+        packet.addRay(Ray(origin, DoubleUnitVec3D(topLeft + stepX*pixelsX[ray] - stepY*pixelsY[ray])));
+    return packet;
+}
+
+bool PerspectiveCamera::getPixelCoordinates(const DoubleVec3D& point, double& pixelX, double& pixelY) const {
+    DoubleVec3D direction = point - origin;
+    double focalLength = length(focal);
+    double distanceAlongFocal = dotProd(direction, focal) / focalLength;
+    if (distanceAlongFocal <= 0.0)
+        return false;
+
+    // The direction is stretched until it reaches the picture, which contains origin + focal and is spanned by baseX and baseY
+    DoubleVec3D onPicture = direction*(focalLength/distanceAlongFocal) - focal;
+    pixelX = numberPixelsX*dotProd(onPicture, baseX) + numberPixelsX/2;
+    pixelY = numberPixelsY/2 - numberPixelsX*dotProd(onPicture, baseY);
+    return 0.0 <= pixelX && pixelX < numberPixelsX && 0.0 <= pixelY && pixelY < numberPixelsY;
+}
+
+double PerspectiveCamera::getImportancePdf(const DoubleUnitVec3D& direction) const {
+    double pixelX, pixelY;
+    if (!getPixelCoordinates(origin + direction, pixelX, pixelY))
+        return 0.0;
+
+    // A pixel has an area of 1/numberPixelsX^2 and is at a distance of focalLength/cos, seen with an angle whose cosine is cos
+    double focalLength = length(focal);
+    double cosAngle = dotProd(direction, focal) / focalLength;
+    return numberPixelsX*numberPixelsX*focalLength*focalLength / (cosAngle*cosAngle*cosAngle);
+}
@@ -1,7 +1,7 @@
 #ifndef DEF_PERSPECTIVECAMERA
 #define DEF_PERSPECTIVECAMERA
 
-#include "Ray.h"
+#include "RayPacket.h"
 
 /*!
     \file PerspectiveCamera.h
@@ -71,6 +71,29 @@
     \param pixelX The *x* coordinate of the pixel through which we want the ray.
     \param pixelY The *y* coordinate of the pixel through which we want the ray.
     \return A ray which origin is the camera's and which direction is such that it goes through the requested pixel.
+
+    \fn RayPacket PerspectiveCamera::getRayPacketGoingThrough(const double* pixelsX, const double* pixelsY, unsigned int numberRays)
+    \brief Returns a packet of rays going through some pixels.
+    \details The rays are the same as the ones of PerspectiveCamera::getRayGoingThrough(), but the base vectors are only read once for the whole packet.
+    \param pixelsX The *x* coordinates of the pixels through which we want the rays.
+    \param pixelsY The *y* coordinates of the pixels through which we want the rays.
+    \param numberRays The number of rays, at most RAY_PACKET_MAX_SIZE.
+    \return A packet whose ray i goes through the pixel (pixelsX[i], pixelsY[i]).
+
+    \fn bool PerspectiveCamera::getPixelCoordinates(const DoubleVec3D& point, double& pixelX, double& pixelY)
+    \brief Finds the pixel through which a point is seen.
+    \details This is the inverse of PerspectiveCamera::getRayGoingThrough().
+    \param point The point, in the virtual world.
+    \param pixelX Filled with the *x* coordinate of the pixel.
+    \param pixelY Filled with the *y* coordinate of the pixel.
+    \return True if the point is seen by the camera, false if it is behind it or outside of the picture.
+
+    \fn double PerspectiveCamera::getImportancePdf(const DoubleUnitVec3D& direction)
+    \brief Computes the probability density with which the rays of a pixel go in a direction.
+    \details The position in a pixel is sampled uniformly, so this is the same for every pixel. It is also the importance the camera gives to the direction, as every pixel is the average of the radiance arriving through it.
+    \param direction The direction, starting from the camera origin.
+    \return The probability density, with respect to solid angle. 0 if the direction goes outside of the picture.
+    \sa PerspectiveCamera::getRayGoingThrough()
 */
 
 class PerspectiveCamera {
@@ -101,6 +124,9 @@ public:
     void setFocal(DoubleVec3D focal);
 
     Ray getRayGoingThrough(double pixelX, double pixelY) const;
+    RayPacket getRayPacketGoingThrough(const double* pixelsX, const double* pixelsY, unsigned int numberRays) const;
+    bool getPixelCoordinates(const DoubleVec3D& point, double& pixelX, double& pixelY) const;
+    double getImportancePdf(const DoubleUnitVec3D& direction) const;
 };
 
 #endif
@@ -0,0 +1,78 @@
+#include "PhotonMap.h"
+
+// Constructor
+PhotonMap::PhotonMap(const std::vector<Photon>& photons, double radius, const DoubleVec3D& minPoint)
+    : radius(radius), minPoint(minPoint), photons(photons.size()) {
+    numberBuckets = 1;
+    while (numberBuckets < photons.size())
+        numberBuckets *= 2;
+
+    std::vector<unsigned int> photonBuckets(photons.size());
+#pragma omp parallel for
+    for (int photon = 0; photon < (int)photons.size(); photon++)  // photon must be signed for OpenMP
+        photonBuckets[photon] = getBucket(photons[photon].position);
+
+    // Counting sort
+    bucketBeginnings.assign(numberBuckets + 1, 0);
+    for (unsigned int bucket : photonBuckets)
+        bucketBeginnings[bucket + 1]++;
+    for (unsigned int bucket = 0; bucket < numberBuckets; bucket++)
+        bucketBeginnings[bucket + 1] += bucketBeginnings[bucket];
+
+    std::vector<unsigned int> nextPositions(bucketBeginnings.begin(), bucketBeginnings.end() - 1);
+    for (unsigned int photon = 0; photon < photons.size(); photon++)
+        this->photons[nextPositions[photonBuckets[photon]]++] = photons[photon];
+}
+
+
+// Getters
+unsigned int PhotonMap::getNumberPhotons() const { return photons.size(); }
+double PhotonMap::getRadius() const { return radius; }
+
+
+// Private methods
+unsigned int PhotonMap::getBucket(int cellX, int cellY, int cellZ) const {
+    unsigned int hash = hashCombine(hashCombine(hashUnsignedInt(cellX), hashUnsignedInt(cellY)), hashUnsignedInt(cellZ));
+    return hash & (numberBuckets - 1);
+}
+
+unsigned int PhotonMap::getBucket(const DoubleVec3D& position) const {
+    DoubleVec3D relativePosition = (position - minPoint) / radius;
+    return getBucket((int)std::floor(relativePosition.getX()), (int)std::floor(relativePosition.getY()), (int)std::floor(relativePosition.getZ()));
+}
+
+
+// Irradiance
+DoubleVec3D PhotonMap::getIrradiance(const DoubleVec3D& position, const DoubleUnitVec3D& normal) const {
+    DoubleVec3D result(0.0);
+    if (photons.empty())
+        return result;
+
+    DoubleVec3D relativePosition = (position - minPoint) / radius;
+    int cellX = (int)std::floor(relativePosition.getX());
+    int cellY = (int)std::floor(relativePosition.getY());
+    int cellZ = (int)std::floor(relativePosition.getZ());
+
+    // Two neighbouring cells can share a bucket, which must not be counted twice
+    unsigned int buckets[27];
+    unsigned int numberNeighbours = 0;
+    for (int x = cellX - 1; x <= cellX + 1; x++) {
+        for (int y = cellY - 1; y <= cellY + 1; y++) {
+            for (int z = cellZ - 1; z <= cellZ + 1; z++)
+                buckets[numberNeighbours++] = getBucket(x, y, z);
+        }
+    }
+    std::sort(buckets, buckets + numberNeighbours);
+    unsigned int* bucketsEnd = std::unique(buckets, buckets + numberNeighbours);
+
+    double squaredRadius = radius*radius;
+    for (unsigned int* bucket = buckets; bucket != bucketsEnd; bucket++) {
+        for (unsigned int photon = bucketBeginnings[*bucket]; photon < bucketBeginnings[*bucket + 1]; photon++) {
+            const Photon& currentPhoton = photons[photon];
+            DoubleVec3D difference = currentPhoton.position - position;
+            if (dotProd(difference, difference) < squaredRadius && dotProd(currentPhoton.direction, normal) < 0.0)
+                result += currentPhoton.power;
+        }
+    }
+    return result / (M_PI*squaredRadius);
+}
@@ -0,0 +1,100 @@
+#ifndef DEF_PHOTONMAP
+#define DEF_PHOTONMAP
+
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+#include <vector>
+
+#include "DoubleUnitVec3D.h"
+#include "Sampler.h"
+
+/*!
+    \file PhotonMap.h
+    \brief Defines the Photon struct and the PhotonMap class.
+
+    \struct Photon
+    \brief A packet of light that stopped on a diffuse object.
+
+    \var DoubleVec3D Photon::position
+    \brief The point where the photon stopped.
+
+    \var DoubleUnitVec3D Photon::direction
+    \brief The direction in which the photon was going.
+
+    \var DoubleVec3D Photon::power
+    \brief The power carried by the photon.
+
+    \var constexpr unsigned int CAUSTIC_PHOTON_MAX_BOUNCES
+    \brief Maximum number of objects a caustic photon can hit, the last one being diffuse.
+
+    \class PhotonMap
+    \brief Stores photons in a hash grid, to estimate the irradiance they give around a point.
+    \details The cells of the grid are as big as the radius of the estimation, so that only the 27 cells around a point need to be looked at. The photons are sorted by bucket, and each bucket stores where its photons begin, so the map is a single array.
+
+    \fn PhotonMap::PhotonMap(const std::vector<Photon>& photons, double radius, const DoubleVec3D& minPoint)
+    \brief Main constructor.
+    \details The buckets of the photons are computed in parallel, then the photons are sorted with a counting sort.
+    \param photons The photons that will be stored.
+    \param radius The radius of the irradiance estimation.
+    \param minPoint The minimum point of a cuboid containing all the objects.
+
+    \fn unsigned int PhotonMap::getNumberPhotons()
+    \brief Getter for the number of photons.
+    \return The number of photons stored in the map.
+
+    \fn double PhotonMap::getRadius()
+    \brief Getter for the radius.
+    \return The radius of the irradiance estimation.
+
+    \fn DoubleVec3D PhotonMap::getIrradiance(const DoubleVec3D& position, const DoubleUnitVec3D& normal)
+    \brief Estimates the irradiance at a point, from the photons closer than the radius.
+    \param position The point.
+    \param normal The normal of the surface at the point. Photons arriving from behind are ignored.
+    \return The sum of the powers of the photons divided by the area of the disk.
+
+    \fn unsigned int PhotonMap::getBucket(int cellX, int cellY, int cellZ)
+    \brief Computes the bucket in which the photons of a cell are stored.
+    \param cellX The *x* coordinate of the cell.
+    \param cellY The *y* coordinate of the cell.
+    \param cellZ The *z* coordinate of the cell.
+    \return The index of the bucket.
+
+    \fn unsigned int PhotonMap::getBucket(const DoubleVec3D& position)
+    \brief Computes the bucket in which the photons at a point are stored.
+    \param position The point.
+    \return The index of the bucket.
+*/
+
+constexpr unsigned int CAUSTIC_PHOTON_MAX_BOUNCES = 16;
+
+struct Photon {
+    DoubleVec3D position;
+    DoubleUnitVec3D direction;
+    DoubleVec3D power;
+};
+
+class PhotonMap {
+private:
+    double radius;
+    DoubleVec3D minPoint;
+    std::vector<Photon> photons;  // Sorted by bucket
+    std::vector<unsigned int> bucketBeginnings;  // One more than the number of buckets, so that the end of a bucket is the beginning of the next one
+    unsigned int numberBuckets;  // A power of 2
+
+    unsigned int getBucket(int cellX, int cellY, int cellZ) const;
+    unsigned int getBucket(const DoubleVec3D& position) const;
+
+public:
+    PhotonMap(const std::vector<Photon>& photons, double radius, const DoubleVec3D& minPoint);
+    PhotonMap(const PhotonMap& photonMap) = delete;
+
+    unsigned int getNumberPhotons() const;
+    double getRadius() const;
+
+    DoubleVec3D getIrradiance(const DoubleVec3D& position, const DoubleUnitVec3D& normal) const;
+
+    PhotonMap& operator=(const PhotonMap& photonMap) = delete;
+};
+
+#endif
@@ -3,21 +3,23 @@
 // Constructors & Destructors
 Picture::Picture() : Picture(500, 500) {}
 
-Picture::Picture(unsigned int width, unsigned int height, double renderTime /* = -1*/) : width(width), height(height), renderTime(renderTime) {
-    pixels = new DoubleVec3D*[width];
-    for (int pixelX = 0; pixelX < width; pixelX++) {
-        pixels[pixelX] = new DoubleVec3D[height];
-        for (int pixelY = 0; pixelY < height; pixelY++)
-            pixels[pixelX][pixelY] = 0.0;
-    }
+Picture::Picture(unsigned int width, unsigned int height, double renderTime /* = -1*/)
+    : width(width), height(height),
+      rowStride((3*width + DOUBLES_PER_CACHE_LINE - 1) / DOUBLES_PER_CACHE_LINE * DOUBLES_PER_CACHE_LINE),
+      renderTime(renderTime) {
+    // Allocate one more cache line so that the beginning can be aligned
+    pixelsMemory = new double[(size_t)rowStride*height + DOUBLES_PER_CACHE_LINE];
+    size_t misalignment = (size_t)pixelsMemory % CACHE_LINE_SIZE;
+    pixels = (misalignment == 0) ? pixelsMemory : (double*)((char*)pixelsMemory + CACHE_LINE_SIZE - misalignment);
+    std::fill(pixels, pixels + (size_t)rowStride*height, 0.0);
 }
 
-Picture::Picture(const Picture& picture) : Picture(picture.width, picture.height, picture.renderTime) {}
+Picture::Picture(const Picture& picture) : Picture(picture.width, picture.height, picture.renderTime) {
+    std::copy(picture.pixels, picture.pixels + (size_t)rowStride*height, pixels);
+}
 
 Picture::~Picture() {
-    for (int pixelX = 0; pixelX < width; pixelX++)
-        delete[] pixels[pixelX];
-    delete[] pixels;
+    delete[] pixelsMemory;
 }
 
 
@@ -26,44 +28,64 @@ unsigned int Picture::getWidth() const { return width; }
 unsigned int Picture::getHeight() const { return height; }
 double Picture::getRenderTime() const { return renderTime; }
 
-std::vector<std::vector<DoubleVec3D>> Picture::getPixels() const {
-    std::vector<std::vector<DoubleVec3D>> result;
-    for (int pixelX = 0; pixelX < width; pixelX++) {
-        std::vector<DoubleVec3D> column;
-        for (int pixelY = 0; pixelY < height; pixelY++) {
-            column.push_back(pixels[pixelX][pixelY]);
-        }
-        result.push_back(column);
-    }
-    return result;
+DoubleVec3D Picture::getValuePix(unsigned int x, unsigned int y) const {
+    const double* pixel = getPixelReference(x, y);
+    return DoubleVec3D(pixel[0], pixel[1], pixel[2]);
+}
+
+double* Picture::getPixelReference(unsigned int x, unsigned int y) const {  // private
+    return pixels + (size_t)y*rowStride + 3*x;
 }
 
 // Modify pixels
-void Picture::addValuePix(unsigned int x, unsigned int y, DoubleVec3D value) { pixels[x][y] += value; }
-void Picture::setValuePix(unsigned int x, unsigned int y, DoubleVec3D value) { pixels[x][y] = value; }
+void Picture::addValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value) {
+    double* pixel = getPixelReference(x, y);
+    pixel[0] += value.getX();
+    pixel[1] += value.getY();
+    pixel[2] += value.getZ();
+}
+
+void Picture::splatValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value) {
+    double* pixel = getPixelReference(x, y);
+    double valueX = value.getX(), valueY = value.getY(), valueZ = value.getZ();
+#pragma omp atomic
+    pixel[0] += valueX;
+#pragma omp atomic
+    pixel[1] += valueY;
+#pragma omp atomic
+    pixel[2] += valueZ;
+}
+
+void Picture::setValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value) {
+    double* pixel = getPixelReference(x, y);
+    pixel[0] = value.getX();
+    pixel[1] = value.getY();
+    pixel[2] = value.getZ();
+}
+
 void Picture::setRenderTime(double renderTime) { this->renderTime = renderTime; }
 
 // Other methods
-void Picture::export2File(double middleGrey, std::string fileName, unsigned int movingAverageSize /*= 0*/) const {
-    std::cout << std::endl << "Exporting the picture...";
+void Picture::export2File(double middleGrey, std::string fileName, unsigned int movingAverageSize /*= 0*/, bool verbose /*= true*/) const {
+    if (verbose)
+        std::cout << std::endl << "Exporting the picture...";
     double writingBeginningTime = getCurrentTimeSeconds();
 
-    std::vector<std::vector<DoubleVec3D>> pixelValues;
-    for (unsigned int pixelX = 0; pixelX < width; pixelX++) {
-        std::vector<DoubleVec3D> column;
-        for (unsigned int pixelY = 0; pixelY < height; pixelY++) {
-            column.push_back(toneMapping(pixels[pixelX][pixelY], middleGrey));
-        }
-        pixelValues.push_back(column);
+    std::vector<DoubleVec3D> pixelValues;  // Row-major
+    pixelValues.reserve((size_t)width*height);
+    for (unsigned int pixelY = 0; pixelY < height; pixelY++) {
+        for (unsigned int pixelX = 0; pixelX < width; pixelX++)
+            pixelValues.push_back(toneMapping(getValuePix(pixelX, pixelY), middleGrey));
     }
 
+    std::string temporaryFileName = fileName + ".temp.ppm";  // Several renders can export in the same directory at the same time
     std::ofstream file;
-    file.open("temp.ppm");
+    file.open(temporaryFileName);
     file << "P3" << std::endl << width << " " << height << " " << MAX_COLOUR_VALUE << std::endl;
-    // File needs first loop on y, then on x.
+    // File needs first loop on y, then on x, as pixelValues.
     for (unsigned int pixelY = 0; pixelY < height; pixelY++) {
         for (unsigned int pixelX = 0; pixelX < width; pixelX++) {
-            DoubleVec3D currentColour = getColourMovingAverage(pixelValues, pixelX, pixelY, movingAverageSize);
+            DoubleVec3D currentColour = getColourMovingAverage(pixelValues, width, height, pixelX, pixelY, movingAverageSize);
             file << (int)(currentColour.getX()) << " ";
             file << (int)(currentColour.getY()) << " ";
             file << (int)(currentColour.getZ()) << std::endl;
@@ -71,12 +93,25 @@ void Picture::export2File(double middleGrey, std::string fileName, unsigned int
     }
     file.close();
 
-    cimg_library::CImg<unsigned char> image("temp.ppm");
-    remove("temp.ppm");
+    cimg_library::CImg<unsigned char> image(temporaryFileName.c_str());
+    remove(temporaryFileName.c_str());
     image.save(fileName.c_str());
 
-    std::cout << "\rSuccessfully exported the picture to " << fileName << " in " << getCurrentTimeSeconds() - writingBeginningTime << " seconds!" << std::endl;
-    system((".\\" + fileName).c_str());
+    if (verbose) {
+        std::cout << "\rSuccessfully exported the picture to " << fileName << " in " << getCurrentTimeSeconds() - writingBeginningTime << " seconds!" << std::endl;
+#ifdef _WIN32
+        system((".\\" + fileName).c_str());  // Opens the picture
+#endif
+    }
+}
+
+void Picture::save2File(std::string fileName) const {
+    json jsonOutput = *this;
+
+    std::ofstream file;
+    file.open(fileName);
+    file << std::setw(4) << jsonOutput << std::endl;
+    file.close();
 }
 
 void Picture::printAll() const {
@@ -146,12 +181,7 @@ void Picture::modify() {
 
             std::cout << "Saving the picture...";
             double beginningTime = getCurrentTimeSeconds();
-            json jsonOutput = *this;
-
-            std::ofstream file;
-            file.open(fileName);
-            file << std::setw(4) << jsonOutput << std::endl;
-            file.close();
+            save2File(fileName);
 
             std::cout << "\rSuccessfully saved the picture to " << fileName << " in " << getCurrentTimeSeconds() - beginningTime << " seconds." << std::endl << std::endl;
             getStringFromUser("Press enter to continue.");
@@ -173,17 +203,14 @@ DoubleVec3D toneMapping(const DoubleVec3D& radiance, double middleGrey) {
     return DoubleVec3D(x, y, z);
 }
 
-DoubleVec3D getColourMovingAverage(const std::vector<std::vector<DoubleVec3D>>& pixelValues, unsigned int pixelX, unsigned int pixelY, unsigned int size) {
+DoubleVec3D getColourMovingAverage(const std::vector<DoubleVec3D>& pixelValues, unsigned int width, unsigned int height, unsigned int pixelX, unsigned int pixelY, unsigned int size) {
     if (size == 0)
-        return pixelValues[pixelX][pixelY];
+        return pixelValues[(size_t)pixelY*width + pixelX];
 
     int pixelXInt = (int)pixelX;
     int pixelYInt = (int)pixelY;
     int sizeInt = (int)size;
 
-    int width = pixelValues.size();
-    int height = pixelValues[0].size();
-
     // Decide not to change the picture size
     int minPixX = std::max(0, pixelXInt - sizeInt);
     int minPixY = std::max(0, pixelYInt - sizeInt);
@@ -193,9 +220,9 @@ DoubleVec3D getColourMovingAverage(const std::vector<std::vector<DoubleVec3D>>&
     DoubleVec3D result(0.0);
     unsigned int numberPixels = (maxPixX - minPixX + 1)*(maxPixY - minPixY + 1);  // not (2*size + 1)^2 because smaller if near an edge
 
-    for (unsigned int pixelX = minPixX; pixelX <= maxPixX; pixelX++) {
-        for (unsigned int pixelY = minPixY; pixelY <= maxPixY; pixelY++) {
-            result += pixelValues[pixelX][pixelY] / numberPixels;
+    for (unsigned int pixelY = minPixY; pixelY <= maxPixY; pixelY++) {
+        for (unsigned int pixelX = minPixX; pixelX <= maxPixX; pixelX++) {
+            result += pixelValues[(size_t)pixelY*width + pixelX] / numberPixels;
         }
     }
 
@@ -205,7 +232,16 @@ DoubleVec3D getColourMovingAverage(const std::vector<std::vector<DoubleVec3D>>&
 
 // json
 void to_json(json& j, const Picture& picture) {
-    j = { {"Width", picture.getWidth()}, {"Height", picture.getHeight()}, {"RenderTime", picture.getRenderTime()}, {"Pixels", picture.getPixels()} };
+    // Pixels are saved column by column, as in the previous versions
+    json pixels = json::array();
+    for (unsigned int pixelX = 0; pixelX < picture.getWidth(); pixelX++) {
+        json column = json::array();
+        for (unsigned int pixelY = 0; pixelY < picture.getHeight(); pixelY++)
+            column.push_back(picture.getValuePix(pixelX, pixelY));
+        pixels.push_back(column);
+    }
+
+    j = { {"Width", picture.getWidth()}, {"Height", picture.getHeight()}, {"RenderTime", picture.getRenderTime()}, {"Pixels", pixels} };
 }
 
 
@@ -213,13 +249,13 @@ Picture importPictureFromJson(const json& j) {
     unsigned int width = j["Width"].get<unsigned int>();
     unsigned int height = j["Height"].get<unsigned int>();
     double renderTime = j["RenderTime"].get<double>();
-    std::vector<std::vector<DoubleVec3D>> pixels = j["Pixels"].get<std::vector<std::vector<DoubleVec3D>>>();
+    const json& pixels = j["Pixels"];
     Picture result(width, height, renderTime);
     
-    for (int pixelX = 0; pixelX < width; pixelX++) {
-        std::vector<DoubleVec3D> column = pixels[pixelX];
-        for (int pixelY = 0; pixelY < height; pixelY++) {
-            result.setValuePix(pixelX, pixelY, column[pixelY]);
+    for (unsigned int pixelX = 0; pixelX < width; pixelX++) {
+        const json& column = pixels[pixelX];
+        for (unsigned int pixelY = 0; pixelY < height; pixelY++) {
+            result.setValuePix(pixelX, pixelY, column[pixelY].get<DoubleVec3D>());
         }
     }
 
@@ -14,11 +14,15 @@
 
     \class Picture
     \brief Stores radiance for every pixel.
+    \details The radiance is stored in a single row-major buffer of RGB doubles. Each row starts on a cache line, hence two threads writing different rows never write the same cache line.
 
     \var static constexpr unsigned int Picture::MAX_COLOUR_VALUE
     \brief The maximum value that will be used to write a colour in a file.
     \sa toneMapping()
 
+    \var static constexpr unsigned int Picture::CACHE_LINE_SIZE
+    \brief The size of a cache line in bytes. The buffer and each of its rows are aligned on it.
+
     \fn Picture::Picture()
     \brief Default constructor.
     \details By default, width and height are both set to 500.
@@ -49,17 +53,27 @@
     \brief Getter for the render time.
     \return The time it took to compute this picture.
 
-    \fn Picture::getPixels()
-    \brief Getter for the pixels.
-    \return A std::vector of std::vector that contains the radiance at each pixel.
+    \fn DoubleVec3D Picture::getValuePix(unsigned int x, unsigned int y)
+    \brief Getter for a pixel value.
+    \param x The *x* coordinate of the pixel.
+    \param y The *y* coordinate of the pixel.
+    \return The value of that pixel.
 
-    \fn void Picture::addValuePix(unsigned int x, unsigned int y, DoubleVec3D value)
+    \fn void Picture::addValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value)
     \brief Adds a value to a pixel.
     \param x The *x* coordinate of the pixel.
     \param y The *y* coordinate of the pixel.
     \param value The value that will be added to that pixel.
 
-    \fn void Picture::setValuePix(unsigned int x, unsigned int y, DoubleVec3D value)
+    \fn void Picture::splatValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value)
+    \brief Adds a value to a pixel. Can be called by several threads at the same time.
+    \details Used by light tracing, whose paths can reach any pixel.
+    \param x The *x* coordinate of the pixel.
+    \param y The *y* coordinate of the pixel.
+    \param value The value that will be added to that pixel.
+    \sa Picture::addValuePix()
+
+    \fn void Picture::setValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value)
     \brief Sets a pixel value.
     \param x The *x* coordinate of the pixel.
     \param y The *y* coordinate of the pixel.
@@ -70,14 +84,27 @@
     \details This method can be used if the time was not set when the picture was instanciated (which is very likely to happen).
     \param renderTime The new time this picture took to be computed.
 
-    \fn void Picture::export2File(double middleGrey, std::string fileName, unsigned int movingAverage = 0)
+    \fn void Picture::export2File(double middleGrey, std::string fileName, unsigned int movingAverage = 0, bool verbose = true)
     \brief Writes this as a picture file.
     \details Uses the CImg library.
     \param middleGrey The middle-grey value that will be used for the toneMapping() function.
     \param fileName The path to the file where we want to write this picture. If it is "-", it will give a very nice bugged result. This could be easily fixed, but it is very fun and purely nondestructive.
+
+    \fn double* Picture::getPixelReference(unsigned int x, unsigned int y)
+    \brief Gives the address of a pixel in the buffer.
+    \param x The *x* coordinate of the pixel.
+    \param y The *y* coordinate of the pixel.
+    \return A pointer to the red value of the pixel, followed by the green and blue ones.
     \param movingAverage The size of the moving average (see getColourMovingAverage()).
+    \param verbose If true, the progression is printed and the picture is opened once written (on Windows). If false, nothing is printed and nothing is opened.
+    \throw cimg_library::CImgException If the picture could not be written.
     \sa toneMapping(), getColourMovingAverage()
 
+    \fn void Picture::save2File(std::string fileName) const
+    \brief Saves this picture to a json file.
+    \param fileName The name of the file to which the picture will be saved. It is recommended that this file extension ends with PICTURE_SAVE_EXTENSION_JSON.
+    \sa importPictureFromJson(), formatFileName(), PICTURE_SAVE_EXTENSION_JSON
+
     \fn void Picture::printAll()
     \brief Prints the whole page.
     \details Clears the page, prints the header, information and the available commands.
@@ -96,9 +123,11 @@
     \return The colour that has been computed. Each part of the colour (red, green or blue) range from 0 to MAX_COLOUR_VALUE.
     \sa Picture::MAX_COLOUR_VALUE, Picture::export2File()
 
-    \fn DoubleVec3D getColourMovingAverage(const std::vector<std::vector<DoubleVec3D>>& pixelValues, unsigned int pixelX, unsigned int pixelY, unsigned int size)
+    \fn DoubleVec3D getColourMovingAverage(const std::vector<DoubleVec3D>& pixelValues, unsigned int width, unsigned int height, unsigned int pixelX, unsigned int pixelY, unsigned int size)
     \brief Computes the value of a pixel when having applied a moving average.
-    \param pixelValues The values of all pixels (can be radiance or colour value, depending whether you first use the toneMapping function or not).
+    \param pixelValues The values of all pixels, row by row (can be radiance or colour value, depending whether you first use the toneMapping function or not).
+    \param width The number of pixels in a row.
+    \param height The number of rows.
     \param pixelX The *x* coordinate of the pixel.
     \param pixelY the *y* coordinate of the pixel.
     \param size The size of the moving average.
@@ -121,11 +150,19 @@ class Picture {
 private:
     const unsigned int width;
     const unsigned int height;
+    const unsigned int rowStride;  // In doubles
     double renderTime;
-    DoubleVec3D** pixels;
+
+    double* pixelsMemory;  // What was allocated
+    double* pixels;  // Aligned on a cache line, row-major, 3 doubles (RGB) per pixel
+
+    static constexpr unsigned int DOUBLES_PER_CACHE_LINE = 8;
+
+    double* getPixelReference(unsigned int x, unsigned int y) const;
 
 public:
     static constexpr unsigned int MAX_COLOUR_VALUE = 255;
+    static constexpr unsigned int CACHE_LINE_SIZE = 64;
 
     Picture();
     Picture(unsigned int width, unsigned int height, double renderTime = -1);
@@ -135,19 +172,21 @@ public:
     unsigned int getWidth() const;
     unsigned int getHeight() const;
     double getRenderTime() const;
-    std::vector<std::vector<DoubleVec3D>> getPixels() const;
+    DoubleVec3D getValuePix(unsigned int x, unsigned int y) const;
 
-    void addValuePix(unsigned int x, unsigned int y, DoubleVec3D value);
-    void setValuePix(unsigned int x, unsigned int y, DoubleVec3D value);
+    void addValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value);
+    void splatValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value);
+    void setValuePix(unsigned int x, unsigned int y, const DoubleVec3D& value);
     void setRenderTime(double renderTime);
 
-    void export2File(double middleGrey, std::string fileName, unsigned int movingAverage = 0) const;
+    void export2File(double middleGrey, std::string fileName, unsigned int movingAverage = 0, bool verbose = true) const;
+    void save2File(std::string fileName) const;
     void printAll() const;
     void modify();
 };
 
 DoubleVec3D toneMapping(const DoubleVec3D& radiance, double middleGrey);
-DoubleVec3D getColourMovingAverage(const std::vector<std::vector<DoubleVec3D>>& pixelValues, unsigned int pixelX, unsigned int pixelY, unsigned int size);
+DoubleVec3D getColourMovingAverage(const std::vector<DoubleVec3D>& pixelValues, unsigned int width, unsigned int height, unsigned int pixelX, unsigned int pixelY, unsigned int size);
 
 void to_json(json& j, const Picture& picture);
 Picture importPictureFromJson(const json& j);
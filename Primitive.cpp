@@ -0,0 +1,20 @@
+#include "Primitive.h"
+
+// Constructors
+SpherePrimitive::SpherePrimitive(const Sphere& sphere)
+    : center(sphere.getCenter()), radius(sphere.getRadius()), object(const_cast<Sphere*>(&sphere)) {}
+
+TrianglePrimitive::TrianglePrimitive(const Triangle& triangle)
+    : vertex0(triangle.getVertex0()), edge1(triangle.getVertex1() - triangle.getVertex0()), edge2(triangle.getVertex2() - triangle.getVertex0()), object(const_cast<Triangle*>(&triangle)) {}
+
+
+// Function
+void splitIntoPrimitives(const std::vector<Object3D*>& objects, std::vector<SpherePrimitive>& spheres, std::vector<TrianglePrimitive>& triangles) {
+    for (Object3D* object : objects) {
+        const std::type_info& type = typeid(*object);
+        if (type == typeid(Sphere))
+            spheres.push_back(SpherePrimitive(*static_cast<Sphere*>(object)));
+        else if (type == typeid(Triangle))
+            triangles.push_back(TrianglePrimitive(*static_cast<Triangle*>(object)));
+    }
+}
@@ -0,0 +1,183 @@
+#ifndef DEF_PRIMITIVE
+#define DEF_PRIMITIVE
+
+#include <typeinfo>
+
+#include "RenderStatistics.h"
+#include "Sphere.h"
+#include "Triangle.h"
+
+/*!
+    \file Primitive.h
+    \brief Defines the SpherePrimitive and TrianglePrimitive structs, and the functions that intersect them.
+    \details Object3D stays the interface used to edit, import and save the objects. The acceleration structures and the integrator only intersect copies of them stored by value, one array per kind of primitive, so that the intersection code is known at compile time and can be inlined.
+
+    \struct SpherePrimitive
+    \brief A sphere stored by value, as it is intersected during the render.
+
+    \var DoubleVec3D SpherePrimitive::center
+    \brief The center of the sphere.
+
+    \var double SpherePrimitive::radius
+    \brief The radius of the sphere.
+
+    \var Object3D* SpherePrimitive::object
+    \brief The Sphere from which this primitive was made, given back by the intersections.
+
+    \fn SpherePrimitive::SpherePrimitive(const Sphere& sphere)
+    \brief Main constructor.
+    \param sphere The sphere that will be copied.
+
+    \fn double SpherePrimitive::smallestPositiveIntersection(const Ray& ray)
+    \brief Computes the smallest positive intersection between the ray and this sphere.
+    \param ray The ray.
+    \return The same as Sphere::smallestPositiveIntersection().
+
+    \struct TrianglePrimitive
+    \brief A triangle stored by value, as it is intersected during the render.
+    \details The edges are computed once, instead of at every intersection.
+
+    \var DoubleVec3D TrianglePrimitive::vertex0
+    \brief The first vertex of the triangle.
+
+    \var DoubleVec3D TrianglePrimitive::edge1
+    \brief The second vertex minus the first one.
+
+    \var DoubleVec3D TrianglePrimitive::edge2
+    \brief The third vertex minus the first one.
+
+    \var Object3D* TrianglePrimitive::object
+    \brief The Triangle from which this primitive was made, given back by the intersections.
+
+    \fn TrianglePrimitive::TrianglePrimitive(const Triangle& triangle)
+    \brief Main constructor.
+    \param triangle The triangle that will be copied.
+
+    \fn double TrianglePrimitive::smallestPositiveIntersection(const Ray& ray)
+    \brief Computes the smallest positive intersection between the ray and this triangle.
+    \param ray The ray.
+    \return The same as Triangle::smallestPositiveIntersection().
+
+    \fn double intersectSphere(const Ray& ray, const DoubleVec3D& center, double radius)
+    \brief Computes the smallest positive intersection between a ray and a sphere.
+    \details Shared by Sphere and SpherePrimitive, so that both always give the same result.
+    \param ray The ray.
+    \param center The center of the sphere.
+    \param radius The radius of the sphere.
+    \return The distance between the ray origin and the intersection (the smallest one if there is more than one intersection). Returns -1 if the ray does not intersect with the sphere.
+
+    \fn double intersectTriangle(const Ray& ray, const DoubleVec3D& vertex0, const DoubleVec3D& edge1, const DoubleVec3D& edge2)
+    \brief Computes the intersection between a ray and a triangle, with the Moller-Trumbore algorithm.
+    \details Shared by Triangle and TrianglePrimitive, so that both always give the same result.
+    \param ray The ray.
+    \param vertex0 The first vertex of the triangle.
+    \param edge1 The second vertex minus the first one.
+    \param edge2 The third vertex minus the first one.
+    \return The distance between the ray origin and the intersection. Returns -1 if the ray does not intersect with the triangle.
+
+    \fn void intersectPrimitives(const Ray& ray, const PrimitiveType* primitives, unsigned int primitiveNumber, double& smallestPositiveDistance, Object3D*& closestObject)
+    \brief Finds the closest intersection between a ray and a range of primitives of the same kind.
+    \details Only the intersections closer than the one given are kept, so that several ranges can be tested one after the other.
+    \tparam PrimitiveType SpherePrimitive or TrianglePrimitive.
+    \param ray The ray.
+    \param primitives The first primitive of the range.
+    \param primitiveNumber The number of primitives in the range.
+    \param smallestPositiveDistance The distance to the closest intersection found so far, updated if a closer one is found.
+    \param closestObject The object of the closest intersection found so far, updated if a closer one is found.
+
+    \fn void splitIntoPrimitives(const std::vector<Object3D*>& objects, std::vector<SpherePrimitive>& spheres, std::vector<TrianglePrimitive>& triangles)
+    \brief Makes the primitives of some objects, sorted by kind.
+    \param objects The objects, which must all be spheres or triangles.
+    \param spheres Receives the spheres, in the order of the objects.
+    \param triangles Receives the triangles, in the order of the objects.
+*/
+
+struct SpherePrimitive {
+    DoubleVec3D center;
+    double radius;
+    Object3D* object;
+
+    SpherePrimitive(const Sphere& sphere);
+
+    double smallestPositiveIntersection(const Ray& ray) const;
+};
+
+struct TrianglePrimitive {
+    DoubleVec3D vertex0;
+    DoubleVec3D edge1;
+    DoubleVec3D edge2;
+    Object3D* object;
+
+    TrianglePrimitive(const Triangle& triangle);
+
+    double smallestPositiveIntersection(const Ray& ray) const;
+};
+
+void splitIntoPrimitives(const std::vector<Object3D*>& objects, std::vector<SpherePrimitive>& spheres, std::vector<TrianglePrimitive>& triangles);
+
+
+// Defined here, so that they are inlined in the loops of the acceleration structures
+inline double intersectSphere(const Ray& ray, const DoubleVec3D& center, double radius) {
+    STATISTICS_INCREMENT(primitiveTests);
+    // Returns -1 if no solution
+    // Using quadratic equation formula to solve (meaning of a, b, c)
+    // a = dotProd(rayDir, rayDir) but = 1
+    DoubleVec3D differenceOriginCenter = ray.getOrigin() - center;
+    double b = 2 * dotProd(ray.getDirection(), differenceOriginCenter);
+    double c = dotProd(differenceOriginCenter, differenceOriginCenter) - radius * radius;
+
+    double discriminant = b*b - 4*c;
+    if (discriminant < 0.0)
+        return -1.0;
+    else if (discriminant == 0.0)
+        return -b/2;
+    else {
+        double sqrt_discriminant = sqrt(discriminant);
+        double twiceSolution1 = -b - sqrt_discriminant;
+        if (twiceSolution1 > 0.00002)  // Rays starting on the sphere and going inside would else only find their origin, which is discarded
+            return twiceSolution1/2; // smallest solution and is positive
+        else
+            return (-b + sqrt_discriminant)/2; // biggest solution but maybe positive
+    }
+}
+
+inline double intersectTriangle(const Ray& ray, const DoubleVec3D& vertex0, const DoubleVec3D& edge1, const DoubleVec3D& edge2) {
+    STATISTICS_INCREMENT(primitiveTests);
+    // Using Moller-Trumbore intersection algorithm (using notations from https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm (accessed on 3rd July 2020)
+    // Return -1 if no intersection
+    DoubleVec3D h = crossProd(ray.getDirection(), edge2);
+    double a = dotProd(edge1, h);
+    if (a > -DBL_EPSILON && a < DBL_EPSILON)
+        return -1;  // Triangle and ray are parallel
+    double f = 1.0 / a;
+    DoubleVec3D s = ray.getOrigin() - vertex0;
+    double barycentricCoordU = f * dotProd(s, h);
+    if (barycentricCoordU < 0.0 || barycentricCoordU > 1.0)  // conditions for barycentric coordinates
+        return -1;
+    DoubleVec3D q = crossProd(s, edge1);
+    double barycentricCoordV = f * dotProd(ray.getDirection(), q);
+    if (barycentricCoordV < 0.0 || barycentricCoordU + barycentricCoordV > 1.0)  // conditions for barycentric coordinates
+        return -1;
+    return f * dotProd(edge2, q);
+}
+
+inline double SpherePrimitive::smallestPositiveIntersection(const Ray& ray) const {
+    return intersectSphere(ray, center, radius);
+}
+
+inline double TrianglePrimitive::smallestPositiveIntersection(const Ray& ray) const {
+    return intersectTriangle(ray, vertex0, edge1, edge2);
+}
+
+template <class PrimitiveType>
+inline void intersectPrimitives(const Ray& ray, const PrimitiveType* primitives, unsigned int primitiveNumber, double& smallestPositiveDistance, Object3D*& closestObject) {
+    for (unsigned int primitiveIndex = 0; primitiveIndex < primitiveNumber; primitiveIndex++) {
+        double distance = primitives[primitiveIndex].smallestPositiveIntersection(ray);
+        if (distance > 0.00001 && distance < smallestPositiveDistance) {  // Has to be strictly positive -> we don't want it to intersect with same object
+            smallestPositiveDistance = distance;
+            closestObject = primitives[primitiveIndex].object;
+        }
+    }
+}
+
+#endif
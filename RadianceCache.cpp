@@ -0,0 +1,101 @@
+#include "RadianceCache.h"
+
+// Constructor and destructor
+RadianceCache::RadianceCache(double errorThreshold, unsigned int maxRecords, const DoubleVec3D& minPoint, const DoubleVec3D& maxPoint)
+    : errorThreshold(errorThreshold), maxRecords(maxRecords), minPoint(minPoint), numberRecords(0) {
+    DoubleVec3D size = maxPoint - minPoint;
+    double largestSide = std::max(size.getX(), std::max(size.getY(), size.getZ()));
+    cellSize = std::max(largestSide, 0.0001) / RADIANCE_CACHE_CELLS_PER_SIDE;
+
+    records = new Record[maxRecords];
+
+    numberBuckets = 1;
+    while (numberBuckets < maxRecords)
+        numberBuckets *= 2;
+    buckets = new std::atomic<int>[numberBuckets];
+    for (unsigned int bucket = 0; bucket < numberBuckets; bucket++)
+        buckets[bucket].store(-1);
+}
+
+RadianceCache::~RadianceCache() {
+    delete[] records;
+    delete[] buckets;
+}
+
+
+// Getters
+double RadianceCache::getErrorThreshold() const { return errorThreshold; }
+unsigned int RadianceCache::getMaxRecords() const { return maxRecords; }
+unsigned int RadianceCache::getNumberRecords() const { return std::min(numberRecords.load(), maxRecords); }  // Threads that failed to add a record still incremented it
+bool RadianceCache::isFull() const { return numberRecords.load() >= maxRecords; }
+
+
+// Private methods
+unsigned long long RadianceCache::getCellKey(int cellX, int cellY, int cellZ) const {
+    // 21 bits per coordinate is much more than RADIANCE_CACHE_CELLS_PER_SIDE
+    return ((unsigned long long)(cellX & 0x1FFFFF) << 42) | ((unsigned long long)(cellY & 0x1FFFFF) << 21) | (unsigned long long)(cellZ & 0x1FFFFF);
+}
+
+unsigned int RadianceCache::getBucket(unsigned long long cellKey) const {
+    unsigned int hash = hashCombine(hashUnsignedInt((unsigned int)cellKey), hashUnsignedInt((unsigned int)(cellKey >> 32)));
+    return hash & (numberBuckets - 1);
+}
+
+
+// Records
+bool RadianceCache::getRadiance(const DoubleVec3D& position, const DoubleUnitVec3D& normal, DoubleVec3D& radiance) const {
+    DoubleVec3D relativePosition = (position - minPoint) / cellSize;
+    int cellX = (int)std::floor(relativePosition.getX());
+    int cellY = (int)std::floor(relativePosition.getY());
+    int cellZ = (int)std::floor(relativePosition.getZ());
+
+    DoubleVec3D weightedRadiance(0.0);
+    double totalWeight = 0.0;
+    for (int x = cellX - 1; x <= cellX + 1; x++) {
+        for (int y = cellY - 1; y <= cellY + 1; y++) {
+            for (int z = cellZ - 1; z <= cellZ + 1; z++) {
+                unsigned long long cellKey = getCellKey(x, y, z);
+                for (int index = buckets[getBucket(cellKey)].load(); index != -1; index = records[index].next) {
+                    const Record& record = records[index];
+                    if (record.cellKey != cellKey)
+                        continue;
+
+                    double error = length(position - record.position) / record.radius + std::sqrt(std::max(0.0, 1.0 - dotProd(normal, record.normal)));
+                    if (error < errorThreshold) {
+                        double weight = 1.0 / std::max(error, 0.000001) - 1.0 / errorThreshold;
+                        weightedRadiance += weight * record.radiance;
+                        totalWeight += weight;
+                    }
+                }
+            }
+        }
+    }
+
+    if (totalWeight <= 0.0)
+        return false;
+    radiance = weightedRadiance / totalWeight;
+    return true;
+}
+
+bool RadianceCache::addRecord(const DoubleVec3D& position, const DoubleUnitVec3D& normal, const DoubleVec3D& radiance, double harmonicMeanDistance) {
+    unsigned int index = numberRecords.fetch_add(1);
+    if (index >= maxRecords)
+        return false;
+
+    DoubleVec3D relativePosition = (position - minPoint) / cellSize;
+    Record& record = records[index];
+    record.position = position;
+    record.normal = normal;
+    record.radiance = radiance;
+    // The record is used up to errorThreshold*radius from its position, which must stay in the neighbouring cells
+    record.radius = std::min(std::max(harmonicMeanDistance, RADIANCE_CACHE_MIN_RADIUS*cellSize / errorThreshold), cellSize / errorThreshold);
+    record.cellKey = getCellKey((int)std::floor(relativePosition.getX()), (int)std::floor(relativePosition.getY()), (int)std::floor(relativePosition.getZ()));
+
+    // The record is completely written before other threads can see it
+    std::atomic<int>& bucket = buckets[getBucket(record.cellKey)];
+    int head = bucket.load();
+    do {
+        record.next = head;
+    } while (!bucket.compare_exchange_weak(head, (int)index));
+    return true;
+}
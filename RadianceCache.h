@@ -0,0 +1,152 @@
+#ifndef DEF_RADIANCECACHE
+#define DEF_RADIANCECACHE
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "DoubleUnitVec3D.h"
+#include "Sampler.h"
+
+/*!
+    \file RadianceCache.h
+    \brief Defines the RadianceCache class.
+
+    \var constexpr unsigned int RADIANCE_CACHE_CELLS_PER_SIDE
+    \brief Number of cells of the spatial hash along the largest side of the scene.
+
+    \var constexpr unsigned int RADIANCE_CACHE_RECORD_SAMPLES
+    \brief Number of paths traced to compute a record.
+
+    \var constexpr double RADIANCE_CACHE_MIN_RADIUS
+    \brief Smallest radius in which a record can be used, relative to the size of a cell. Records computed in corners would be useless else.
+
+    \class RadianceCache
+    \brief Stores the indirect radiance arriving on diffuse surfaces, so that it can be interpolated instead of being computed again.
+    \details This is an irradiance cache in the style of Ward. A record is valid at a point if Ward's error |p - p_i|/R_i + sqrt(1 - n.n_i) is smaller than the error threshold, where R_i is the harmonic mean distance to the objects seen from the record. The records are stored in a spatial hash whose cells are at least as big as the radius in which a record is valid, so that only the 27 cells around a point need to be looked at.
+    Records are added by all the threads during the render without any lock: a record is written first, and then pushed at the head of its bucket with an atomic compare-and-swap. Hence, a thread that reads a bucket only sees records that are completely written.
+
+    \struct RadianceCache::Record
+    \brief A radiance value computed at a point.
+
+    \var DoubleVec3D RadianceCache::Record::position
+    \brief The point at which the radiance was computed.
+
+    \var DoubleUnitVec3D RadianceCache::Record::normal
+    \brief The normal of the surface at this point.
+
+    \var DoubleVec3D RadianceCache::Record::radiance
+    \brief The mean radiance arriving at this point, weighted by the cosine.
+
+    \var double RadianceCache::Record::radius
+    \brief The harmonic mean distance to the objects seen from this point.
+
+    \var unsigned long long RadianceCache::Record::cellKey
+    \brief The key of the cell containing the point, since several cells can share the same bucket.
+
+    \var int RadianceCache::Record::next
+    \brief The index of the next record of the same bucket, -1 if there is none.
+
+    \fn RadianceCache::RadianceCache(double errorThreshold, unsigned int maxRecords, const DoubleVec3D& minPoint, const DoubleVec3D& maxPoint)
+    \brief Main constructor.
+    \details The memory for all the records is allocated at once, so that adding a record never moves the other ones.
+    \param errorThreshold The largest error with which a record can be used. Smaller values give a more accurate picture, but need more records.
+    \param maxRecords The maximum number of records. Once it is reached, no more records are added.
+    \param minPoint The minimum point of a cuboid containing all the objects.
+    \param maxPoint The maximum point of a cuboid containing all the objects.
+    \sa getMinPoint(std::vector<Object3D*> objects), getMaxPoint(std::vector<Object3D*> objects)
+
+    \fn RadianceCache::~RadianceCache()
+    \brief Destructor.
+
+    \fn double RadianceCache::getErrorThreshold()
+    \brief Getter for the error threshold.
+    \return The largest error with which a record can be used.
+
+    \fn unsigned int RadianceCache::getMaxRecords()
+    \brief Getter for the maximum number of records.
+    \return The maximum number of records.
+
+    \fn unsigned int RadianceCache::getNumberRecords()
+    \brief Getter for the number of records.
+    \return The number of records stored in the cache.
+
+    \fn bool RadianceCache::isFull()
+    \brief Checks if the cache is full.
+    \return True if no more record can be added, false else.
+
+    \fn bool RadianceCache::getRadiance(const DoubleVec3D& position, const DoubleUnitVec3D& normal, DoubleVec3D& radiance)
+    \brief Interpolates the radiance at a point.
+    \details The records are weighted by 1/error - 1/errorThreshold, so that the picture does not have any discontinuity where a record stops being used.
+    \param position The point.
+    \param normal The normal of the surface at the point.
+    \param radiance Filled with the interpolated radiance if some records can be used.
+    \return True if some records can be used, false else.
+
+    \fn bool RadianceCache::addRecord(const DoubleVec3D& position, const DoubleUnitVec3D& normal, const DoubleVec3D& radiance, double harmonicMeanDistance)
+    \brief Adds a record.
+    \param position The point at which the radiance was computed.
+    \param normal The normal of the surface at this point.
+    \param radiance The mean radiance arriving at this point, weighted by the cosine.
+    \param harmonicMeanDistance The harmonic mean distance to the objects seen from this point. It is clamped so that the record is valid in a radius between RADIANCE_CACHE_MIN_RADIUS and 1 cell.
+    \return True if the record was added, false if the cache is full.
+
+    \fn unsigned long long RadianceCache::getCellKey(int cellX, int cellY, int cellZ)
+    \brief Packs the coordinates of a cell into a key.
+    \param cellX The *x* coordinate of the cell.
+    \param cellY The *y* coordinate of the cell.
+    \param cellZ The *z* coordinate of the cell.
+    \return The key of the cell.
+
+    \fn unsigned int RadianceCache::getBucket(unsigned long long cellKey)
+    \brief Computes the bucket in which the records of a cell are stored.
+    \param cellKey The key of the cell.
+    \return The index of the bucket.
+*/
+
+constexpr unsigned int RADIANCE_CACHE_CELLS_PER_SIDE = 16;
+constexpr unsigned int RADIANCE_CACHE_RECORD_SAMPLES = 64;
+constexpr double RADIANCE_CACHE_MIN_RADIUS = 0.1;
+
+class RadianceCache {
+public:
+    struct Record {
+        DoubleVec3D position;
+        DoubleUnitVec3D normal;
+        DoubleVec3D radiance;
+        double radius = 0.0;
+        unsigned long long cellKey = 0;
+        int next = -1;
+    };
+
+private:
+    double errorThreshold;
+    unsigned int maxRecords;
+    DoubleVec3D minPoint;
+    double cellSize;
+
+    Record* records;
+    std::atomic<unsigned int> numberRecords;
+    std::atomic<int>* buckets;
+    unsigned int numberBuckets;  // A power of 2
+
+    unsigned long long getCellKey(int cellX, int cellY, int cellZ) const;
+    unsigned int getBucket(unsigned long long cellKey) const;
+
+public:
+    RadianceCache(double errorThreshold, unsigned int maxRecords, const DoubleVec3D& minPoint, const DoubleVec3D& maxPoint);
+    RadianceCache(const RadianceCache& cache) = delete;
+    ~RadianceCache();
+
+    double getErrorThreshold() const;
+    unsigned int getMaxRecords() const;
+    unsigned int getNumberRecords() const;
+    bool isFull() const;
+
+    bool getRadiance(const DoubleVec3D& position, const DoubleUnitVec3D& normal, DoubleVec3D& radiance) const;
+    bool addRecord(const DoubleVec3D& position, const DoubleUnitVec3D& normal, const DoubleVec3D& radiance, double harmonicMeanDistance);
+
+    RadianceCache& operator=(const RadianceCache& cache) = delete;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include "RayPacket.h"
+
+// Constructor
+RayPacket::RayPacket() {}
+
+
+// Getters
+unsigned int RayPacket::getSize() const { return size; }
+const Ray& RayPacket::getRay(unsigned int index) const { return rays[index]; }
+unsigned int RayPacket::getAllRaysMask() const { return (1u << size) - 1; }
+
+
+// Methods
+void RayPacket::addRay(const Ray& ray) {
+    rays[size] = ray;
+
+    DoubleVec3D origin = ray.getOrigin();
+    DoubleUnitVec3D direction = ray.getDirection();
+    originsX[size] = origin.getX();
+    originsY[size] = origin.getY();
+    originsZ[size] = origin.getZ();
+
+    // A huge finite value instead of an infinite one, so that a ray lying on a plane of a box never gives NaN
+    inverseDirectionsX[size] = 1.0 / ((std::abs(direction.getX()) > DBL_EPSILON) ? direction.getX() : std::copysign(DBL_EPSILON, direction.getX()));
+    inverseDirectionsY[size] = 1.0 / ((std::abs(direction.getY()) > DBL_EPSILON) ? direction.getY() : std::copysign(DBL_EPSILON, direction.getY()));
+    inverseDirectionsZ[size] = 1.0 / ((std::abs(direction.getZ()) > DBL_EPSILON) ? direction.getZ() : std::copysign(DBL_EPSILON, direction.getZ()));
+    size++;
+}
+
+unsigned int RayPacket::intersectBox(const DoubleVec3D& minCoord, const DoubleVec3D& maxCoord, unsigned int activeRays, const double* maxDistances) const {
+    double minX = minCoord.getX(), minY = minCoord.getY(), minZ = minCoord.getZ();
+    double maxX = maxCoord.getX(), maxY = maxCoord.getY(), maxZ = maxCoord.getZ();
+
+    // Every ray is tested, without any branch, so that this loop is vectorised
+    bool hits[RAY_PACKET_MAX_SIZE];
+    for (unsigned int ray = 0; ray < size; ray++) {
+        double distanceMinX = (minX - originsX[ray])*inverseDirectionsX[ray];
+        double distanceMaxX = (maxX - originsX[ray])*inverseDirectionsX[ray];
+        double distanceMinY = (minY - originsY[ray])*inverseDirectionsY[ray];
+        double distanceMaxY = (maxY - originsY[ray])*inverseDirectionsY[ray];
+        double distanceMinZ = (minZ - originsZ[ray])*inverseDirectionsZ[ray];
+        double distanceMaxZ = (maxZ - originsZ[ray])*inverseDirectionsZ[ray];
+
+        double entryDistance = std::max(std::max(std::min(distanceMinX, distanceMaxX), std::min(distanceMinY, distanceMaxY)), std::min(distanceMinZ, distanceMaxZ));
+        double exitDistance = std::min(std::min(std::max(distanceMinX, distanceMaxX), std::max(distanceMinY, distanceMaxY)), std::max(distanceMinZ, distanceMaxZ));
+        hits[ray] = (entryDistance <= exitDistance) & (exitDistance > 0.00001) & (entryDistance <= maxDistances[ray]);
+    }
+
+    unsigned int result = 0;
+    for (unsigned int ray = 0; ray < size; ray++)
+        result |= (unsigned int)hits[ray] << ray;
+    return result & activeRays;
+}
@@ -0,0 +1,78 @@
+#ifndef DEF_RAYPACKET
+#define DEF_RAYPACKET
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "Ray.h"
+
+/*!
+    \file RayPacket.h
+    \brief Defines the RayPacket class.
+
+    \var constexpr unsigned int RAY_PACKET_MAX_SIZE
+    \brief Maximum number of rays in a packet. The active rays are stored as bits of an unsigned int, so it must stay smaller than 32.
+
+    \class RayPacket
+    \brief A group of coherent rays that go through the k-d tree together.
+    \details The origins and the inverses of the directions are also stored as one array per coordinate, so that a box is tested against every ray of the packet in the same loop, which the compiler can vectorise. The rays that take part in a test are given as a mask, where the bit i stands for the ray i.
+    \sa KDTreeNode::getPacketIntersections(), PerspectiveCamera::getRayPacketGoingThrough()
+
+    \fn RayPacket::RayPacket()
+    \brief Default constructor. The packet is empty.
+
+    \fn unsigned int RayPacket::getSize()
+    \brief Getter for the number of rays.
+    \return The number of rays in the packet.
+
+    \fn const Ray& RayPacket::getRay(unsigned int index)
+    \brief Getter for a ray.
+    \param index The index of the ray, smaller than RayPacket::getSize().
+    \return The ray.
+
+    \fn unsigned int RayPacket::getAllRaysMask()
+    \brief Gives the mask in which every ray of the packet is active.
+    \return An unsigned int whose RayPacket::getSize() first bits are 1.
+
+    \fn void RayPacket::addRay(const Ray& ray)
+    \brief Adds a ray at the end of the packet.
+    \param ray The ray.
+    \warning The packet must contain less than RAY_PACKET_MAX_SIZE rays.
+
+    \fn unsigned int RayPacket::intersectBox(const DoubleVec3D& minCoord, const DoubleVec3D& maxCoord, unsigned int activeRays, const double* maxDistances)
+    \brief Tests which rays go through a cuboid before a given distance.
+    \details Every ray is tested with the slab method, then the results are masked. This is cheaper than branching on each ray, as long as most of them are active.
+    \param minCoord The minimum coordinate of the cuboid.
+    \param maxCoord The maximum coordinate of the cuboid.
+    \param activeRays The mask of the rays that are tested.
+    \param maxDistances For every ray, the distance after which the cuboid does not interest it any more.
+    \return The mask of the active rays that enter the cuboid before their maximum distance, and leave it after their origin.
+*/
+
+constexpr unsigned int RAY_PACKET_MAX_SIZE = 16;
+
+class RayPacket {
+private:
+    unsigned int size = 0;
+    Ray rays[RAY_PACKET_MAX_SIZE];
+
+    double originsX[RAY_PACKET_MAX_SIZE];
+    double originsY[RAY_PACKET_MAX_SIZE];
+    double originsZ[RAY_PACKET_MAX_SIZE];
+    double inverseDirectionsX[RAY_PACKET_MAX_SIZE];
+    double inverseDirectionsY[RAY_PACKET_MAX_SIZE];
+    double inverseDirectionsZ[RAY_PACKET_MAX_SIZE];
+
+public:
+    RayPacket();
+
+    unsigned int getSize() const;
+    const Ray& getRay(unsigned int index) const;
+    unsigned int getAllRaysMask() const;
+
+    void addRay(const Ray& ray);
+    unsigned int intersectBox(const DoubleVec3D& minCoord, const DoubleVec3D& maxCoord, unsigned int activeRays, const double* maxDistances) const;
+};
+
+#endif
@@ -19,6 +19,10 @@ Material* RefractiveMaterial::deepCopy() const {
     return new RefractiveMaterial(refractiveIndex, getEmittance());
 }
 
+Material* RefractiveMaterial::deepCopy(MemoryArena& arena) const {
+    return new (arena) RefractiveMaterial(refractiveIndex, getEmittance());
+}
+
 DoubleUnitVec3D RefractiveMaterial::getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) const {
     DoubleUnitVec3D normalBis = normal;  // Must be modified
     DoubleUnitVec3D previousRayDirection = previousRay.getDirection();
@@ -59,6 +63,10 @@ DoubleVec3D RefractiveMaterial::computeCurrentRadiance(const DoubleVec3D& recurs
 }
 
 
+double RefractiveMaterial::getDirectionPdf(const Ray&, const DoubleUnitVec3D&, const DoubleUnitVec3D&) const {
+    return 0.0;
+}
+
 bool RefractiveMaterial::worksWithNextEventEstimation() const {
     return false;
 }
@@ -0,0 +1,149 @@
+#include "RenderStatistics.h"
+
+// RayCounters
+RayCounters& RayCounters::operator+=(const RayCounters& counters) {
+    primaryRays += counters.primaryRays;
+    secondaryRays += counters.secondaryRays;
+    shadowRays += counters.shadowRays;
+    return *this;
+}
+
+unsigned long long RayCounters::getTotalRays() const {
+    return primaryRays + secondaryRays + shadowRays;
+}
+
+
+// DetailedCounters
+#ifdef PATHTRACER_STATISTICS
+void DetailedCounters::addPathLength(unsigned int length) {
+    pathLengths[std::min(length, PATH_LENGTH_HISTOGRAM_SIZE - 1)]++;
+}
+
+DetailedCounters& DetailedCounters::operator+=(const DetailedCounters& counters) {
+    nodeVisits += counters.nodeVisits;
+    boxTests += counters.boxTests;
+    primitiveTests += counters.primitiveTests;
+    hits += counters.hits;
+    russianRouletteTerminations += counters.russianRouletteTerminations;
+    zeroThroughputTerminations += counters.zeroThroughputTerminations;
+    occludedShadowRays += counters.occludedShadowRays;
+    unoccludedShadowRays += counters.unoccludedShadowRays;
+    radianceCacheQueries += counters.radianceCacheQueries;
+    radianceCacheHits += counters.radianceCacheHits;
+    for (unsigned int length = 0; length < PATH_LENGTH_HISTOGRAM_SIZE; length++)
+        pathLengths[length] += counters.pathLengths[length];
+    return *this;
+}
+#endif
+
+
+// RenderStatistics
+std::vector<RenderStatistics::PaddedCounters>& RenderStatistics::getAllThreadCounters() {
+    static std::vector<PaddedCounters> allThreadCounters(1);  // Function-local so that it exists before any static scene
+    return allThreadCounters;
+}
+
+void RenderStatistics::reset(unsigned int numberThreads) {
+    std::vector<PaddedCounters>& allThreadCounters = getAllThreadCounters();
+    allThreadCounters.assign(std::max(numberThreads, 1u), PaddedCounters());
+}
+
+RayCounters& RenderStatistics::getThreadCounters() {
+    return getAllThreadCounters()[omp_get_thread_num()].counters;
+}
+
+RayCounters RenderStatistics::getTotal() {
+    RayCounters result;
+    for (const PaddedCounters& threadCounters : getAllThreadCounters())
+        result += threadCounters.counters;
+    return result;
+}
+
+#ifdef PATHTRACER_STATISTICS
+DetailedCounters& RenderStatistics::getThreadDetailedCounters() {
+    return getAllThreadCounters()[omp_get_thread_num()].detailedCounters;
+}
+
+DetailedCounters RenderStatistics::getDetailedTotal() {
+    DetailedCounters result;
+    for (const PaddedCounters& threadCounters : getAllThreadCounters())
+        result += threadCounters.detailedCounters;
+    return result;
+}
+#endif
+
+json RenderStatistics::getTotalJson() {
+    json result = { {"Rays", getTotal()} };
+#ifdef PATHTRACER_STATISTICS
+    result["Traversal"] = getDetailedTotal();
+#endif
+    return result;
+}
+
+void RenderStatistics::printTotal(double renderTime) {
+    RayCounters rayCounters = getTotal();
+    std::cout << "Statistics" << std::endl << DASH_SPLITTER << std::endl;
+    std::cout << "Rays = " << rayCounters.getTotalRays() << " (" << rayCounters.getTotalRays() / renderTime << " per second)" << std::endl;
+    std::cout << "Primary rays = " << rayCounters.primaryRays << std::endl;
+    std::cout << "Secondary rays = " << rayCounters.secondaryRays << std::endl;
+    std::cout << "Shadow rays = " << rayCounters.shadowRays << std::endl;
+
+#ifdef PATHTRACER_STATISTICS
+    DetailedCounters detailedCounters = getDetailedTotal();
+    unsigned long long tracedRays = rayCounters.getTotalRays();
+    std::cout << "Occluded shadow rays = " << detailedCounters.occludedShadowRays << std::endl;
+    std::cout << "Unoccluded shadow rays = " << detailedCounters.unoccludedShadowRays << std::endl;
+    std::cout << "Hits = " << detailedCounters.hits << std::endl;
+    std::cout << "K-d tree node visits = " << detailedCounters.nodeVisits << " (" << (double)detailedCounters.nodeVisits / tracedRays << " per ray)" << std::endl;
+    std::cout << "Box tests = " << detailedCounters.boxTests << " (" << (double)detailedCounters.boxTests / tracedRays << " per ray)" << std::endl;
+    std::cout << "Primitive tests = " << detailedCounters.primitiveTests << " (" << (double)detailedCounters.primitiveTests / tracedRays << " per ray)" << std::endl;
+    std::cout << "Russian roulette terminations = " << detailedCounters.russianRouletteTerminations << std::endl;
+    std::cout << "Zero throughput terminations = " << detailedCounters.zeroThroughputTerminations << std::endl;
+    std::cout << "Radiance cache queries = " << detailedCounters.radianceCacheQueries << " (" << detailedCounters.radianceCacheHits << " hits)" << std::endl;
+    std::cout << "Path lengths (number of bounces: number of paths) =";
+    for (unsigned int length = 0; length < DetailedCounters::PATH_LENGTH_HISTOGRAM_SIZE; length++) {
+        if (detailedCounters.pathLengths[length] != 0)
+            std::cout << " " << length << (length == DetailedCounters::PATH_LENGTH_HISTOGRAM_SIZE - 1 ? "+" : "") << ": " << detailedCounters.pathLengths[length];
+    }
+    std::cout << std::endl;
+#endif
+    std::cout << std::endl;
+}
+
+void RenderStatistics::saveTotal2File(std::string fileName) {
+    json jsonOutput = getTotalJson();
+
+    std::ofstream file;
+    file.open(fileName);
+    file << std::setw(4) << jsonOutput << std::endl;
+    file.close();
+}
+
+
+// json
+void to_json(json& j, const RayCounters& counters) {
+    j = {
+        {"PrimaryRays", counters.primaryRays},
+        {"SecondaryRays", counters.secondaryRays},
+        {"ShadowRays", counters.shadowRays},
+        {"TotalRays", counters.getTotalRays()}
+    };
+}
+
+#ifdef PATHTRACER_STATISTICS
+void to_json(json& j, const DetailedCounters& counters) {
+    j = {
+        {"NodeVisits", counters.nodeVisits},
+        {"BoxTests", counters.boxTests},
+        {"PrimitiveTests", counters.primitiveTests},
+        {"Hits", counters.hits},
+        {"RussianRouletteTerminations", counters.russianRouletteTerminations},
+        {"ZeroThroughputTerminations", counters.zeroThroughputTerminations},
+        {"OccludedShadowRays", counters.occludedShadowRays},
+        {"UnoccludedShadowRays", counters.unoccludedShadowRays},
+        {"RadianceCacheQueries", counters.radianceCacheQueries},
+        {"RadianceCacheHits", counters.radianceCacheHits},
+        {"PathLengths", std::vector<unsigned long long>(counters.pathLengths, counters.pathLengths + DetailedCounters::PATH_LENGTH_HISTOGRAM_SIZE)}
+    };
+}
+#endif
@@ -0,0 +1,216 @@
+#ifndef DEF_RENDERSTATISTICS
+#define DEF_RENDERSTATISTICS
+
+#include <algorithm>
+#include <iomanip>
+#include <omp.h>
+#include <vector>
+
+#include "InterfaceGestion.h"
+
+// Define PATHTRACER_STATISTICS (for example with /D PATHTRACER_STATISTICS) to count what happens during the traversal.
+// Else, the STATISTICS_* macros expand to nothing and the detailed counters do not exist.
+// #define PATHTRACER_STATISTICS
+
+#ifdef PATHTRACER_STATISTICS
+#define STATISTICS_INCREMENT(counter) (RenderStatistics::getThreadDetailedCounters().counter++)
+#define STATISTICS_PATH_LENGTH(length) (RenderStatistics::getThreadDetailedCounters().addPathLength(length))
+#else
+#define STATISTICS_INCREMENT(counter) ((void)0)
+#define STATISTICS_PATH_LENGTH(length) ((void)0)
+#endif
+
+/*!
+    \file RenderStatistics.h
+    \brief Defines the RayCounters and DetailedCounters structs, the RenderStatistics class and the macros used to count.
+    \details The rays are always counted. The detailed counters only exist if PATHTRACER_STATISTICS is defined, so that they cost nothing otherwise.
+
+    \def STATISTICS_INCREMENT(counter)
+    \brief Adds one to a detailed counter of the calling thread, if PATHTRACER_STATISTICS is defined.
+
+    \def STATISTICS_PATH_LENGTH(length)
+    \brief Adds a path to the path length histogram of the calling thread, if PATHTRACER_STATISTICS is defined.
+
+    \struct RayCounters
+    \brief Numbers of rays traced during a render.
+
+    \var unsigned long long RayCounters::primaryRays
+    \brief Rays going from the camera through a pixel.
+
+    \var unsigned long long RayCounters::secondaryRays
+    \brief Rays that were traced after a bounce.
+
+    \var unsigned long long RayCounters::shadowRays
+    \brief Rays going towards a lamp, used by the next event estimation algorithm.
+
+    \fn RayCounters& RayCounters::operator+=(const RayCounters& counters)
+    \brief Adds other counters to these ones.
+    \param counters The counters that will be added.
+    \return A reference to these counters.
+
+    \fn unsigned long long RayCounters::getTotalRays()
+    \brief Computes the total number of rays.
+    \return The sum of the primary, secondary and shadow rays.
+
+    \struct DetailedCounters
+    \brief What happened during the traversal of the scene.
+    \details Only exists if PATHTRACER_STATISTICS is defined.
+
+    \var static constexpr unsigned int DetailedCounters::PATH_LENGTH_HISTOGRAM_SIZE
+    \brief Number of bars of the path length histogram. The last one counts all the longer paths.
+
+    \var unsigned long long DetailedCounters::nodeVisits
+    \brief Number of times a k-d tree node was visited.
+
+    \var unsigned long long DetailedCounters::boxTests
+    \brief Number of intersection tests between a ray and the box of a k-d tree node.
+
+    \var unsigned long long DetailedCounters::primitiveTests
+    \brief Number of intersection tests between a ray and a sphere or a triangle.
+
+    \var unsigned long long DetailedCounters::hits
+    \brief Number of primary and secondary rays that hit an object.
+
+    \var unsigned long long DetailedCounters::russianRouletteTerminations
+    \brief Number of paths stopped by the russian roulette.
+
+    \var unsigned long long DetailedCounters::zeroThroughputTerminations
+    \brief Number of paths stopped because nothing could come back from them.
+
+    \var unsigned long long DetailedCounters::occludedShadowRays
+    \brief Number of shadow rays that did not reach their lamp.
+
+    \var unsigned long long DetailedCounters::unoccludedShadowRays
+    \brief Number of shadow rays that reached their lamp.
+
+    \var unsigned long long DetailedCounters::radianceCacheQueries
+    \brief Number of times the radiance cache was asked for the radiance at a point.
+
+    \var unsigned long long DetailedCounters::radianceCacheHits
+    \brief Number of queries to the radiance cache that could be answered by interpolating records. The other ones computed a new record.
+
+    \var unsigned long long DetailedCounters::pathLengths
+    \brief Histogram of the number of bounces of the paths.
+
+    \fn void DetailedCounters::addPathLength(unsigned int length)
+    \brief Adds a path to the histogram.
+    \param length The number of bounces of the path.
+
+    \fn DetailedCounters& DetailedCounters::operator+=(const DetailedCounters& counters)
+    \brief Adds other counters to these ones.
+    \param counters The counters that will be added.
+    \return A reference to these counters.
+
+    \class RenderStatistics
+    \brief Stores one set of counters per thread.
+    \details Each thread only writes its own counters, which are separated by a cache line. Hence, counting does not need any lock nor atomic operation. The counters are merged at the end of the render with RenderStatistics::getTotal().
+
+    \fn static void RenderStatistics::reset(unsigned int numberThreads)
+    \brief Sets all the counters to 0.
+    \warning Must not be called while a render is running.
+    \param numberThreads The number of threads that will count.
+
+    \fn static RayCounters& RenderStatistics::getThreadCounters()
+    \brief Gives the ray counters of the calling thread.
+    \return A reference to the ray counters of the calling thread.
+
+    \fn static DetailedCounters& RenderStatistics::getThreadDetailedCounters()
+    \brief Gives the detailed counters of the calling thread.
+    \details Only exists if PATHTRACER_STATISTICS is defined. Use the STATISTICS_* macros instead.
+    \return A reference to the detailed counters of the calling thread.
+
+    \fn static RayCounters RenderStatistics::getTotal()
+    \brief Merges the ray counters of all threads.
+    \return The sum of the ray counters of every thread.
+
+    \fn static DetailedCounters RenderStatistics::getDetailedTotal()
+    \brief Merges the detailed counters of all threads.
+    \details Only exists if PATHTRACER_STATISTICS is defined.
+    \return The sum of the detailed counters of every thread.
+
+    \fn static json RenderStatistics::getTotalJson()
+    \brief Merges the counters of all threads and converts them to json.
+    \return The ray counters, and the detailed counters if PATHTRACER_STATISTICS is defined.
+
+    \fn static void RenderStatistics::printTotal(double renderTime)
+    \brief Prints the merged counters.
+    \param renderTime The time the render took, in seconds, to compute the number of rays per second.
+
+    \fn static void RenderStatistics::saveTotal2File(std::string fileName)
+    \brief Saves the merged counters to a json file.
+    \param fileName The name of the file. It is recommended that this file extension ends with STATISTICS_SAVE_EXTENSION.
+    \sa RenderStatistics::getTotalJson()
+
+    \fn void to_json(json& j, const RayCounters& counters)
+    \brief Converts ray counters to json.
+    \param j Json output.
+    \param counters The counters that will be converted.
+
+    \fn void to_json(json& j, const DetailedCounters& counters)
+    \brief Converts detailed counters to json.
+    \param j Json output.
+    \param counters The counters that will be converted.
+*/
+
+struct RayCounters {
+    unsigned long long primaryRays = 0;
+    unsigned long long secondaryRays = 0;
+    unsigned long long shadowRays = 0;
+
+    RayCounters& operator+=(const RayCounters& counters);
+    unsigned long long getTotalRays() const;
+};
+
+#ifdef PATHTRACER_STATISTICS
+struct DetailedCounters {
+    static constexpr unsigned int PATH_LENGTH_HISTOGRAM_SIZE = 32;
+
+    unsigned long long nodeVisits = 0;
+    unsigned long long boxTests = 0;
+    unsigned long long primitiveTests = 0;
+    unsigned long long hits = 0;
+    unsigned long long russianRouletteTerminations = 0;
+    unsigned long long zeroThroughputTerminations = 0;
+    unsigned long long occludedShadowRays = 0;
+    unsigned long long unoccludedShadowRays = 0;
+    unsigned long long radianceCacheQueries = 0;
+    unsigned long long radianceCacheHits = 0;
+    unsigned long long pathLengths[PATH_LENGTH_HISTOGRAM_SIZE] = {};
+
+    void addPathLength(unsigned int length);
+    DetailedCounters& operator+=(const DetailedCounters& counters);
+};
+#endif
+
+class RenderStatistics {
+private:
+    struct PaddedCounters {
+        RayCounters counters;
+#ifdef PATHTRACER_STATISTICS
+        DetailedCounters detailedCounters;
+#endif
+        char padding[64];  // A cache line, so that two threads never write the same one
+    };
+
+    static std::vector<PaddedCounters>& getAllThreadCounters();
+
+public:
+    static void reset(unsigned int numberThreads);
+    static RayCounters& getThreadCounters();
+    static RayCounters getTotal();
+#ifdef PATHTRACER_STATISTICS
+    static DetailedCounters& getThreadDetailedCounters();
+    static DetailedCounters getDetailedTotal();
+#endif
+
+    static json getTotalJson();
+    static void printTotal(double renderTime);
+    static void saveTotal2File(std::string fileName);
+};
+
+void to_json(json& j, const RayCounters& counters);
+#ifdef PATHTRACER_STATISTICS
+void to_json(json& j, const DetailedCounters& counters);
+#endif
+
+#endif
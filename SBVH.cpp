@@ -0,0 +1,366 @@
+#include "SBVH.h"
+
+// Box struct
+SBVH::Box::Box() {
+    for (unsigned int basis = 0; basis < 3; basis++) {
+        minCoord[basis] = INFINITY;
+        maxCoord[basis] = -INFINITY;
+    }
+}
+
+bool SBVH::Box::isEmpty() const {
+    return minCoord[0] > maxCoord[0] || minCoord[1] > maxCoord[1] || minCoord[2] > maxCoord[2];
+}
+
+double SBVH::Box::getArea() const {
+    if (isEmpty())
+        return 0.0;
+    double sizeX = maxCoord[0] - minCoord[0];
+    double sizeY = maxCoord[1] - minCoord[1];
+    double sizeZ = maxCoord[2] - minCoord[2];
+    return 2*(sizeX*sizeY + sizeY*sizeZ + sizeZ*sizeX);
+}
+
+void SBVH::Box::grow(const double* point) {
+    for (unsigned int basis = 0; basis < 3; basis++) {
+        minCoord[basis] = std::min(minCoord[basis], point[basis]);
+        maxCoord[basis] = std::max(maxCoord[basis], point[basis]);
+    }
+}
+
+void SBVH::Box::grow(const Box& box) {
+    for (unsigned int basis = 0; basis < 3; basis++) {
+        minCoord[basis] = std::min(minCoord[basis], box.minCoord[basis]);
+        maxCoord[basis] = std::max(maxCoord[basis], box.maxCoord[basis]);
+    }
+}
+
+void SBVH::Box::intersect(const Box& box) {
+    for (unsigned int basis = 0; basis < 3; basis++) {
+        minCoord[basis] = std::max(minCoord[basis], box.minCoord[basis]);
+        maxCoord[basis] = std::min(maxCoord[basis], box.maxCoord[basis]);
+    }
+}
+
+
+// Constructor
+SBVH::SBVH(const std::vector<Object3D*>& objects, double alpha)
+    : alpha(alpha) {
+    std::vector<Reference> references;
+    Box rootBox;
+    for (Object3D* object : objects) {
+        DoubleVec3D minCoord = object->getMinCoord();
+        DoubleVec3D maxCoord = object->getMaxCoord();
+        Reference reference;
+        reference.object = object;
+        reference.box.minCoord[0] = minCoord.getX();
+        reference.box.minCoord[1] = minCoord.getY();
+        reference.box.minCoord[2] = minCoord.getZ();
+        reference.box.maxCoord[0] = maxCoord.getX();
+        reference.box.maxCoord[1] = maxCoord.getY();
+        reference.box.maxCoord[2] = maxCoord.getZ();
+        rootBox.grow(reference.box);
+        references.push_back(reference);
+    }
+    rootArea = rootBox.getArea();
+    buildNode(references, rootBox, 0);
+    duplicatedReferences = spheres.size() + triangles.size() - objects.size();
+
+    // Expected cost of a ray going through the root, the probability of going through a node being proportional to its area
+    for (const Node& node : nodes) {
+        double relativeArea = (rootArea > 0.0) ? node.box.getArea() / rootArea : 1.0;
+        if (node.secondChild != 0)
+            sahCost += SBVH_TRAVERSAL_COST * relativeArea;
+        else
+            sahCost += SBVH_INTERSECTION_COST * (node.sphereNumber + node.triangleNumber) * relativeArea;
+    }
+}
+
+
+// Getters
+unsigned int SBVH::getNodeNumber() const { return nodes.size(); }
+unsigned int SBVH::getDuplicatedReferences() const { return duplicatedReferences; }
+double SBVH::getSAHCost() const { return sahCost; }
+
+
+// Methods
+KDTreeNode::Intersection SBVH::getIntersection(const Ray& ray) const {
+    DoubleVec3D rayOrigin = ray.getOrigin();
+    DoubleUnitVec3D rayDirection = ray.getDirection();
+    double origin[3] = {rayOrigin.getX(), rayOrigin.getY(), rayOrigin.getZ()};
+    double direction[3] = {rayDirection.getX(), rayDirection.getY(), rayDirection.getZ()};
+    double inverseDirection[3];
+    for (unsigned int basis = 0; basis < 3; basis++)  // Never infinite, as in RayPacket
+        inverseDirection[basis] = 1.0 / ((std::abs(direction[basis]) > DBL_EPSILON) ? direction[basis] : std::copysign(DBL_EPSILON, direction[basis]));
+
+    double smallestPositiveDistance = INFINITY;
+    Object3D* closestObject = nullptr;
+
+    // At most one node is waiting per level
+    unsigned int stack[SBVH_MAX_DEPTH + 1];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Node& node = nodes[stack[--stackSize]];
+        STATISTICS_INCREMENT(boxTests);
+        double entryDistance = -INFINITY;
+        double exitDistance = INFINITY;
+        for (unsigned int basis = 0; basis < 3; basis++) {
+            double distanceMin = (node.box.minCoord[basis] - origin[basis])*inverseDirection[basis];
+            double distanceMax = (node.box.maxCoord[basis] - origin[basis])*inverseDirection[basis];
+            entryDistance = std::max(entryDistance, std::min(distanceMin, distanceMax));
+            exitDistance = std::min(exitDistance, std::max(distanceMin, distanceMax));
+        }
+        if (entryDistance > exitDistance || exitDistance <= 0.00001 || entryDistance > smallestPositiveDistance)
+            continue;
+        STATISTICS_INCREMENT(nodeVisits);
+
+        if (node.secondChild == 0) {
+            intersectPrimitives(ray, spheres.data() + node.firstSphere, node.sphereNumber, smallestPositiveDistance, closestObject);
+            intersectPrimitives(ray, triangles.data() + node.firstTriangle, node.triangleNumber, smallestPositiveDistance, closestObject);
+        }
+        else {
+            // The closest child is pushed last, so that it is visited first
+            unsigned int firstChild = (unsigned int)(&node - nodes.data()) + 1;
+            if (direction[node.basis] >= 0.0) {
+                stack[stackSize++] = node.secondChild;
+                stack[stackSize++] = firstChild;
+            }
+            else {
+                stack[stackSize++] = firstChild;
+                stack[stackSize++] = node.secondChild;
+            }
+        }
+    }
+    return KDTreeNode::Intersection(closestObject, smallestPositiveDistance);
+}
+
+unsigned int SBVH::buildNode(std::vector<Reference>& references, const Box& box, unsigned int depth) {  // private
+    unsigned int nodeIndex = nodes.size();
+    nodes.push_back(Node());
+    nodes[nodeIndex].box = box;
+
+    unsigned int referenceNumber = references.size();
+    double boxArea = box.getArea();
+    double leafCost = SBVH_INTERSECTION_COST * referenceNumber;
+
+    // Look for the best split
+    unsigned int objectBasis = 0;
+    unsigned int objectLeftNumber = 0;
+    Box objectLeftBox, objectRightBox;
+    double objectCost = INFINITY;
+    double spatialCost = INFINITY;
+    unsigned int spatialBasis = 0;
+    double spatialPosition = 0.0;
+    if (referenceNumber > 1 && depth < SBVH_MAX_DEPTH && boxArea > 0.0) {
+        objectCost = findObjectSplit(references, boxArea, objectBasis, objectLeftNumber, objectLeftBox, objectRightBox);
+
+        // Spatial splits duplicate references, so they are only looked for where the object split is bad
+        Box overlap = objectLeftBox;
+        overlap.intersect(objectRightBox);
+        if (overlap.getArea() > alpha * rootArea)
+            spatialCost = findSpatialSplit(references, box, spatialBasis, spatialPosition);
+    }
+
+    double splitCost = std::min(objectCost, spatialCost);
+    if (splitCost == INFINITY || (splitCost >= leafCost && referenceNumber <= SBVH_MAX_LEAF_SIZE)) {
+        // Leaf
+        std::vector<Object3D*> objects;
+        for (const Reference& reference : references)
+            objects.push_back(reference.object);
+        nodes[nodeIndex].firstSphere = spheres.size();
+        nodes[nodeIndex].firstTriangle = triangles.size();
+        splitIntoPrimitives(objects, spheres, triangles);
+        nodes[nodeIndex].sphereNumber = spheres.size() - nodes[nodeIndex].firstSphere;
+        nodes[nodeIndex].triangleNumber = triangles.size() - nodes[nodeIndex].firstTriangle;
+        references.clear();
+        return nodeIndex;
+    }
+
+    // Split the references
+    std::vector<Reference> leftReferences;
+    std::vector<Reference> rightReferences;
+    Box leftBox, rightBox;
+    unsigned int basis = objectBasis;
+    if (spatialCost < objectCost) {
+        basis = spatialBasis;
+        for (const Reference& reference : references) {
+            if (reference.box.maxCoord[basis] <= spatialPosition)
+                leftReferences.push_back(reference);
+            else if (reference.box.minCoord[basis] >= spatialPosition)
+                rightReferences.push_back(reference);
+            else {
+                Reference left, right;
+                splitReference(reference, basis, spatialPosition, left, right);
+                if (!left.box.isEmpty())
+                    leftReferences.push_back(left);
+                if (!right.box.isEmpty())
+                    rightReferences.push_back(right);
+            }
+        }
+        for (const Reference& reference : leftReferences)
+            leftBox.grow(reference.box);
+        for (const Reference& reference : rightReferences)
+            rightBox.grow(reference.box);
+    }
+    if (leftReferences.empty() || rightReferences.empty()) {  // Object split, or a spatial split that clipping made useless
+        basis = objectBasis;
+        leftReferences.assign(references.begin(), references.begin() + objectLeftNumber);
+        rightReferences.assign(references.begin() + objectLeftNumber, references.end());
+        leftBox = objectLeftBox;
+        rightBox = objectRightBox;
+    }
+    references.clear();
+    references.shrink_to_fit();  // The children can hold many more references
+
+    nodes[nodeIndex].basis = basis;
+    buildNode(leftReferences, leftBox, depth + 1);
+    unsigned int secondChild = buildNode(rightReferences, rightBox, depth + 1);
+    nodes[nodeIndex].secondChild = secondChild;  // Not through a reference, as the vector grew
+    return nodeIndex;
+}
+
+double SBVH::findObjectSplit(std::vector<Reference>& references, double boxArea, unsigned int& basis, unsigned int& leftNumber, Box& leftBox, Box& rightBox) const {  // private
+    unsigned int referenceNumber = references.size();
+    double bestCost = INFINITY;
+    std::vector<double> rightAreas(referenceNumber);
+    for (unsigned int currentBasis = 0; currentBasis < 3; currentBasis++) {
+        std::sort(references.begin(), references.end(), [currentBasis](const Reference& a, const Reference& b) {
+            return a.box.minCoord[currentBasis] + a.box.maxCoord[currentBasis] < b.box.minCoord[currentBasis] + b.box.maxCoord[currentBasis];
+        });
+
+        // Sweep from the right, then from the left
+        Box currentRightBox;
+        for (unsigned int index = referenceNumber - 1; index > 0; index--) {
+            currentRightBox.grow(references[index].box);
+            rightAreas[index] = currentRightBox.getArea();
+        }
+        Box currentLeftBox;
+        for (unsigned int index = 1; index < referenceNumber; index++) {
+            currentLeftBox.grow(references[index - 1].box);
+            double cost = SBVH_TRAVERSAL_COST + SBVH_INTERSECTION_COST * (currentLeftBox.getArea()*index + rightAreas[index]*(referenceNumber - index)) / boxArea;
+            if (cost < bestCost) {
+                bestCost = cost;
+                basis = currentBasis;
+                leftNumber = index;
+            }
+        }
+    }
+
+    // Sort along the chosen basis again, and compute its boxes
+    std::sort(references.begin(), references.end(), [basis](const Reference& a, const Reference& b) {
+        return a.box.minCoord[basis] + a.box.maxCoord[basis] < b.box.minCoord[basis] + b.box.maxCoord[basis];
+    });
+    leftBox = Box();
+    rightBox = Box();
+    for (unsigned int index = 0; index < referenceNumber; index++) {
+        if (index < leftNumber)
+            leftBox.grow(references[index].box);
+        else
+            rightBox.grow(references[index].box);
+    }
+    return bestCost;
+}
+
+double SBVH::findSpatialSplit(const std::vector<Reference>& references, const Box& box, unsigned int& basis, double& position) const {  // private
+    double boxArea = box.getArea();
+    double bestCost = INFINITY;
+    for (unsigned int currentBasis = 0; currentBasis < 3; currentBasis++) {
+        double binWidth = (box.maxCoord[currentBasis] - box.minCoord[currentBasis]) / SBVH_SPATIAL_BINS;
+        if (binWidth <= 0.0)
+            continue;
+
+        // Every reference is clipped into all the bins it crosses
+        Box binBoxes[SBVH_SPATIAL_BINS];
+        unsigned int entries[SBVH_SPATIAL_BINS] = {0};
+        unsigned int exits[SBVH_SPATIAL_BINS] = {0};
+        for (const Reference& reference : references) {
+            int firstBin = (int)((reference.box.minCoord[currentBasis] - box.minCoord[currentBasis]) / binWidth);
+            int lastBin = (int)((reference.box.maxCoord[currentBasis] - box.minCoord[currentBasis]) / binWidth);
+            firstBin = std::max(0, std::min(firstBin, (int)SBVH_SPATIAL_BINS - 1));
+            lastBin = std::max(firstBin, std::min(lastBin, (int)SBVH_SPATIAL_BINS - 1));
+
+            Reference current = reference;
+            for (int bin = firstBin; bin < lastBin; bin++) {
+                Reference left, right;
+                splitReference(current, currentBasis, box.minCoord[currentBasis] + binWidth*(bin + 1), left, right);
+                binBoxes[bin].grow(left.box);
+                current = right;
+            }
+            binBoxes[lastBin].grow(current.box);
+            entries[firstBin]++;
+            exits[lastBin]++;
+        }
+
+        // Sweep the planes between the bins
+        double rightAreas[SBVH_SPATIAL_BINS];
+        unsigned int rightNumbers[SBVH_SPATIAL_BINS];
+        Box currentRightBox;
+        unsigned int currentRightNumber = 0;
+        for (unsigned int bin = SBVH_SPATIAL_BINS - 1; bin > 0; bin--) {
+            currentRightBox.grow(binBoxes[bin]);
+            currentRightNumber += exits[bin];
+            rightAreas[bin] = currentRightBox.getArea();
+            rightNumbers[bin] = currentRightNumber;
+        }
+        Box currentLeftBox;
+        unsigned int currentLeftNumber = 0;
+        for (unsigned int plane = 1; plane < SBVH_SPATIAL_BINS; plane++) {
+            currentLeftBox.grow(binBoxes[plane - 1]);
+            currentLeftNumber += entries[plane - 1];
+            if (currentLeftNumber == 0 || rightNumbers[plane] == 0)
+                continue;
+            double cost = SBVH_TRAVERSAL_COST + SBVH_INTERSECTION_COST * (currentLeftBox.getArea()*currentLeftNumber + rightAreas[plane]*rightNumbers[plane]) / boxArea;
+            if (cost < bestCost) {
+                bestCost = cost;
+                basis = currentBasis;
+                position = box.minCoord[currentBasis] + binWidth*plane;
+            }
+        }
+    }
+    return bestCost;
+}
+
+void SBVH::splitReference(const Reference& reference, unsigned int basis, double position, Reference& left, Reference& right) const {  // private
+    left.object = reference.object;
+    right.object = reference.object;
+    left.box = Box();
+    right.box = Box();
+
+    if (typeid(*reference.object) == typeid(Triangle)) {
+        const Triangle* triangle = static_cast<const Triangle*>(reference.object);
+        DoubleVec3D vertices[3] = {triangle->getVertex0(), triangle->getVertex1(), triangle->getVertex2()};
+        for (unsigned int edge = 0; edge < 3; edge++) {
+            const DoubleVec3D& start = vertices[edge];
+            const DoubleVec3D& end = vertices[(edge + 1) % 3];
+            double startPoint[3] = {start.getX(), start.getY(), start.getZ()};
+            double endPoint[3] = {end.getX(), end.getY(), end.getZ()};
+
+            if (startPoint[basis] <= position)
+                left.box.grow(startPoint);
+            if (startPoint[basis] >= position)
+                right.box.grow(startPoint);
+
+            // The intersection of the edge with the plane is on both sides
+            if ((startPoint[basis] < position && position < endPoint[basis]) || (endPoint[basis] < position && position < startPoint[basis])) {
+                double t = (position - startPoint[basis]) / (endPoint[basis] - startPoint[basis]);
+                double intersectionPoint[3];
+                for (unsigned int currentBasis = 0; currentBasis < 3; currentBasis++)
+                    intersectionPoint[currentBasis] = startPoint[currentBasis] + (endPoint[currentBasis] - startPoint[currentBasis])*t;
+                intersectionPoint[basis] = position;
+                left.box.grow(intersectionPoint);
+                right.box.grow(intersectionPoint);
+            }
+        }
+    }
+    else {
+        left.box = reference.box;
+        right.box = reference.box;
+    }
+
+    // The reference may already have been clipped by the parents
+    left.box.maxCoord[basis] = std::min(left.box.maxCoord[basis], position);
+    right.box.minCoord[basis] = std::max(right.box.minCoord[basis], position);
+    left.box.intersect(reference.box);
+    right.box.intersect(reference.box);
+}
@@ -0,0 +1,211 @@
+#ifndef DEF_SBVH
+#define DEF_SBVH
+
+#include "KDTreeNode.h"
+
+/*!
+    \file SBVH.h
+    \brief Defines the SBVH class.
+
+    \var constexpr unsigned int SBVH_MAX_DEPTH
+    \brief Depth after which the nodes of an SBVH are always leaves. It bounds the traversal stack.
+
+    \var constexpr unsigned int SBVH_MAX_LEAF_SIZE
+    \brief Number of references above which a node is always split, even if the surface area heuristic prefers a leaf.
+
+    \var constexpr unsigned int SBVH_SPATIAL_BINS
+    \brief Number of bins in which the node is cut along each basis to look for a spatial split.
+
+    \var constexpr double SBVH_TRAVERSAL_COST
+    \brief Cost of visiting a node, for the surface area heuristic.
+
+    \var constexpr double SBVH_INTERSECTION_COST
+    \brief Cost of intersecting a primitive, for the surface area heuristic.
+
+    \class SBVH
+    \brief A bounding volume hierarchy with spatial splits (Martin Stich et al. "Spatial Splits in Bounding Volume Hierarchies" (2009)).
+    \details Every node is cut where the surface area heuristic is the lowest, either by sorting its objects into two groups (object split), or by cutting its volume with a plane and clipping the objects that cross it (spatial split). The clipped objects are referenced by both children, so spatial splits are only looked for when the two groups of the best object split overlap by more than alpha times the surface of the root. This keeps the duplicated references of the k-d tree for the few huge objects, such as the floors and walls of imported buildings, that would else make the nodes overlap.
+    The nodes are stored contiguously, the first child of a node being the next node. The leaves hold ranges of SpherePrimitive and TrianglePrimitive.
+    \sa Scene::getSBVH()
+
+    \struct SBVH::Box
+    \brief An axis-aligned box, whose coordinates can be accessed by basis.
+
+    \var double SBVH::Box::minCoord[3]
+    \brief The minimum coordinates.
+
+    \var double SBVH::Box::maxCoord[3]
+    \brief The maximum coordinates.
+
+    \fn SBVH::Box::Box()
+    \brief Default constructor. The box is empty.
+
+    \fn bool SBVH::Box::isEmpty()
+    \brief Returns whether the box contains no point.
+    \return True if a minimum coordinate is greater than the maximum one.
+
+    \fn double SBVH::Box::getArea()
+    \brief Computes the surface area of the box.
+    \return The surface area, 0 if the box is empty.
+
+    \fn void SBVH::Box::grow(const double* point)
+    \brief Grows the box so that it contains a point.
+    \param point The three coordinates of the point.
+
+    \fn void SBVH::Box::grow(const SBVH::Box& box)
+    \brief Grows the box so that it contains another box.
+    \param box The other box.
+
+    \fn void SBVH::Box::intersect(const SBVH::Box& box)
+    \brief Shrinks the box to its intersection with another box.
+    \param box The other box.
+
+    \struct SBVH::Node
+    \brief A node of the hierarchy.
+
+    \var SBVH::Box SBVH::Node::box
+    \brief The volume containing everything in the node.
+
+    \var unsigned int SBVH::Node::secondChild
+    \brief The index of the second child, 0 for leaves. The first child is the next node.
+
+    \var unsigned int SBVH::Node::basis
+    \brief The basis along which the node was cut, which decides the order in which the children are visited.
+
+    \var unsigned int SBVH::Node::firstSphere
+    \brief The index of the first sphere of the leaf in SBVH::spheres.
+
+    \var unsigned int SBVH::Node::sphereNumber
+    \brief The number of spheres of the leaf.
+
+    \var unsigned int SBVH::Node::firstTriangle
+    \brief The index of the first triangle of the leaf in SBVH::triangles.
+
+    \var unsigned int SBVH::Node::triangleNumber
+    \brief The number of triangles of the leaf.
+
+    \struct SBVH::Reference
+    \brief An object during the construction, with the part of its bounding box that is in the current node.
+
+    \fn SBVH::SBVH(const std::vector<Object3D*>& objects, double alpha)
+    \brief Main constructor. Builds the hierarchy.
+    \param objects The objects, which must all be spheres or triangles.
+    \param alpha The largest overlap between the groups of an object split, relative to the surface of the root, below which no spatial split is looked for. 0 looks for them everywhere, 1 never does.
+
+    \fn unsigned int SBVH::getNodeNumber()
+    \brief Getter for the number of nodes.
+    \return The number of nodes.
+
+    \fn unsigned int SBVH::getDuplicatedReferences()
+    \brief Getter for the number of references added by the spatial splits.
+    \return The number of references in the leaves minus the number of objects.
+
+    \fn double SBVH::getSAHCost()
+    \brief Getter for the cost of the hierarchy with the surface area heuristic.
+    \details It is the expected cost of a ray going through the root, with SBVH_TRAVERSAL_COST per node and SBVH_INTERSECTION_COST per primitive.
+    \return The cost of the hierarchy.
+
+    \fn KDTreeNode::Intersection SBVH::getIntersection(const Ray& ray)
+    \brief Computes the closest intersection of a ray, going through the hierarchy with a stack.
+    \param ray The ray.
+    \return The intersection. Its k-d tree node is always nullptr.
+
+    \fn unsigned int SBVH::buildNode(std::vector<SBVH::Reference>& references, const SBVH::Box& box, unsigned int depth)
+    \brief Recursively builds a node and its children.
+    \param references The references in the node. It is emptied.
+    \param box The box containing the references.
+    \param depth The depth of the node.
+    \return The index of the node.
+
+    \fn double SBVH::findObjectSplit(std::vector<SBVH::Reference>& references, double boxArea, unsigned int& basis, unsigned int& leftNumber, SBVH::Box& leftBox, SBVH::Box& rightBox)
+    \brief Finds the object split with the lowest cost, by sweeping the references sorted by their center along every basis.
+    \param references The references, sorted along the chosen basis when the function returns.
+    \param boxArea The surface area of the node.
+    \param basis Set to the basis of the split.
+    \param leftNumber Set to the number of references that go to the first child, the first ones of the sorted vector.
+    \param leftBox Set to the box of the first child.
+    \param rightBox Set to the box of the second child.
+    \return The cost of the split.
+
+    \fn double SBVH::findSpatialSplit(const std::vector<SBVH::Reference>& references, const SBVH::Box& box, unsigned int& basis, double& position)
+    \brief Finds the spatial split with the lowest cost among the planes between SBVH_SPATIAL_BINS bins along every basis.
+    \param references The references.
+    \param box The box of the node.
+    \param basis Set to the basis of the split.
+    \param position Set to the coordinate of the plane along the basis.
+    \return The cost of the split, INFINITY if there is none.
+
+    \fn void SBVH::splitReference(const SBVH::Reference& reference, unsigned int basis, double position, SBVH::Reference& left, SBVH::Reference& right)
+    \brief Clips a reference on both sides of a plane.
+    \details For a triangle, the boxes are made of the vertices and of the intersections of the edges with the plane, so that they are tight. For a sphere, the box is simply cut.
+    \param reference The reference.
+    \param basis The basis orthogonal to the plane.
+    \param position The coordinate of the plane along the basis.
+    \param left Set to the part of the reference below the plane. Its box may be empty.
+    \param right Set to the part of the reference above the plane. Its box may be empty.
+*/
+
+constexpr unsigned int SBVH_MAX_DEPTH = 64;
+constexpr unsigned int SBVH_MAX_LEAF_SIZE = 8;
+constexpr unsigned int SBVH_SPATIAL_BINS = 32;
+constexpr double SBVH_TRAVERSAL_COST = 1.0;
+constexpr double SBVH_INTERSECTION_COST = 1.0;
+
+class SBVH {
+public:
+    struct Box {
+        double minCoord[3];
+        double maxCoord[3];
+
+        Box();
+
+        bool isEmpty() const;
+        double getArea() const;
+        void grow(const double* point);
+        void grow(const Box& box);
+        void intersect(const Box& box);
+    };
+
+    struct Node {
+        Box box;
+        unsigned int secondChild = 0;
+        unsigned int basis = 0;
+        unsigned int firstSphere = 0;
+        unsigned int sphereNumber = 0;
+        unsigned int firstTriangle = 0;
+        unsigned int triangleNumber = 0;
+    };
+
+private:
+    struct Reference {
+        Object3D* object;
+        Box box;
+    };
+
+    double alpha;
+    double rootArea = 0.0;
+    std::vector<Node> nodes;
+    std::vector<SpherePrimitive> spheres;
+    std::vector<TrianglePrimitive> triangles;
+    unsigned int duplicatedReferences = 0;
+    double sahCost = 0.0;
+
+    unsigned int buildNode(std::vector<Reference>& references, const Box& box, unsigned int depth);
+    double findObjectSplit(std::vector<Reference>& references, double boxArea, unsigned int& basis, unsigned int& leftNumber, Box& leftBox, Box& rightBox) const;
+    double findSpatialSplit(const std::vector<Reference>& references, const Box& box, unsigned int& basis, double& position) const;
+    void splitReference(const Reference& reference, unsigned int basis, double position, Reference& left, Reference& right) const;
+
+public:
+    SBVH(const std::vector<Object3D*>& objects, double alpha);
+    SBVH(const SBVH& sbvh) = delete;
+
+    unsigned int getNodeNumber() const;
+    unsigned int getDuplicatedReferences() const;
+    double getSAHCost() const;
+
+    KDTreeNode::Intersection getIntersection(const Ray& ray) const;
+
+    SBVH& operator=(const SBVH& sbvh) = delete;
+};
+
+#endif
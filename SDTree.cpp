@@ -0,0 +1,86 @@
+#include "SDTree.h"
+
+// Constructor and destructor
+SDTree::SDTree(const DoubleVec3D& minPoint, const DoubleVec3D& maxPoint)
+    : minPoint(minPoint), maxPoint(maxPoint), nodes(1) {
+    nodes[0].directionalTree = new DirectionalQuadTree();
+}
+
+SDTree::~SDTree() {
+    for (SpatialNode& node : nodes)
+        delete node.directionalTree;
+}
+
+
+// Getters and setters
+bool SDTree::getTraining() const { return training; }
+unsigned int SDTree::getNumberPasses() const { return numberPasses; }
+
+unsigned int SDTree::getNumberSpatialLeaves() const {
+    unsigned int result = 0;
+    for (const SpatialNode& node : nodes) {
+        if (node.directionalTree != nullptr)
+            result++;
+    }
+    return result;
+}
+
+void SDTree::setTraining(bool training) { this->training = training; }
+
+
+// Methods
+DirectionalQuadTree* SDTree::getDirectionalTree(const DoubleVec3D& point) const {
+    double minCoords[3] = { minPoint.getX(), minPoint.getY(), minPoint.getZ() };
+    double maxCoords[3] = { maxPoint.getX(), maxPoint.getY(), maxPoint.getZ() };
+    double pointCoords[3] = { point.getX(), point.getY(), point.getZ() };
+
+    unsigned int node = 0;
+    while (nodes[node].directionalTree == nullptr) {
+        unsigned int axis = nodes[node].axis;
+        double middle = (minCoords[axis] + maxCoords[axis]) / 2.0;
+        if (pointCoords[axis] < middle) {
+            maxCoords[axis] = middle;
+            node = nodes[node].children[0];
+        }
+        else {
+            minCoords[axis] = middle;
+            node = nodes[node].children[1];
+        }
+    }
+    return nodes[node].directionalTree;
+}
+
+void SDTree::learn() {
+    double threshold = SD_TREE_SPATIAL_THRESHOLD * std::sqrt(std::pow(2.0, numberPasses));
+
+    // New leaves are added at the end, so that they are split again if they still have too many samples
+    for (unsigned int node = 0; node < nodes.size(); node++) {
+        DirectionalQuadTree* directionalTree = nodes[node].directionalTree;
+        if (directionalTree == nullptr || directionalTree->getNumberSamples() <= threshold)
+            continue;
+
+        directionalTree->setNumberSamples(directionalTree->getNumberSamples() / 2);
+        unsigned int childAxis = (nodes[node].axis + 1) % 3;
+        for (unsigned int child = 0; child < 2; child++) {
+            SpatialNode childNode;
+            childNode.axis = childAxis;
+            childNode.directionalTree = new DirectionalQuadTree(*directionalTree);
+            nodes[node].children[child] = nodes.size();
+            nodes.push_back(childNode);  // nodes[node] cannot be kept as a reference
+        }
+        delete directionalTree;
+        nodes[node].directionalTree = nullptr;
+    }
+
+    for (SpatialNode& node : nodes) {
+        if (node.directionalTree != nullptr)
+            node.directionalTree->learn();
+    }
+    numberPasses++;
+}
+
+
+// Other function
+double mixGuidingPdf(double materialPdf, double guidingPdf) {
+    return (1.0 - SD_TREE_GUIDING_FRACTION)*materialPdf + SD_TREE_GUIDING_FRACTION*guidingPdf;
+}
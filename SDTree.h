@@ -0,0 +1,117 @@
+#ifndef DEF_SDTREE
+#define DEF_SDTREE
+
+#include <cmath>
+#include <vector>
+
+#include "DirectionalQuadTree.h"
+
+/*!
+    \file SDTree.h
+    \brief Defines the SDTree class and some functions around it.
+
+    \var constexpr double SD_TREE_SPATIAL_THRESHOLD
+    \brief A region of the SD-tree is split once it received more than SD_TREE_SPATIAL_THRESHOLD*sqrt(2^pass) samples during a pass.
+
+    \var constexpr double SD_TREE_GUIDING_FRACTION
+    \brief Probability with which a bounce is sampled from the SD-tree instead of the material.
+
+    \class SDTree
+    \brief Spatial-directional tree used for path guiding, as described by Mueller et al. in "Practical Path Guiding for Efficient Light-Transport Simulation".
+    \details The space is subdivided by a binary tree, which cuts its regions in their middle, alternating between the *x*, *y* and *z* axes. Each leaf has a DirectionalQuadTree that learns the radiance arriving in its region.
+    The render is split into passes with doubling numbers of samples per pixel. During a pass, the paths record in the tree the radiance arriving at their diffuse bounces, and sample those bounces from the distribution learned during the previous passes. Between two passes, SDTree::learn() subdivides the regions that received many samples and makes every DirectionalQuadTree learn.
+
+    \struct SDTree::SpatialNode
+    \brief A node of the spatial binary tree.
+
+    \var unsigned int SDTree::SpatialNode::children
+    \brief The indexes of the two children of the node, 0 if it is a leaf.
+
+    \var unsigned int SDTree::SpatialNode::axis
+    \brief The axis along which the node is cut in two, 0 for *x*, 1 for *y* and 2 for *z*.
+
+    \var DirectionalQuadTree* SDTree::SpatialNode::directionalTree
+    \brief The directional tree of the region if the node is a leaf, nullptr else.
+
+    \fn SDTree::SDTree(const DoubleVec3D& minPoint, const DoubleVec3D& maxPoint)
+    \brief Main constructor.
+    \param minPoint The minimum point of a cuboid containing all the objects.
+    \param maxPoint The maximum point of a cuboid containing all the objects.
+    \sa getMinPoint(std::vector<Object3D*> objects), getMaxPoint(std::vector<Object3D*> objects)
+
+    \fn SDTree::~SDTree()
+    \brief Destructor.
+    \details Deletes the directional trees.
+
+    \fn bool SDTree::getTraining()
+    \brief Getter for the training.
+    \return Whether the paths must record the radiance they receive.
+
+    \fn unsigned int SDTree::getNumberPasses()
+    \brief Getter for the number of passes.
+    \return The number of times SDTree::learn() was called.
+
+    \fn unsigned int SDTree::getNumberSpatialLeaves()
+    \brief Computes the number of regions of the tree.
+    \return The number of leaves of the spatial binary tree.
+
+    \fn void SDTree::setTraining(bool training)
+    \brief Setter for the training.
+    \details The last pass does not need to train, as nothing will use what it would learn.
+    \param training Whether the paths must record the radiance they receive.
+
+    \fn DirectionalQuadTree* SDTree::getDirectionalTree(const DoubleVec3D& point)
+    \brief Finds the directional tree of the region containing a point.
+    \param point The point.
+    \return A pointer to the directional tree. The region of the closest leaf is used if the point is outside of the tree.
+
+    \fn void SDTree::learn()
+    \brief Prepares the tree for a new pass.
+    \details Splits the leaves that received more than SD_TREE_SPATIAL_THRESHOLD*sqrt(2^pass) samples. Their directional tree is copied in both halves, each one with half the samples. Then, calls DirectionalQuadTree::learn() on every leaf.
+    \warning Must not be called while a render is running.
+
+    \fn double mixGuidingPdf(double materialPdf, double guidingPdf)
+    \brief Computes the probability density of a direction sampled from the mixture of the material and the SD-tree.
+    \param materialPdf The probability density of the direction with the material.
+    \param guidingPdf The probability density of the direction with the SD-tree.
+    \return The probability density of the direction with the mixture.
+    \sa SD_TREE_GUIDING_FRACTION
+*/
+
+constexpr double SD_TREE_SPATIAL_THRESHOLD = 1000.0;
+constexpr double SD_TREE_GUIDING_FRACTION = 0.5;
+
+class SDTree {
+public:
+    struct SpatialNode {
+        unsigned int children[2] = { 0, 0 };
+        unsigned int axis = 0;
+        DirectionalQuadTree* directionalTree = nullptr;
+    };
+
+private:
+    DoubleVec3D minPoint;
+    DoubleVec3D maxPoint;
+    std::vector<SpatialNode> nodes;
+    unsigned int numberPasses = 0;
+    bool training = true;
+
+public:
+    SDTree(const DoubleVec3D& minPoint, const DoubleVec3D& maxPoint);
+    SDTree(const SDTree& tree) = delete;
+    ~SDTree();
+
+    bool getTraining() const;
+    unsigned int getNumberPasses() const;
+    unsigned int getNumberSpatialLeaves() const;
+    void setTraining(bool training);
+
+    DirectionalQuadTree* getDirectionalTree(const DoubleVec3D& point) const;
+    void learn();
+
+    SDTree& operator=(const SDTree& tree) = delete;
+};
+
+double mixGuidingPdf(double materialPdf, double guidingPdf);
+
+#endif
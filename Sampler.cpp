@@ -0,0 +1,114 @@
+#include "Sampler.h"
+
+#include "IndependentSampler.h"
+#include "StratifiedSampler.h"
+#include "HaltonSampler.h"
+#include "SobolSampler.h"
+
+thread_local Sampler* Sampler::threadSampler = nullptr;
+
+// Constructor and destructor
+Sampler::Sampler(unsigned int samplesPerPixel, unsigned int seed)
+    : uniformDistribution(0.0, 1.0), samplesPerPixel(samplesPerPixel), seed(seed) {}
+
+Sampler::~Sampler() {}
+
+
+// Dimensions
+void Sampler::startPixelSample(unsigned int pixelX, unsigned int pixelY, unsigned int sampleIndex) {
+    pixelSeed = hashCombine(hashCombine(seed, hashUnsignedInt(pixelX)), hashUnsignedInt(pixelY));
+    this->sampleIndex = sampleIndex;
+    randomEngine.seed(hashCombine(pixelSeed, hashUnsignedInt(sampleIndex)) % 2147483646 + 1);  // minstd_rand cannot be seeded with 0
+    startGroup(SAMPLER_GROUP_CAMERA);
+}
+
+void Sampler::resumePixelSample(unsigned int pixelX, unsigned int pixelY, unsigned int sampleIndex, unsigned int bounces) {
+    startPixelSample(pixelX, pixelY, sampleIndex);
+    randomEngine.seed(hashCombine(hashCombine(pixelSeed, hashUnsignedInt(sampleIndex)), hashUnsignedInt(bounces + 1)) % 2147483646 + 1);
+}
+
+void Sampler::startGroup(unsigned int group) {
+    currentGroup = group;
+    currentDimension = 0;
+    onGroupStarted();
+}
+
+void Sampler::startBounceGroup(unsigned int bounces, unsigned int group) {
+    startGroup(1 + bounces*SAMPLER_GROUPS_PER_BOUNCE + group);  // The first group is the camera one
+}
+
+double Sampler::getNextDouble() {
+    if (independentDoubles || currentDimension >= SAMPLER_DIMENSIONS_PER_GROUP)
+        return getIndependentDouble();
+    return computeDouble(currentDimension++);
+}
+
+void Sampler::setIndependentDoubles(bool independentDoubles) { this->independentDoubles = independentDoubles; }
+
+double Sampler::getIndependentDouble() {
+    return uniformDistribution(randomEngine);
+}
+
+void Sampler::onGroupStarted() {}
+
+
+// Thread sampler
+Sampler* Sampler::getThreadSampler() { return threadSampler; }
+void Sampler::setThreadSampler(Sampler* sampler) { threadSampler = sampler; }
+
+
+// Other functions
+Sampler* createSampler(SamplerType type, unsigned int samplesPerPixel, unsigned int seed) {
+    switch (type) {
+    case SAMPLER_INDEPENDENT: return new IndependentSampler(samplesPerPixel, seed);
+    case SAMPLER_STRATIFIED: return new StratifiedSampler(samplesPerPixel, seed);
+    case SAMPLER_HALTON: return new HaltonSampler(samplesPerPixel, seed);
+    default: return new SobolSampler(samplesPerPixel, seed);
+    }
+}
+
+std::string samplerType2string(SamplerType type) {
+    switch (type) {
+    case SAMPLER_INDEPENDENT: return "Independent";
+    case SAMPLER_STRATIFIED: return "Stratified";
+    case SAMPLER_HALTON: return "Halton";
+    default: return "Sobol";
+    }
+}
+
+SamplerType string2SamplerType(std::string name) {
+    if (name == "Independent")
+        return SAMPLER_INDEPENDENT;
+    if (name == "Stratified")
+        return SAMPLER_STRATIFIED;
+    if (name == "Halton")
+        return SAMPLER_HALTON;
+    return SAMPLER_SOBOL;
+}
+
+void startSamplerBounceGroup(unsigned int bounces, unsigned int group) {
+    Sampler* sampler = Sampler::getThreadSampler();
+    if (sampler != nullptr)
+        sampler->startBounceGroup(bounces, group);
+}
+
+
+// Hash
+unsigned int hashUnsignedInt(unsigned int value) {
+    // "lowbias32" from https://nullprogram.com/blog/2018/07/31/ (accessed on 19th October 2026)
+    value ^= value >> 16;
+    value *= 0x7feb352du;
+    value ^= value >> 15;
+    value *= 0x846ca68bu;
+    value ^= value >> 16;
+    return value;
+}
+
+unsigned int hashCombine(unsigned int seed, unsigned int value) {
+    // Same as boost::hash_combine
+    return seed ^ (value + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+double unsignedInt2Double(unsigned int value) {
+    return value * (1.0 / 4294967296.0);  // 2^32, so that the result is always strictly smaller than 1
+}
@@ -0,0 +1,207 @@
+#ifndef DEF_SAMPLER
+#define DEF_SAMPLER
+
+#include <climits>
+#include <string>
+
+#include "InterfaceGestion.h"
+
+/*!
+    \file Sampler.h
+    \brief Defines the Sampler class and the functions around it.
+    \details During a render, every thread has its own sampler, and randomDouble() returns the numbers of the sampler of the calling thread. Hence, the materials and the objects do not need to know which sampler is used.
+
+    \var constexpr unsigned int SAMPLER_DIMENSIONS_PER_GROUP
+    \brief Number of dimensions in a group. If more numbers are asked in the same group, they are independent random numbers.
+
+    \var constexpr unsigned int SAMPLER_GROUP_CAMERA
+    \brief Group used to jitter the position of the ray in the pixel.
+
+    \var constexpr unsigned int SAMPLER_GROUP_RUSSIAN_ROULETTE
+    \brief Group, relative to the first group of a bounce, used by the russian roulette.
+
+    \var constexpr unsigned int SAMPLER_GROUP_LIGHT
+    \brief Group, relative to the first group of a bounce, used to sample the lamps. The first two lamps get low-discrepancy numbers, the other ones get independent random numbers.
+
+    \var constexpr unsigned int SAMPLER_GROUP_MATERIAL
+    \brief Group, relative to the first group of a bounce, used by the material to sample the new direction.
+
+    \var constexpr unsigned int SAMPLER_GROUPS_PER_BOUNCE
+    \brief Number of groups used by each bounce.
+
+    \enum SamplerType
+    \brief The available samplers.
+
+    \class Sampler
+    \brief Abstract class that generates the numbers of the samples of a pixel.
+    \details The dimensions are split into groups of SAMPLER_DIMENSIONS_PER_GROUP dimensions. The first group is used by the camera, and then every bounce has SAMPLER_GROUPS_PER_BOUNCE groups, always in the same order. This way, a given dimension is always used for the same decision along the path, which is needed for low-discrepancy sequences to be useful.
+
+    \fn Sampler::Sampler(unsigned int samplesPerPixel, unsigned int seed)
+    \brief Main constructor.
+    \param samplesPerPixel The number of samples per pixel of the render.
+    \param seed The seed of the render, so that two renders do not give the same noise.
+
+    \fn virtual Sampler::~Sampler()
+    \brief Virtual destructor.
+
+    \fn void Sampler::startPixelSample(unsigned int pixelX, unsigned int pixelY, unsigned int sampleIndex)
+    \brief Starts a new sample of a pixel.
+    \details Then, the numbers are the ones of the camera group.
+    \param pixelX The *x* coordinate of the pixel.
+    \param pixelY The *y* coordinate of the pixel.
+    \param sampleIndex The index of the sample in the pixel, between 0 and the number of samples per pixel.
+
+    \fn void Sampler::resumePixelSample(unsigned int pixelX, unsigned int pixelY, unsigned int sampleIndex, unsigned int bounces)
+    \brief Goes back to a sample of a pixel whose path was interrupted, to compute one of its bounces.
+    \details The low-discrepancy numbers only depend on the sample and on the group, so they are the same as if the path had not been interrupted. The independent random numbers are seeded with the bounce too, else every bounce would get the ones of the first.
+    \param pixelX The *x* coordinate of the pixel.
+    \param pixelY The *y* coordinate of the pixel.
+    \param sampleIndex The index of the sample in the pixel, between 0 and the number of samples per pixel.
+    \param bounces The number of bounces of the path.
+
+    \fn void Sampler::startGroup(unsigned int group)
+    \brief Starts a group of dimensions.
+    \param group The index of the group.
+
+    \fn void Sampler::startBounceGroup(unsigned int bounces, unsigned int group)
+    \brief Starts a group of dimensions of a bounce.
+    \param bounces The number of bounces of the path.
+    \param group The group relative to the bounce, for example SAMPLER_GROUP_LIGHT.
+
+    \fn double Sampler::getNextDouble()
+    \brief Gives the number of the next dimension of the current group.
+    \return A number between 0 and 1.
+
+    \fn void Sampler::setIndependentDoubles(bool independentDoubles)
+    \brief Makes the sampler give independent random numbers, whatever the group.
+    \details Used when several paths are traced from the same sample, for example to compute a record of the radiance cache. They would all get the same numbers else.
+    \param independentDoubles If true, Sampler::getNextDouble() only returns independent random numbers until it is set to false again.
+    \sa RadianceCache
+
+    \fn static Sampler* Sampler::getThreadSampler()
+    \brief Gives the sampler of the calling thread.
+    \return A pointer to the sampler used by randomDouble() in the calling thread, or nullptr if there is none.
+
+    \fn static void Sampler::setThreadSampler(Sampler* sampler)
+    \brief Sets the sampler of the calling thread.
+    \param sampler The sampler randomDouble() will use in the calling thread, or nullptr to use the global random engine.
+
+    \fn virtual std::string Sampler::getType() = 0
+    \brief Returns this sampler type.
+    \return The name of this sampler, as given by samplerType2string().
+
+    \fn double Sampler::getIndependentDouble()
+    \brief Gives an independent random number.
+    \details The random engine is seeded at the beginning of every pixel sample, so that a render does not depend on the number of threads.
+    \return A random double between 0 and 1.
+
+    \fn virtual double Sampler::computeDouble(unsigned int dimension) = 0
+    \brief Computes the number of a dimension of the current group, for the current pixel sample.
+    \param dimension The dimension in the current group, smaller than SAMPLER_DIMENSIONS_PER_GROUP.
+    \return A number between 0 and 1.
+
+    \fn virtual void Sampler::onGroupStarted()
+    \brief Called when a new group is started, so that the samplers can compute what does not depend on the dimension.
+
+    \fn Sampler* createSampler(SamplerType type, unsigned int samplesPerPixel, unsigned int seed)
+    \brief Creates a sampler.
+    \param type The type of the sampler.
+    \param samplesPerPixel The number of samples per pixel of the render.
+    \param seed The seed of the render.
+    \return A pointer to the new sampler. It must be deleted by the caller.
+
+    \fn std::string samplerType2string(SamplerType type)
+    \brief Converts a sampler type to a string.
+    \param type The sampler type.
+    \return "Independent", "Stratified", "Halton" or "Sobol".
+
+    \fn SamplerType string2SamplerType(std::string name)
+    \brief Converts a string to a sampler type.
+    \param name The name given by samplerType2string().
+    \return The sampler type. SAMPLER_SOBOL if the name is unknown.
+
+    \fn void startSamplerBounceGroup(unsigned int bounces, unsigned int group)
+    \brief Starts a group of dimensions of a bounce in the sampler of the calling thread, if there is one.
+    \param bounces The number of bounces of the path.
+    \param group The group relative to the bounce, for example SAMPLER_GROUP_LIGHT.
+    \sa Sampler::startBounceGroup()
+
+    \fn unsigned int hashUnsignedInt(unsigned int value)
+    \brief Hashes an integer.
+    \details Uses the "lowbias32" hash of Chris Wellons.
+    \param value The integer that will be hashed.
+    \return The hash.
+
+    \fn unsigned int hashCombine(unsigned int seed, unsigned int value)
+    \brief Mixes a value into a hash.
+    \param seed The current hash.
+    \param value The value that will be mixed.
+    \return The new hash.
+
+    \fn double unsignedInt2Double(unsigned int value)
+    \brief Converts 32 random bits to a double between 0 and 1.
+    \param value The random bits.
+    \return A double between 0 (included) and 1 (excluded).
+*/
+
+constexpr unsigned int SAMPLER_DIMENSIONS_PER_GROUP = 4;
+constexpr unsigned int SAMPLER_GROUP_CAMERA = 0;
+constexpr unsigned int SAMPLER_GROUP_RUSSIAN_ROULETTE = 0;
+constexpr unsigned int SAMPLER_GROUP_LIGHT = 1;
+constexpr unsigned int SAMPLER_GROUP_MATERIAL = 2;
+constexpr unsigned int SAMPLER_GROUPS_PER_BOUNCE = 3;
+
+enum SamplerType {
+    SAMPLER_INDEPENDENT,
+    SAMPLER_STRATIFIED,
+    SAMPLER_HALTON,
+    SAMPLER_SOBOL
+};
+
+class Sampler {
+private:
+    static thread_local Sampler* threadSampler;
+
+    std::minstd_rand randomEngine;
+    std::uniform_real_distribution<double> uniformDistribution;
+    unsigned int currentDimension = 0;
+    bool independentDoubles = false;
+
+protected:
+    unsigned int samplesPerPixel;
+    unsigned int seed;
+    unsigned int pixelSeed = 0;
+    unsigned int sampleIndex = 0;
+    unsigned int currentGroup = 0;
+
+    double getIndependentDouble();
+    virtual double computeDouble(unsigned int dimension) = 0;
+    virtual void onGroupStarted();
+
+public:
+    Sampler(unsigned int samplesPerPixel, unsigned int seed);
+    virtual ~Sampler();
+
+    void startPixelSample(unsigned int pixelX, unsigned int pixelY, unsigned int sampleIndex);
+    void resumePixelSample(unsigned int pixelX, unsigned int pixelY, unsigned int sampleIndex, unsigned int bounces);
+    void startGroup(unsigned int group);
+    void startBounceGroup(unsigned int bounces, unsigned int group);
+    double getNextDouble();
+    void setIndependentDoubles(bool independentDoubles);
+
+    static Sampler* getThreadSampler();
+    static void setThreadSampler(Sampler* sampler);
+
+    virtual std::string getType() const = 0;
+};
+
+Sampler* createSampler(SamplerType type, unsigned int samplesPerPixel, unsigned int seed);
+std::string samplerType2string(SamplerType type);
+SamplerType string2SamplerType(std::string name);
+void startSamplerBounceGroup(unsigned int bounces, unsigned int group);
+
+unsigned int hashUnsignedInt(unsigned int value);
+unsigned int hashCombine(unsigned int seed, unsigned int value);
+double unsignedInt2Double(unsigned int value);
+
+#endif
@@ -7,6 +7,10 @@ Scene::Scene(PerspectiveCamera camera /*= PerspectiveCamera()*/, unsigned int sa
 Scene::Scene(const Scene& scene)
     : Scene(scene.camera, scene.samplesPerPixel, scene.minBounces) {}
 
+Scene::~Scene() {
+    releaseAccelerationStructures();
+}
+
 
 // Getters
 std::vector<Object3DGroup> Scene::getObjectGroups() const { return objectGroups; }
@@ -19,6 +23,8 @@ std::vector<Object3D*> Scene::getObjects() {
     return objects;
 }
 
+MemoryArena& Scene::getGeometryArena() { return geometryArena; }
+
 std::vector<Object3D*> Scene::getLamps() {
     // May take a long time to compute -> must be absolutely necessary
     computeObjectsAndLamps();
@@ -31,20 +37,51 @@ unsigned int Scene::getSamplesPerPixel() const { return samplesPerPixel; }
 unsigned int Scene::getMinBounces() const { return minBounces; }
 bool Scene::getRussianRoulette() const { return russianRoulette; }
 double Scene::getRrStopProbability() const { return rrStopProbability; }
+bool Scene::getRrThroughputBased() const { return rrThroughputBased; }
 bool Scene::getNextEventEstimation() const { return nextEventEstimation; }
+bool Scene::getMultipleImportanceSampling() const { return multipleImportanceSampling; }
+SamplerType Scene::getSamplerType() const { return samplerType; }
 unsigned int Scene::getNumberThreads() const { return numberThreads; }
 bool Scene::getKDTree() const { return kdTree; }
 unsigned int Scene::getKDMaxObjectNumber() const { return kdMaxObjectNumber; }
 unsigned int Scene::getKDMaxDepth() const { return kdMaxDepth; }
+bool Scene::getKDAutoParameters() const { return kdAutoParameters; }
+bool Scene::getKDCalibration() const { return kdCalibration; }
+bool Scene::getKDLazyBuild() const { return kdLazyBuild; }
+bool Scene::getKDTreeCache() const { return kdTreeCache; }
+bool Scene::getSBVH() const { return sbvh; }
+double Scene::getSBVHAlpha() const { return sbvhAlpha; }
+bool Scene::getRadianceCache() const { return radianceCache; }
+double Scene::getRadianceCacheErrorThreshold() const { return radianceCacheErrorThreshold; }
+unsigned int Scene::getRadianceCacheMaxRecords() const { return radianceCacheMaxRecords; }
+bool Scene::getPathGuiding() const { return pathGuiding; }
+bool Scene::getCausticPhotonMapping() const { return causticPhotonMapping; }
+unsigned int Scene::getCausticPhotons() const { return causticPhotons; }
+double Scene::getCausticPhotonRadius() const { return causticPhotonRadius; }
+bool Scene::getBidirectionalPathTracing() const { return bidirectionalPathTracing; }
+unsigned int Scene::getRayPacketSize() const { return rayPacketSize; }
+bool Scene::getWavefrontPathTracing() const { return wavefrontPathTracing; }
 std::string Scene::getBackupFileName() const { return backupFileName; }
 bool Scene::getBackupParameters() const { return backupParameters; }
 bool Scene::getBackupObjectGroups() const { return backupObjectGroups; }
 bool Scene::getBackupPicture() const { return backupPicture; }
 double Scene::getLeastRenderTime4PictureBackup() const { return leastRenderTime4PictureBackup; }
+double Scene::getKDTreeCreationTime() const { return kdTreeCreationTime; }
+unsigned int Scene::getKDTreeMaxObjectNumber() const { return kdTreeMaxObjectNumber; }
+unsigned int Scene::getKDTreeMaxDepth() const { return kdTreeMaxDepth; }
+unsigned int Scene::getKDTreeBuiltNodes() const { return kdTreeBuiltNodes; }
+unsigned int Scene::getKDTreeUnbuiltNodes() const { return kdTreeUnbuiltNodes; }
+double Scene::getSBVHCreationTime() const { return sbvhCreationTime; }
+unsigned int Scene::getSBVHDuplicatedReferences() const { return sbvhDuplicatedReferences; }
+double Scene::getSBVHSAHCost() const { return sbvhSAHCost; }
+RayCounters Scene::getRayCounters() const { return rayCounters; }
 
 
 // Setters
-void Scene::setObjectGroups(std::vector<Object3DGroup> groups) { objectGroups = groups; }
+void Scene::setObjectGroups(std::vector<Object3DGroup> groups) {
+    objectGroups = groups;
+    objectGroupsGeneration++;
+}
 void Scene::setCamera(PerspectiveCamera camera) { this->camera = camera; }
 void Scene::setSamplesPerPixel(unsigned int samplesPerPixel) { this->samplesPerPixel = samplesPerPixel; }
 void Scene::setMinBounces(unsigned int minBounces) { this->minBounces = minBounces; }
@@ -54,11 +91,30 @@ void Scene::setRussianRoulette(bool russianRoulette, double rrStopProbability) {
     this->rrStopProbability = rrStopProbability;
 }
 void Scene::setRrStopProbability(double rrStopProbability) { this->rrStopProbability = rrStopProbability; }
+void Scene::setRrThroughputBased(bool rrThroughputBased) { this->rrThroughputBased = rrThroughputBased; }
 void Scene::setNextEventEstimation(bool nextEventEstimation) { this->nextEventEstimation = nextEventEstimation; }
+void Scene::setMultipleImportanceSampling(bool multipleImportanceSampling) { this->multipleImportanceSampling = multipleImportanceSampling; }
+void Scene::setSamplerType(SamplerType samplerType) { this->samplerType = samplerType; }
 void Scene::setNumberThreads(unsigned int numberThreads) { this->numberThreads = numberThreads; }
 void Scene::setKDTree(bool kdTree) { this->kdTree = kdTree; }
 void Scene::setKDMaxObjectNumber(unsigned int kdMaxObjectNumber) { this->kdMaxObjectNumber = kdMaxObjectNumber; }
 void Scene::setKDMaxDepth(unsigned int kdMaxDepth) { this->kdMaxDepth = kdMaxDepth; }
+void Scene::setKDAutoParameters(bool kdAutoParameters) { this->kdAutoParameters = kdAutoParameters; }
+void Scene::setKDCalibration(bool kdCalibration) { this->kdCalibration = kdCalibration; }
+void Scene::setKDLazyBuild(bool kdLazyBuild) { this->kdLazyBuild = kdLazyBuild; }
+void Scene::setKDTreeCache(bool kdTreeCache) { this->kdTreeCache = kdTreeCache; }
+void Scene::setSBVH(bool sbvh) { this->sbvh = sbvh; }
+void Scene::setSBVHAlpha(double sbvhAlpha) { this->sbvhAlpha = sbvhAlpha; }
+void Scene::setRadianceCache(bool radianceCache) { this->radianceCache = radianceCache; }
+void Scene::setRadianceCacheErrorThreshold(double radianceCacheErrorThreshold) { this->radianceCacheErrorThreshold = radianceCacheErrorThreshold; }
+void Scene::setRadianceCacheMaxRecords(unsigned int radianceCacheMaxRecords) { this->radianceCacheMaxRecords = radianceCacheMaxRecords; }
+void Scene::setPathGuiding(bool pathGuiding) { this->pathGuiding = pathGuiding; }
+void Scene::setCausticPhotonMapping(bool causticPhotonMapping) { this->causticPhotonMapping = causticPhotonMapping; }
+void Scene::setCausticPhotons(unsigned int causticPhotons) { this->causticPhotons = causticPhotons; }
+void Scene::setCausticPhotonRadius(double causticPhotonRadius) { this->causticPhotonRadius = causticPhotonRadius; }
+void Scene::setBidirectionalPathTracing(bool bidirectionalPathTracing) { this->bidirectionalPathTracing = bidirectionalPathTracing; }
+void Scene::setRayPacketSize(unsigned int rayPacketSize) { this->rayPacketSize = rayPacketSize; }
+void Scene::setWavefrontPathTracing(bool wavefrontPathTracing) { this->wavefrontPathTracing = wavefrontPathTracing; }
 void Scene::setBackupFileName(std::string backupFileName) { this->backupFileName = backupFileName; }
 void Scene::setBackupParameters(bool backupParameters) { this->backupParameters = backupParameters; }
 void Scene::setBackupObjectGroups(bool backupObjectGroups) { this->backupObjectGroups = backupObjectGroups; }
@@ -69,22 +125,75 @@ void Scene::setLeastRenderTime4PictureBackup(double leastRenderTime4PictureBacku
 // Object groups management
 void Scene::addObjectGroup(const Object3DGroup& group) {
     objectGroups.push_back(group);
+    objectGroupsGeneration++;
+}
+
+void Scene::modifyObjectGroup(unsigned int index) {
+    if (objectGroups[index].modify())
+        objectGroupsGeneration++;
+}
+
+void Scene::deleteObjectGroup(unsigned int index) {
+    objectGroups[index].resetAndDeleteObjects();
+    objectGroups.erase(objectGroups.begin() + index);
+    objectGroupsGeneration++;
+}
+
+void Scene::mergeObjectGroups(unsigned int index1, unsigned int index2, const std::string& name) {
+    if (objectGroups[index1].getArena() != objectGroups[index2].getArena()) {  // A group cannot be partly in the arena
+        objectGroups[index1].moveToArena(geometryArena);
+        objectGroups[index2].moveToArena(geometryArena);
+    }
+    objectGroups[index1].merge(objectGroups[index2]);
+    Object3DGroup mergedGroup = objectGroups[index1];
+
+    objectGroups.erase(objectGroups.begin() + std::max(index1, index2));
+    objectGroups.erase(objectGroups.begin() + std::min(index1, index2));
+
+    mergedGroup.setName(name);
+    objectGroups.push_back(mergedGroup);
+    objectGroupsGeneration++;
 }
 
 void Scene::resetAndDeleteObjectGroups() {
-    for (Object3DGroup objectGroup : objectGroups)
+    // The groups in the arena skip their objects, they are freed with it
+    for (Object3DGroup& objectGroup : objectGroups)
         objectGroup.resetAndDeleteObjects();
     objectGroups.clear();
+    objects.clear();
+    lamps.clear();
+    spherePrimitives.clear();
+    trianglePrimitives.clear();
+    objectGroupsGeneration++;
+
+    releaseAccelerationStructures();  // They point to the objects
+    geometryArena.release();
+}
+
+void Scene::addObjectGroupsFromJson(const json& j) {
+    for (const json& jsonGroup : j)
+        addObjectGroup(importObject3DGroupFromJson(jsonGroup, &geometryArena));
 }
 
 void Scene::computeObjectsAndLamps() {
     objects = split(objectGroups);
     lamps.clear();
 
+    spherePrimitives.clear();
+    trianglePrimitives.clear();
+    splitIntoPrimitives(objects, spherePrimitives, trianglePrimitives);
+
     for (Object3D* object : objects) {
         if (!object->getMaterial()->getEmittance().isZero())
             lamps.push_back(object);
     }
+
+    lampPowersCdf.clear();
+    double totalPower = 0.0;
+    for (Object3D* lamp : lamps) {
+        totalPower += computeLampPower(lamp);
+        lampPowersCdf.push_back(totalPower);
+    }
 }
 
 void Scene::defaultScene() {
@@ -156,21 +265,21 @@ bool Scene::importFBXFile(const char* filePath, Material* material, std::string
     FbxNode* rootNode = fbxScene->GetRootNode();
     std::vector<Object3D*> objects;
 
-    bool importedAllFbxNodeAsTriangles = importTrianglesFromFbxNode(rootNode, material, objects);
+    bool importedAllFbxNodeAsTriangles = importTrianglesFromFbxNode(rootNode, material, objects, geometryArena);
     delete material; // Only made copies.
     if (!importedAllFbxNodeAsTriangles)
         return false;
 
-    addObjectGroup(Object3DGroup(name, objects));
+    addObjectGroup(Object3DGroup(name, objects, &geometryArena));
     std::cout << "\r" << filePath << " was successfully imported in " << getCurrentTimeSeconds() - importationBeginningTime << " seconds!" << std::endl;
     return true;
 }
 
-bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<Object3D*>& objects) {
+bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<Object3D*>& objects, MemoryArena& arena) {
     for (int childNumber = 0; childNumber < node->GetChildCount(); childNumber++) {
         FbxNode* child = node->GetChild(childNumber);
         
-        if (!importTrianglesFromFbxNode(child, material, objects))  // Recursive call
+        if (!importTrianglesFromFbxNode(child, material, objects, arena))  // Recursive call
             return false;
 
         FbxMesh* mesh = child->GetMesh();
@@ -183,6 +292,7 @@ bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<O
             DoubleMatrix33 rotationAndScalingMatrix = getRotationMatrixXYZ(rotation)*getScalingMatrixXYZ(scaling);  // order is important
 
             FbxVector4* controlPoints = mesh->GetControlPoints();
+            objects.reserve(objects.size() + mesh->GetPolygonCount());
             // Add each triangle to the scene
             for (int polygonIx = 0; polygonIx < mesh->GetPolygonCount(); polygonIx++) {
                 if (mesh->GetPolygonSize(polygonIx) != 3) {
@@ -196,7 +306,7 @@ bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<O
                 DoubleVec3D vertex1 = rotationAndScalingMatrix * controlPoints[mesh->GetPolygonVertex(polygonIx, 1)] + translation;
                 DoubleVec3D vertex2 = rotationAndScalingMatrix * controlPoints[mesh->GetPolygonVertex(polygonIx, 2)] + translation;
 
-                objects.push_back(new Triangle(vertex0, vertex1, vertex2, material->deepCopy()));
+                objects.push_back(new (arena) Triangle(vertex0, vertex1, vertex2, material->deepCopy(arena)));
             }
         }
     }
@@ -204,9 +314,9 @@ bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<O
 }
 
 
-// Save
-void Scene::saveParameters2File(std::string fileName) const {
-    json jsonOutput = {
+// Parameters
+json Scene::getParametersJson() const {
+    return {
     {"Camera", {
         {"NumberPixelsX", camera.getNumberPixelsX()},
         {"NumberPixelsY", camera.getNumberPixelsY()},
@@ -223,10 +333,31 @@ void Scene::saveParameters2File(std::string fileName) const {
         {"NumberThreads", numberThreads},
         {"RussianRoulette", russianRoulette},
         {"RrStopProbability", rrStopProbability},
+        {"RrThroughputBased", rrThroughputBased},
         {"NextEventEstimation", nextEventEstimation},
+        {"MultipleImportanceSampling", multipleImportanceSampling},
+        {"Sampler", samplerType2string(samplerType)},
         {"KDTree", kdTree},
         {"KDMaxDepth", kdMaxDepth},
-        {"KDMaxObjectNumber", kdMaxObjectNumber}
+        {"KDMaxObjectNumber", kdMaxObjectNumber},
+        {"KDAutoParameters", kdAutoParameters},
+        {"KDCalibration", kdCalibration},
+        {"KDChosenMaxDepth", kdTreeMaxDepth},  // Only written, as they are chosen again by each render
+        {"KDChosenMaxObjectNumber", kdTreeMaxObjectNumber},
+        {"KDLazyBuild", kdLazyBuild},
+        {"KDTreeCache", kdTreeCache},
+        {"SBVH", sbvh},
+        {"SBVHAlpha", sbvhAlpha},
+        {"RadianceCache", radianceCache},
+        {"RadianceCacheErrorThreshold", radianceCacheErrorThreshold},
+        {"RadianceCacheMaxRecords", radianceCacheMaxRecords},
+        {"PathGuiding", pathGuiding},
+        {"CausticPhotonMapping", causticPhotonMapping},
+        {"CausticPhotons", causticPhotons},
+        {"CausticPhotonRadius", causticPhotonRadius},
+        {"BidirectionalPathTracing", bidirectionalPathTracing},
+        {"RayPacketSize", rayPacketSize},
+        {"WavefrontPathTracing", wavefrontPathTracing}
         }
     },
     {"BackupParameters", {
@@ -238,6 +369,57 @@ void Scene::saveParameters2File(std::string fileName) const {
         }
     }
     };
+}
+
+void Scene::setParametersFromJson(const json& j) {
+    json jsonCamera = j.at("Camera");
+    camera.setNumberPixelsX(jsonCamera["NumberPixelsX"].get<unsigned int>());
+    camera.setNumberPixelsY(jsonCamera["NumberPixelsY"].get<unsigned int>());
+    camera.setOrigin(jsonCamera["Origin"].get<DoubleVec3D>());
+    camera.setFocal(jsonCamera["Focal"].get<DoubleVec3D>());
+
+    json jsonBasicParameters = j.at("BasicParameters");
+    samplesPerPixel = jsonBasicParameters["SamplesPerPixel"].get<unsigned int>();
+    minBounces = jsonBasicParameters["MinBounces"].get<unsigned int>();
+
+    json jsonOptimisationParameters = j.at("OptimisationParameters");
+    numberThreads = jsonOptimisationParameters["NumberThreads"].get<unsigned int>();
+    russianRoulette = jsonOptimisationParameters["RussianRoulette"].get<bool>();
+    rrStopProbability = jsonOptimisationParameters["RrStopProbability"].get<double>();
+    rrThroughputBased = jsonOptimisationParameters.value("RrThroughputBased", false);  // Older files used the fixed stop probability
+    nextEventEstimation = jsonOptimisationParameters["NextEventEstimation"].get<bool>();
+    multipleImportanceSampling = jsonOptimisationParameters.value("MultipleImportanceSampling", false);  // Older files do not have it
+    samplerType = string2SamplerType(jsonOptimisationParameters.value("Sampler", samplerType2string(SAMPLER_INDEPENDENT)));  // Older files used independent random numbers
+    kdTree = jsonOptimisationParameters["KDTree"].get<bool>();
+    kdMaxDepth = jsonOptimisationParameters["KDMaxDepth"].get<unsigned int>();
+    kdMaxObjectNumber = jsonOptimisationParameters["KDMaxObjectNumber"].get<unsigned int>();
+    kdAutoParameters = jsonOptimisationParameters.value("KDAutoParameters", false);  // Older files chose their k-d tree parameters by hand
+    kdCalibration = jsonOptimisationParameters.value("KDCalibration", false);
+    kdLazyBuild = jsonOptimisationParameters.value("KDLazyBuild", false);
+    kdTreeCache = jsonOptimisationParameters.value("KDTreeCache", false);
+    sbvh = jsonOptimisationParameters.value("SBVH", false);
+    sbvhAlpha = jsonOptimisationParameters.value("SBVHAlpha", 0.00001);
+    radianceCache = jsonOptimisationParameters.value("RadianceCache", false);
+    radianceCacheErrorThreshold = jsonOptimisationParameters.value("RadianceCacheErrorThreshold", 0.3);
+    radianceCacheMaxRecords = jsonOptimisationParameters.value("RadianceCacheMaxRecords", 100000u);
+    pathGuiding = jsonOptimisationParameters.value("PathGuiding", false);
+    causticPhotonMapping = jsonOptimisationParameters.value("CausticPhotonMapping", false);
+    causticPhotons = jsonOptimisationParameters.value("CausticPhotons", 1000000u);
+    causticPhotonRadius = jsonOptimisationParameters.value("CausticPhotonRadius", 0.05);
+    bidirectionalPathTracing = jsonOptimisationParameters.value("BidirectionalPathTracing", false);
+    rayPacketSize = jsonOptimisationParameters.value("RayPacketSize", 8);
+    wavefrontPathTracing = jsonOptimisationParameters.value("WavefrontPathTracing", false);
+
+    json jsonBackupParameters = j.at("BackupParameters");
+    backupFileName = jsonBackupParameters["BackupFileName"].get<std::string>();
+    backupParameters = jsonBackupParameters["BackupParameters"].get<bool>();
+    backupObjectGroups = jsonBackupParameters["BackupObjectGroups"].get<bool>();
+    backupPicture = jsonBackupParameters["BackupPicture"].get<bool>();
+    leastRenderTime4PictureBackup = jsonBackupParameters["LeastRenderTime4PictureBackup"].get<double>();
+}
+
+void Scene::saveParameters2File(std::string fileName) const {
+    json jsonOutput = getParametersJson();
 
     std::ofstream file;
     file.open(fileName);
@@ -259,85 +441,822 @@ void Scene::saveObjectGroups2File(std::string fileName) const {
 
 // Private method
 KDTreeNode::Intersection Scene::bruteForceIntersection(const Ray& ray) const {
-    double smallestPositiveDistance = INFINITY;  // Has to be strictly positive -> we don't want it to intersect with same object
+    double smallestPositiveDistance = INFINITY;
     Object3D* closestObject = nullptr;
-    for (Object3D* object : objects) {
-        double distance = object->smallestPositiveIntersection(ray);
-        if (distance > 0.00001 && distance < smallestPositiveDistance) {
-            smallestPositiveDistance = distance;
-            closestObject = object;
+    intersectPrimitives(ray, spherePrimitives.data(), spherePrimitives.size(), smallestPositiveDistance, closestObject);
+    intersectPrimitives(ray, trianglePrimitives.data(), trianglePrimitives.size(), smallestPositiveDistance, closestObject);
+    return KDTreeNode::Intersection(closestObject, smallestPositiveDistance);
+}
+
+KDTreeNode::Intersection Scene::findIntersection(const Ray& ray, const KDTreeNode* lastNode) const {
+    if (currentSBVH != nullptr)
+        return currentSBVH->getIntersection(ray);
+    if (kdTreeRoot == nullptr)
+        return bruteForceIntersection(ray);
+    else if (lastNode == nullptr)
+        return kdTreeRoot->getIntersectionForward(ray);
+    else
+        return lastNode->getIntersectionWithRopes(ray);
+}
+
+template <bool useKDTree>
+KDTreeNode::Intersection Scene::findIntersection(const Ray& ray, const KDTreeNode* lastNode) const {  // private
+    if (!useKDTree)
+        return (currentSBVH != nullptr) ? currentSBVH->getIntersection(ray) : bruteForceIntersection(ray);
+    return lastNode->getIntersectionWithRopes(ray);  // From the root, the ray goes down to the leaf where it enters the tree
+}
+
+void Scene::chooseKDTreeParameters() {  // private
+    double objectNumber = std::max((double)objects.size(), 1.0);
+    kdTreeMaxObjectNumber = kdMaxObjectNumber;
+    kdTreeMaxDepth = (unsigned int)std::round(8 + 1.3*std::log2(objectNumber));
+    if (!kdCalibration)
+        return;
+
+    // The calibration traces paths on the calling thread only, with a sampler of its own
+    Sampler* previousSampler = Sampler::getThreadSampler();
+    Sampler* calibrationSampler = createSampler(SAMPLER_INDEPENDENT, 1, 0);
+    Sampler::setThreadSampler(calibrationSampler);
+    RenderStatistics::reset(1);
+
+    // Depth first, then leaf size with the best depth
+    unsigned int automaticDepth = kdTreeMaxDepth;
+    double bestTime = INFINITY;
+    for (unsigned int depth = (automaticDepth > 6) ? automaticDepth - 6 : automaticDepth % 2; depth <= automaticDepth + 2; depth += 2) {  // Mostly shallower depths, as deeper trees duplicate more objects
+        double time = timeKDTreeCalibrationPaths(kdMaxObjectNumber, depth);
+        if (time < bestTime) {
+            bestTime = time;
+            kdTreeMaxDepth = depth;
         }
     }
-    return KDTreeNode::Intersection(closestObject, smallestPositiveDistance);
+    for (unsigned int maxObjectNumber : {std::max(kdMaxObjectNumber / 2, 1u), kdMaxObjectNumber * 2}) {  // Around the user's leaf size, so that the choice does not drift from render to render
+        double time = timeKDTreeCalibrationPaths(maxObjectNumber, kdTreeMaxDepth);
+        if (time < bestTime) {
+            bestTime = time;
+            kdTreeMaxObjectNumber = maxObjectNumber;
+        }
+    }
+
+    Sampler::setThreadSampler(previousSampler);
+    delete calibrationSampler;
+}
+
+double Scene::timeKDTreeCalibrationPaths(unsigned int maxObjectNumber, unsigned int maxDepth) {  // private
+    kdTreeRoot = new (kdTreeArena) KDTreeNode(objects, maxObjectNumber, maxDepth, kdTreeArena, nullptr, 0, kdLazyBuild);  // A lazy tree is timed with its builds
+    currentTraceRay = selectTraceRay();
+    unsigned int pictureWidth = camera.getNumberPixelsX();
+    unsigned long long numberPixels = (unsigned long long)pictureWidth * camera.getNumberPixelsY();
+
+    double beginningTime = getCurrentTimeSeconds();
+    for (unsigned int path = 0; path < KD_CALIBRATION_PATHS; path++) {
+        unsigned int pixel = (unsigned int)(path * numberPixels / KD_CALIBRATION_PATHS);
+        unsigned int pixelX = pixel % pictureWidth;
+        unsigned int pixelY = pixel / pictureWidth;
+        Sampler::getThreadSampler()->startPixelSample(pixelX, pixelY, 0);
+        double offsetX = randomDouble();
+        double offsetY = randomDouble();
+        traceRay(camera.getRayGoingThrough(pixelX + offsetX, pixelY + offsetY));
+    }
+    double time = getCurrentTimeSeconds() - beginningTime;
+
+    kdTreeArena.release();
+    kdTreeRoot = nullptr;
+    return time;
+}
+
+void Scene::releaseAccelerationStructures() {  // private
+    if (kdTreeRoot != nullptr) {
+        kdTreeArena.release();  // Frees the whole tree at once
+        kdTreeRoot = nullptr;
+    }
+    kdTreeMaxObjectNumber = 0;
+    kdTreeMaxDepth = 0;
+    if (currentSBVH != nullptr) {
+        delete currentSBVH;
+        currentSBVH = nullptr;
+    }
+}
+
+Scene::TraceRayFunction Scene::selectTraceRay() const {  // private
+    if (kdTreeRoot != nullptr) {
+        if (nextEventEstimation)
+            return russianRoulette ? &Scene::traceRay<true, true, true> : &Scene::traceRay<true, true, false>;
+        return russianRoulette ? &Scene::traceRay<true, false, true> : &Scene::traceRay<true, false, false>;
+    }
+    if (nextEventEstimation)
+        return russianRoulette ? &Scene::traceRay<false, true, true> : &Scene::traceRay<false, true, false>;
+    return russianRoulette ? &Scene::traceRay<false, false, true> : &Scene::traceRay<false, false, false>;
+}
+
+DoubleVec3D Scene::traceRay(const Ray& ray, double usedNextEventEstimation /*= false*/, const KDTreeNode* lastNode /*= nullptr*/, unsigned int bounces /*= 0*/, double lastDirectionPdf /*= 0.0*/, const DoubleVec3D& throughput /*= DoubleVec3D(1.0)*/, bool causticChain /*= false*/, const KDTreeNode::Intersection* knownIntersection /*= nullptr*/) const {  // private
+    // The variants never check whether lastNode is nullptr, so the camera rays start from the root
+    if (lastNode == nullptr)
+        lastNode = kdTreeRoot;  // nullptr without k-d tree
+    return (this->*currentTraceRay)(ray, usedNextEventEstimation, lastNode, bounces, lastDirectionPdf, throughput, causticChain, knownIntersection);
 }
 
-DoubleVec3D Scene::traceRay(const Ray& ray, double usedNextEventEstimation /*= false*/, const KDTreeNode* lastNode /*= nullptr*/, unsigned int bounces /*= 0*/) const {
+template <bool useKDTree, bool useNextEventEstimation, bool useRussianRoulette>
+DoubleVec3D Scene::traceRay(const Ray& ray, double usedNextEventEstimation, const KDTreeNode* lastNode, unsigned int bounces, double lastDirectionPdf, const DoubleVec3D& throughput, bool causticChain, const KDTreeNode::Intersection* knownIntersection) const {  // private
     DoubleVec3D result(0.0);
+    RayCounters& rayCounters = RenderStatistics::getThreadCounters();
 
     // Russian roulette
     double rrFactor = 1.0;
     if (bounces >= minBounces) {
-        if (!russianRoulette || randomDouble() < rrStopProbability)
+        if (!useRussianRoulette) {
+            STATISTICS_INCREMENT(russianRouletteTerminations);
+            STATISTICS_PATH_LENGTH(bounces);
             return result;
-        rrFactor = 1.0 / (1.0 - rrStopProbability);
+        }
+        startSamplerBounceGroup(bounces, SAMPLER_GROUP_RUSSIAN_ROULETTE);
+        double stopProbability = rrStopProbability;
+        if (rrThroughputBased) {
+            double maxThroughput = std::max(throughput.getX(), std::max(throughput.getY(), throughput.getZ()));
+            stopProbability = std::max(rrStopProbability, 1.0 - maxThroughput);  // At least rrStopProbability, so that bright paths still end
+        }
+        if (randomDouble() < stopProbability) {
+            STATISTICS_INCREMENT(russianRouletteTerminations);
+            STATISTICS_PATH_LENGTH(bounces);
+            return result;
+        }
+        rrFactor = 1.0 / (1.0 - stopProbability);
     }
 
     // Search for ray intersection
-    KDTreeNode::Intersection intersection;
-    if (!kdTree)
-        intersection = bruteForceIntersection(ray);
-    else if (lastNode == nullptr)
-        intersection = kdTreeRoot->getIntersectionForward(ray);
+    if (bounces == 0)
+        rayCounters.primaryRays++;
     else
-        intersection = lastNode->getIntersectionBackwards(ray);
+        rayCounters.secondaryRays++;
+
+    // Primary rays traced as a packet already know their intersection
+    KDTreeNode::Intersection intersection = (knownIntersection != nullptr) ? *knownIntersection : findIntersection<useKDTree>(ray, lastNode);
 
-    if (intersection.object == nullptr)  // Something must be hit
+    if (intersection.object == nullptr) {  // Something must be hit
+        STATISTICS_PATH_LENGTH(bounces);
         return result;
+    }
+    STATISTICS_INCREMENT(hits);
 
     // Rendering equation
     Material* objectMaterial = intersection.object->getMaterial();
     DoubleVec3D intersectionPoint = ray.getOrigin() + intersection.distance * ray.getDirection();
     DoubleUnitVec3D normal = intersection.object->getNormal(intersectionPoint);
 
-    double neeFactor = 1.0;
-    if (nextEventEstimation && objectMaterial->worksWithNextEventEstimation()) {
-        neeFactor = 1.0 / lamps.size();
+    bool useMultipleImportanceSampling = useNextEventEstimation && multipleImportanceSampling;
+    DirectionalQuadTree* guidingTree = nullptr;  // Only the materials with a pdf can be mixed with the SD-tree
+    if (currentSDTree != nullptr && objectMaterial->worksWithNextEventEstimation())
+        guidingTree = currentSDTree->getDirectionalTree(intersectionPoint);
+
+    // Every lamp is sampled, so their contributions are summed without dividing by their number
+    if (useNextEventEstimation && objectMaterial->worksWithNextEventEstimation()) {
+        startSamplerBounceGroup(bounces, SAMPLER_GROUP_LIGHT);
         for (Object3D* lamp : lamps) {
-            DoubleVec3D pointOnLamp = lamp->getRandomPoint();
+            double lightPdf;
+            DoubleVec3D pointOnLamp = lamp->sampleLightPoint(intersectionPoint, lightPdf);
             DoubleVec3D intersectionToLamp = pointOnLamp - intersectionPoint;
             if (dotProd(normal, intersectionToLamp) > -0.0001) {
                 double distanceLamp = length(intersectionToLamp);
                 Ray shadowRay(intersectionPoint, intersectionToLamp);  // intersectionToLamp goes in DoubleUnitVec3D constructor => normalised
 
-                KDTreeNode::Intersection shadowRayIntersection;
-                if (!kdTree)
-                    shadowRayIntersection = bruteForceIntersection(shadowRay);
-                else if (intersection.kdTreeNode == nullptr)
-                    shadowRayIntersection = kdTreeRoot->getIntersectionForward(shadowRay);
-                else
-                    shadowRayIntersection = intersection.kdTreeNode->getIntersectionBackwards(shadowRay);
+                rayCounters.shadowRays++;
+
+                KDTreeNode::Intersection shadowRayIntersection = findIntersection<useKDTree>(shadowRay, intersection.kdTreeNode);
 
                 if (distanceLamp - 0.00001 < shadowRayIntersection.distance && shadowRayIntersection.distance < distanceLamp + 0.00001) {
+                    STATISTICS_INCREMENT(unoccludedShadowRays);
                     intersectionToLamp /= distanceLamp;  // Normalised
 
-                    result += rrFactor * neeFactor * objectMaterial->computeCurrentRadiance(lamp->getMaterial()->getEmittance(), dotProd(intersectionToLamp, normal), true)
-                              * lamp->getArea() / distanceLamp / distanceLamp * dotProd(lamp->getNormal(pointOnLamp), -intersectionToLamp);
+                    double misWeight = 1.0;
+                    if (useMultipleImportanceSampling) {
+                        double directionPdf = objectMaterial->getDirectionPdf(ray, normal, intersectionToLamp);
+                        if (guidingTree != nullptr)
+                            directionPdf = mixGuidingPdf(directionPdf, guidingTree->getPdf(intersectionToLamp));
+                        misWeight = powerHeuristic(lightPdf, directionPdf);
+                    }
+
+                    result += rrFactor * misWeight * objectMaterial->computeCurrentRadiance(lamp->getMaterial()->getEmittance(), dotProd(intersectionToLamp, normal), true) / lightPdf;
                 }
+                else
+                    STATISTICS_INCREMENT(occludedShadowRays);
             }
         }
+
+        // Like for the lamps, the cosine is already in the irradiance
+        if (currentCausticPhotonMap != nullptr)
+            result += rrFactor * objectMaterial->computeCurrentRadiance(currentCausticPhotonMap->getIrradiance(intersectionPoint, normal), 1.0, true);
     }
-    if (!nextEventEstimation || !usedNextEventEstimation)
+    // Light going through specular objects after a diffuse one is already in the caustic photon map
+    bool emittanceInPhotonMap = causticChain && currentCausticPhotonMap != nullptr;
+    if (!emittanceInPhotonMap && (!useNextEventEstimation || !usedNextEventEstimation))
         // If next event estimation was used by last ray, we would be adding the emittance twice.
         result += rrFactor * objectMaterial->getEmittance();
+    else if (!emittanceInPhotonMap && useMultipleImportanceSampling && !objectMaterial->getEmittance().isZero())
+        // Unless both strategies are weighted so that they sum up to one
+        result += rrFactor * powerHeuristic(lastDirectionPdf, intersection.object->getLightPdf(ray.getOrigin(), intersectionPoint)) * objectMaterial->getEmittance();
+
+    // Radiance cache: after the first diffuse bounce, the indirect light is interpolated instead of continuing the path
+    if (currentRadianceCache != nullptr && bounces == 1 && usedNextEventEstimation && objectMaterial->worksWithNextEventEstimation()) {
+        STATISTICS_INCREMENT(radianceCacheQueries);
+        DoubleVec3D cachedRadiance;
+        bool foundRadiance = currentRadianceCache->getRadiance(intersectionPoint, normal, cachedRadiance);
+        if (foundRadiance)
+            STATISTICS_INCREMENT(radianceCacheHits);
+        else
+            foundRadiance = computeRadianceCacheRecord(intersectionPoint, normal, intersection.kdTreeNode, bounces, cachedRadiance);
+
+        if (foundRadiance) {
+            // The cached radiance was sampled with a cosine-weighted distribution, like the one of diffuse materials
+            STATISTICS_PATH_LENGTH(bounces + 1);
+            return result + rrFactor * objectMaterial->computeCurrentRadiance(cachedRadiance, 1.0);
+        }
+    }
 
-    DoubleUnitVec3D newDirection = objectMaterial->getNewDirection(ray, normal);
+    startSamplerBounceGroup(bounces, SAMPLER_GROUP_MATERIAL);
+    DoubleUnitVec3D newDirection;
+    if (guidingTree != nullptr && randomDouble() < SD_TREE_GUIDING_FRACTION)
+        newDirection = guidingTree->sample();
+    else
+        newDirection = objectMaterial->getNewDirection(ray, normal);
+    double newDirectionPdf = useMultipleImportanceSampling ? objectMaterial->getDirectionPdf(ray, normal, newDirection) : 0.0;
+
+    // computeCurrentRadiance() divides by the pdf of the material, it must be replaced by the one of the mixture
+    double guidingFactor = 1.0;
+    if (guidingTree != nullptr) {
+        double materialPdf = objectMaterial->getDirectionPdf(ray, normal, newDirection);
+        newDirectionPdf = mixGuidingPdf(materialPdf, guidingTree->getPdf(newDirection));
+        guidingFactor = (newDirectionPdf > 0.0) ? materialPdf / newDirectionPdf : 0.0;
+    }
+
+    double cosAngleNewDirectionNormal = dotProd(newDirection, normal);
+
+    // Nothing can come back from a path whose throughput is zero (a lamp with a black albedo, for example)
+    DoubleVec3D bounceWeight = guidingFactor * objectMaterial->computeCurrentRadiance(DoubleVec3D(1.0), cosAngleNewDirectionNormal);
+    if (bounceWeight.isZero()) {
+        STATISTICS_INCREMENT(zeroThroughputTerminations);
+        STATISTICS_PATH_LENGTH(bounces + 1);
+        return result;
+    }
+    DoubleVec3D newThroughput = elementwiseProd(throughput, bounceWeight) * rrFactor;
 
-    DoubleVec3D recursiveRadiance = traceRay(Ray(intersectionPoint, newDirection), nextEventEstimation && objectMaterial->worksWithNextEventEstimation(), intersection.kdTreeNode, bounces + 1);
-    result += rrFactor * objectMaterial->computeCurrentRadiance(recursiveRadiance, dotProd(newDirection, normal));
+    bool newCausticChain = !objectMaterial->worksWithNextEventEstimation() && (usedNextEventEstimation || causticChain);
+    DoubleVec3D recursiveRadiance = traceRay<useKDTree, useNextEventEstimation, useRussianRoulette>(Ray(intersectionPoint, newDirection), useNextEventEstimation && objectMaterial->worksWithNextEventEstimation(), intersection.kdTreeNode, bounces + 1, newDirectionPdf, newThroughput, newCausticChain, nullptr);
+    result += rrFactor * guidingFactor * objectMaterial->computeCurrentRadiance(recursiveRadiance, cosAngleNewDirectionNormal);
+
+    // Weighted by the cosine, so that the SD-tree learns where the light that matters for a diffuse bounce comes from
+    if (guidingTree != nullptr && currentSDTree->getTraining())
+        guidingTree->record(newDirection, cosAngleNewDirectionNormal * (recursiveRadiance.getX() + recursiveRadiance.getY() + recursiveRadiance.getZ()) / (3.0*newDirectionPdf));
 
     return result;
 }
 
+bool Scene::computeRadianceCacheRecord(const DoubleVec3D& point, const DoubleUnitVec3D& normal, const KDTreeNode* lastNode, unsigned int bounces, DoubleVec3D& radiance) const {  // private
+    if (currentRadianceCache->isFull())
+        return false;
+
+    RayCounters& rayCounters = RenderStatistics::getThreadCounters();
+    Sampler* sampler = Sampler::getThreadSampler();
+    if (sampler != nullptr)
+        sampler->setIndependentDoubles(true);  // Else, every gathering path would get the same numbers
+
+    DoubleVec3D radianceSum(0.0);
+    double inverseDistanceSum = 0.0;
+    for (unsigned int sample = 0; sample < RADIANCE_CACHE_RECORD_SAMPLES; sample++) {
+        DoubleUnitVec3D direction = randomCosineWeightedVectorOnHemisphere(normal);
+        Ray gatheringRay(point, direction);
+
+        // The distance to the first object seen in this direction gives the size of the region where the record is valid
+        rayCounters.secondaryRays++;
+        KDTreeNode::Intersection gatheringIntersection = findIntersection(gatheringRay, lastNode);
+        inverseDistanceSum += 1.0 / gatheringIntersection.distance;  // 0 if nothing is hit
+
+        double directionPdf = dotProd(direction, normal) / M_PI;
+        radianceSum += traceRay(gatheringRay, true, lastNode, bounces + 1, directionPdf);  // Deeper than the bounce at which the cache is used
+    }
+
+    if (sampler != nullptr)
+        sampler->setIndependentDoubles(false);
+
+    radiance = radianceSum / RADIANCE_CACHE_RECORD_SAMPLES;
+    double harmonicMeanDistance = (inverseDistanceSum > 0.0) ? RADIANCE_CACHE_RECORD_SAMPLES / inverseDistanceSum : INFINITY;
+    currentRadianceCache->addRecord(point, normal, radiance, harmonicMeanDistance);  // May fail if another thread filled the cache meanwhile, but the radiance is still right
+    return true;
+}
+
+PhotonMap* Scene::traceCausticPhotons() const {  // private
+    std::vector<Photon> photons;
+    if (lampPowersCdf.empty() || lampPowersCdf.back() <= 0.0)
+        return new PhotonMap(photons, causticPhotonRadius, getMinPoint(objects));
+
+    unsigned int samplerSeed = (unsigned int)(randomDouble() * UINT_MAX);
+#pragma omp parallel
+    {
+        Sampler* sampler = createSampler(samplerType, causticPhotons, samplerSeed);
+        Sampler::setThreadSampler(sampler);
+        std::vector<Photon> threadPhotons;
+
+#pragma omp for
+        for (int photon = 0; photon < (int)causticPhotons; photon++) {  // photon must be signed for OpenMP
+            sampler->startPixelSample(0, 0, photon);
+
+            startSamplerBounceGroup(0, SAMPLER_GROUP_LIGHT);
+            double lampPdf;
+            Object3D* lamp = sampleLamp(lampPdf);
+            DoubleVec3D point = lamp->getRandomPoint();
+
+            startSamplerBounceGroup(0, SAMPLER_GROUP_MATERIAL);
+            DoubleUnitVec3D normal = lamp->getNormal(point);
+            if (randomDouble() < 0.5)
+                normal = -normal;
+            Ray ray(point, randomCosineWeightedVectorOnHemisphere(normal));
+
+            // The lamps emit on both sides, with a cosine-weighted distribution: the pdf of the direction cancels out with the cosine
+            DoubleVec3D power = lamp->getMaterial()->getEmittance() * (2.0*M_PI*lamp->getArea()) / (lampPdf*causticPhotons);
+
+            const KDTreeNode* lastNode = nullptr;
+            for (unsigned int bounces = 1; bounces <= CAUSTIC_PHOTON_MAX_BOUNCES; bounces++) {
+                KDTreeNode::Intersection intersection = findIntersection(ray, lastNode);
+                if (intersection.object == nullptr)
+                    break;
+
+                Material* objectMaterial = intersection.object->getMaterial();
+                DoubleVec3D intersectionPoint = ray.getOrigin() + intersection.distance * ray.getDirection();
+                if (objectMaterial->worksWithNextEventEstimation()) {
+                    if (bounces > 1)  // Else, it is direct light, which is computed by next event estimation
+                        threadPhotons.push_back({ intersectionPoint, ray.getDirection(), power });
+                    break;
+                }
+
+                // Specular and refractive materials do not absorb light
+                startSamplerBounceGroup(bounces, SAMPLER_GROUP_MATERIAL);
+                DoubleUnitVec3D newDirection = objectMaterial->getNewDirection(ray, intersection.object->getNormal(intersectionPoint));
+                ray = Ray(intersectionPoint, newDirection);
+                lastNode = intersection.kdTreeNode;
+            }
+        }
+
+#pragma omp critical
+        photons.insert(photons.end(), threadPhotons.begin(), threadPhotons.end());
+
+        Sampler::setThreadSampler(nullptr);
+        delete sampler;
+    }
+
+    return new PhotonMap(photons, causticPhotonRadius, getMinPoint(objects));
+}
+
+Object3D* Scene::sampleLamp(double& pdf) const {  // private
+    double powerChoice = randomDouble() * lampPowersCdf.back();
+    unsigned int lampIndex = std::upper_bound(lampPowersCdf.begin(), lampPowersCdf.end(), powerChoice) - lampPowersCdf.begin();
+    lampIndex = std::min(lampIndex, (unsigned int)lamps.size() - 1);  // In case randomDouble() returned 1
+    pdf = getLampPdf(lamps[lampIndex]);
+    return lamps[lampIndex];
+}
+
+double Scene::getLampPdf(const Object3D* lamp) const {  // private
+    if (lampPowersCdf.empty() || lampPowersCdf.back() <= 0.0)
+        return 0.0;
+    return computeLampPower(lamp) / lampPowersCdf.back();
+}
+
+DoubleVec3D Scene::traceBidirectional(double pixelX, double pixelY) const {  // private
+    // Without russian roulette, the paths stop after minBounces bounces, like in traceRay()
+    unsigned int maxBounces = russianRoulette ? BIDIRECTIONAL_MAX_BOUNCES : minBounces;
+
+    // Camera subpath
+    std::vector<PathVertex> cameraPath;
+    Ray cameraRay = camera.getRayGoingThrough(pixelX, pixelY);
+    cameraPath.push_back(PathVertex(PATH_VERTEX_CAMERA, camera.getOrigin(), DoubleVec3D(1.0)));
+    generateSubpath(cameraRay, DoubleVec3D(1.0), camera.getImportancePdf(cameraRay.getDirection()), false, maxBounces + 2, cameraPath);
+
+    // Light subpath, whose numbers must not be the ones of the camera subpath
+    std::vector<PathVertex> lightPath;
+    Sampler* sampler = Sampler::getThreadSampler();
+    if (sampler != nullptr)
+        sampler->setIndependentDoubles(true);
+    if (!lampPowersCdf.empty() && lampPowersCdf.back() > 0.0) {
+        double lampPdf;
+        Object3D* lamp = sampleLamp(lampPdf);
+        DoubleVec3D point = lamp->getRandomPoint();
+        PathVertex lightVertex(PATH_VERTEX_LIGHT, point, lamp->getMaterial()->getEmittance() * lamp->getArea() / lampPdf);
+        lightVertex.object = lamp;
+        lightVertex.normal = lamp->getNormal(point);
+        lightVertex.pdfForward = lampPdf / lamp->getArea();
+        lightPath.push_back(lightVertex);
+
+        DoubleUnitVec3D emissionNormal = (randomDouble() < 0.5) ? lightVertex.normal : -lightVertex.normal;
+        DoubleUnitVec3D direction = randomCosineWeightedVectorOnHemisphere(emissionNormal);
+        double directionPdf = dotProd(direction, emissionNormal) / (2.0*M_PI);
+        generateSubpath(Ray(point, direction), lightVertex.beta * (2.0*M_PI), directionPdf, true, maxBounces + 1, lightPath);  // The cosine cancels out with the pdf
+    }
+    if (sampler != nullptr)
+        sampler->setIndependentDoubles(false);
+
+    // Every strategy links the s first vertices of the light subpath to the t first ones of the camera subpath
+    DoubleVec3D result(0.0);
+    for (unsigned int t = 1; t <= cameraPath.size(); t++) {
+        for (unsigned int s = 0; s <= lightPath.size(); s++) {
+            if (s + t < 2 || (s == 1 && t == 1) || s + t - 2 > maxBounces)
+                continue;
+
+            double lightPixelX, lightPixelY;
+            DoubleVec3D contribution = connectBidirectional(lightPath, cameraPath, s, t, lightPixelX, lightPixelY);
+            if (contribution.isZero())
+                continue;
+            contribution *= computeBidirectionalMisWeight(lightPath, cameraPath, s, t);
+
+            if (t == 1)
+                currentLightImage->splatValuePix((unsigned int)lightPixelX, (unsigned int)lightPixelY, contribution);
+            else
+                result += contribution;
+        }
+    }
+    STATISTICS_PATH_LENGTH(cameraPath.size() - 1);
+    return result;
+}
+
+void Scene::generateSubpath(const Ray& ray, const DoubleVec3D& beta, double directionPdf, bool lightSubpath, unsigned int maxVertices, std::vector<PathVertex>& path) const {  // private
+    RayCounters& rayCounters = RenderStatistics::getThreadCounters();
+    Ray currentRay = ray;
+    DoubleVec3D currentBeta = beta;
+
+    while (path.size() < maxVertices) {
+        if (!lightSubpath && path.size() == 1)
+            rayCounters.primaryRays++;
+        else
+            rayCounters.secondaryRays++;
+
+        KDTreeNode::Intersection intersection = findIntersection(currentRay, path.back().kdTreeNode);
+        if (intersection.object == nullptr)
+            return;
+        STATISTICS_INCREMENT(hits);
+
+        Material* objectMaterial = intersection.object->getMaterial();
+        PathVertex vertex(PATH_VERTEX_SURFACE, currentRay.getOrigin() + intersection.distance * currentRay.getDirection(), currentBeta);
+        vertex.object = intersection.object;
+        vertex.normal = intersection.object->getNormal(vertex.point);
+        vertex.kdTreeNode = intersection.kdTreeNode;
+        vertex.delta = !objectMaterial->worksWithNextEventEstimation();
+        vertex.pdfForward = path.back().convertDensity(directionPdf, vertex);
+        path.push_back(vertex);
+        if (path.size() >= maxVertices)
+            return;
+
+        // The camera is not a bounce, so the sampler groups are the ones of traceRay()
+        unsigned int bounces = lightSubpath ? path.size() - 1 : path.size() - 2;
+        if (bounces >= minBounces) {
+            startSamplerBounceGroup(bounces, SAMPLER_GROUP_RUSSIAN_ROULETTE);
+            if (randomDouble() < rrStopProbability) {
+                STATISTICS_INCREMENT(russianRouletteTerminations);
+                return;
+            }
+            currentBeta /= 1.0 - rrStopProbability;
+        }
+
+        startSamplerBounceGroup(bounces, SAMPLER_GROUP_MATERIAL);
+        DoubleUnitVec3D newDirection = objectMaterial->getNewDirection(currentRay, vertex.normal);
+        double reversePdf = 0.0;
+        if (vertex.delta)
+            directionPdf = 0.0;  // Specular and refractive materials keep the throughput
+        else {
+            directionPdf = objectMaterial->getDirectionPdf(currentRay, vertex.normal, newDirection);
+            if (directionPdf <= 0.0)
+                return;
+            DoubleUnitVec3D toPrevious = -currentRay.getDirection();
+            DoubleVec3D bsdf = lightSubpath ? vertex.getBsdf(newDirection, toPrevious) : vertex.getBsdf(toPrevious, newDirection);
+            currentBeta = elementwiseProd(currentBeta, bsdf) * std::abs(dotProd(newDirection, vertex.normal)) / directionPdf;
+            reversePdf = objectMaterial->getDirectionPdf(Ray(vertex.point, -newDirection), vertex.normal, toPrevious);
+        }
+        path[path.size() - 2].pdfReverse = vertex.convertDensity(reversePdf, path[path.size() - 2]);
+
+        if (currentBeta.isZero()) {
+            STATISTICS_INCREMENT(zeroThroughputTerminations);
+            return;
+        }
+        currentRay = Ray(vertex.point, newDirection);
+    }
+}
+
+DoubleVec3D Scene::connectBidirectional(const std::vector<PathVertex>& lightPath, const std::vector<PathVertex>& cameraPath, unsigned int s, unsigned int t, double& pixelX, double& pixelY) const {  // private
+    const PathVertex& cameraVertex = cameraPath[t - 1];
+    if (s == 0)  // The camera subpath hit a lamp by itself
+        return elementwiseProd(cameraVertex.beta, cameraVertex.object->getMaterial()->getEmittance());
+
+    const PathVertex& lightVertex = lightPath[s - 1];
+    if (!cameraVertex.isConnectible() || !lightVertex.isConnectible())
+        return DoubleVec3D(0.0);
+
+    DoubleVec3D toLight = lightVertex.point - cameraVertex.point;
+    double distance = length(toLight);
+    toLight /= distance;  // Normalised
+    double cosAngleLight = std::abs(dotProd(toLight, lightVertex.normal));
+
+    DoubleVec3D result;
+    if (t == 1) {
+        // Light tracing: the light subpath can be seen through any pixel
+        if (!camera.getPixelCoordinates(lightVertex.point, pixelX, pixelY))
+            return DoubleVec3D(0.0);
+        DoubleVec3D lightBsdf = lightVertex.getBsdf(-toLight, lightPath[s - 2].point - lightVertex.point);
+        result = elementwiseProd(lightVertex.beta, lightBsdf) * camera.getImportancePdf(toLight) * cosAngleLight / (distance*distance);
+    }
+    else {
+        DoubleVec3D cameraBsdf = cameraVertex.getBsdf(cameraPath[t - 2].point - cameraVertex.point, toLight);
+        DoubleVec3D lightBsdf = (s == 1) ? DoubleVec3D(1.0) : lightVertex.getBsdf(-toLight, lightPath[s - 2].point - lightVertex.point);  // The emittance is already in the beta of the lamp
+        double cosAngleCamera = std::abs(dotProd(toLight, cameraVertex.normal));
+        result = elementwiseProd(elementwiseProd(cameraVertex.beta, cameraBsdf), elementwiseProd(lightBsdf, lightVertex.beta)) * cosAngleCamera * cosAngleLight / (distance*distance);
+    }
+    if (result.isZero())
+        return result;
+
+    RenderStatistics::getThreadCounters().shadowRays++;
+    KDTreeNode::Intersection shadowRayIntersection = findIntersection(Ray(cameraVertex.point, toLight), cameraVertex.kdTreeNode);
+    if (distance - 0.00001 < shadowRayIntersection.distance && shadowRayIntersection.distance < distance + 0.00001) {
+        STATISTICS_INCREMENT(unoccludedShadowRays);
+        return result;
+    }
+    STATISTICS_INCREMENT(occludedShadowRays);
+    return DoubleVec3D(0.0);
+}
+
+double Scene::computeBidirectionalMisWeight(std::vector<PathVertex>& lightPath, std::vector<PathVertex>& cameraPath, unsigned int s, unsigned int t) const {  // private
+    if (s + t == 2)  // A single strategy can make this path
+        return 1.0;
+
+    PathVertex* cameraVertex = &cameraPath[t - 1];
+    PathVertex* cameraPrevious = (t > 1) ? &cameraPath[t - 2] : nullptr;
+    PathVertex* lightVertex = (s > 0) ? &lightPath[s - 1] : nullptr;
+    PathVertex* lightPrevious = (s > 1) ? &lightPath[s - 2] : nullptr;
+
+    // The densities around the link depend on the strategy, they are put back at the end
+    PathVertex* modifiedVertices[4] = { cameraVertex, cameraPrevious, lightVertex, lightPrevious };
+    double savedPdfs[4];
+    bool savedDeltas[4];
+    for (unsigned int vertex = 0; vertex < 4; vertex++) {
+        if (modifiedVertices[vertex] != nullptr) {
+            savedPdfs[vertex] = modifiedVertices[vertex]->pdfReverse;
+            savedDeltas[vertex] = modifiedVertices[vertex]->delta;
+        }
+    }
+
+    if (s == 0) {
+        cameraVertex->pdfReverse = getLampPdf(cameraVertex->object) / cameraVertex->object->getArea();
+        cameraPrevious->pdfReverse = getLightDirectionPdf(*cameraVertex, *cameraPrevious);
+    }
+    else {
+        if (t == 1)
+            lightVertex->pdfReverse = cameraVertex->convertDensity(camera.getImportancePdf(lightVertex->point - cameraVertex->point), *lightVertex);
+        else {
+            cameraVertex->pdfReverse = (s == 1) ? getLightDirectionPdf(*lightVertex, *cameraVertex) : lightVertex->getDirectionPdf(*lightPrevious, *cameraVertex);
+            cameraPrevious->pdfReverse = cameraVertex->getDirectionPdf(*lightVertex, *cameraPrevious);
+            lightVertex->pdfReverse = cameraVertex->getDirectionPdf(*cameraPrevious, *lightVertex);
+        }
+        if (lightPrevious != nullptr)
+            lightPrevious->pdfReverse = lightVertex->getDirectionPdf(*cameraVertex, *lightPrevious);
+        lightVertex->delta = false;
+    }
+    cameraVertex->delta = false;
+
+    // Ratios between the density of each other strategy and the one of this strategy. A density of 0 comes from a specular vertex, which is skipped
+    double sumRatios = 0.0;
+    double ratio = 1.0;
+    for (int vertex = (int)t - 1; vertex > 0; vertex--) {
+        ratio *= ((cameraPath[vertex].pdfReverse != 0.0) ? cameraPath[vertex].pdfReverse : 1.0) / ((cameraPath[vertex].pdfForward != 0.0) ? cameraPath[vertex].pdfForward : 1.0);
+        if (!cameraPath[vertex].delta && !cameraPath[vertex - 1].delta)
+            sumRatios += ratio;
+    }
+    ratio = 1.0;
+    for (int vertex = (int)s - 1; vertex >= 0; vertex--) {
+        ratio *= ((lightPath[vertex].pdfReverse != 0.0) ? lightPath[vertex].pdfReverse : 1.0) / ((lightPath[vertex].pdfForward != 0.0) ? lightPath[vertex].pdfForward : 1.0);
+        bool previousDelta = (vertex > 0) && lightPath[vertex - 1].delta;
+        if (!lightPath[vertex].delta && !previousDelta)
+            sumRatios += ratio;
+    }
+
+    for (unsigned int vertex = 0; vertex < 4; vertex++) {
+        if (modifiedVertices[vertex] != nullptr) {
+            modifiedVertices[vertex]->pdfReverse = savedPdfs[vertex];
+            modifiedVertices[vertex]->delta = savedDeltas[vertex];
+        }
+    }
+    return 1.0 / (1.0 + sumRatios);
+}
+
+double Scene::getLightDirectionPdf(const PathVertex& lightVertex, const PathVertex& next) const {  // private
+    DoubleUnitVec3D toNext = next.point - lightVertex.point;
+    return lightVertex.convertDensity(std::abs(dotProd(toNext, lightVertex.normal)) / (2.0*M_PI), next);
+}
+
+bool Scene::applyWavefrontRussianRoulette(WavefrontPath& path) const {  // private
+    if (path.bounces < minBounces)
+        return true;
+
+    startSamplerBounceGroup(path.bounces, SAMPLER_GROUP_RUSSIAN_ROULETTE);
+    double stopProbability = rrStopProbability;
+    if (rrThroughputBased) {
+        double maxThroughput = std::max(path.throughput.getX(), std::max(path.throughput.getY(), path.throughput.getZ()));
+        stopProbability = std::max(rrStopProbability, 1.0 - maxThroughput);
+    }
+    if (!russianRoulette || randomDouble() < stopProbability) {
+        STATISTICS_INCREMENT(russianRouletteTerminations);
+        STATISTICS_PATH_LENGTH(path.bounces);
+        return false;
+    }
+    path.throughput /= 1.0 - stopProbability;
+    return true;
+}
+
+template <class MaterialType>
+void Scene::shadeWavefrontHits(std::vector<WavefrontPath>& paths, const unsigned int* hits, unsigned int numberHits, const std::vector<Sampler*>& samplers, std::vector<std::vector<WavefrontShadowRay>>& threadShadowRays) const {  // private
+    bool useMultipleImportanceSampling = nextEventEstimation && multipleImportanceSampling;
+
+#pragma omp parallel for
+    for (int hit = 0; hit < (int)numberHits; hit++) {  // hit must be signed for OpenMP
+        WavefrontPath& path = paths[hits[hit]];
+        Sampler* sampler = samplers[omp_get_thread_num()];
+        Sampler::setThreadSampler(sampler);
+        sampler->resumePixelSample(path.pixelX, path.pixelY, path.sample, path.bounces);
+
+        // The known materials are final classes, so the compiler can call their methods directly
+        const MaterialType* objectMaterial = static_cast<const MaterialType*>(path.intersection.object->getMaterial());
+        DoubleVec3D intersectionPoint = path.ray.getOrigin() + path.intersection.distance * path.ray.getDirection();
+        DoubleUnitVec3D normal = path.intersection.object->getNormal(intersectionPoint);
+
+        // Same computations as in traceRay(), but the shadow rays are only generated
+        if (nextEventEstimation && objectMaterial->worksWithNextEventEstimation()) {
+            startSamplerBounceGroup(path.bounces, SAMPLER_GROUP_LIGHT);
+            for (Object3D* lamp : lamps) {
+                double lightPdf;
+                DoubleVec3D pointOnLamp = lamp->sampleLightPoint(intersectionPoint, lightPdf);
+                DoubleVec3D intersectionToLamp = pointOnLamp - intersectionPoint;
+                if (dotProd(normal, intersectionToLamp) <= -0.0001)
+                    continue;
+
+                WavefrontShadowRay shadowRay;
+                shadowRay.distance = length(intersectionToLamp);
+                intersectionToLamp /= shadowRay.distance;
+                shadowRay.ray = Ray(intersectionPoint, intersectionToLamp);
+                shadowRay.kdTreeNode = path.intersection.kdTreeNode;
+                shadowRay.path = hits[hit];
+
+                double misWeight = 1.0;
+                if (useMultipleImportanceSampling)
+                    misWeight = powerHeuristic(lightPdf, objectMaterial->getDirectionPdf(path.ray, normal, intersectionToLamp));
+                DoubleVec3D lampRadiance = objectMaterial->computeCurrentRadiance(lamp->getMaterial()->getEmittance(), dotProd(intersectionToLamp, normal), true);
+                shadowRay.contribution = elementwiseProd(path.throughput, lampRadiance) * misWeight / lightPdf;
+                threadShadowRays[omp_get_thread_num()].push_back(shadowRay);
+            }
+        }
+
+        DoubleVec3D emittance = objectMaterial->getEmittance();
+        if (!nextEventEstimation || !path.usedNextEventEstimation)
+            path.radiance += elementwiseProd(path.throughput, emittance);
+        else if (useMultipleImportanceSampling && !emittance.isZero())
+            path.radiance += powerHeuristic(path.lastDirectionPdf, path.intersection.object->getLightPdf(path.ray.getOrigin(), intersectionPoint)) * elementwiseProd(path.throughput, emittance);
+
+        startSamplerBounceGroup(path.bounces, SAMPLER_GROUP_MATERIAL);
+        DoubleUnitVec3D newDirection = objectMaterial->getNewDirection(path.ray, normal);
+        DoubleVec3D bounceWeight = objectMaterial->computeCurrentRadiance(DoubleVec3D(1.0), dotProd(newDirection, normal));
+        if (bounceWeight.isZero()) {
+            STATISTICS_INCREMENT(zeroThroughputTerminations);
+            STATISTICS_PATH_LENGTH(path.bounces + 1);
+            path.active = false;
+            continue;
+        }
+
+        path.lastDirectionPdf = useMultipleImportanceSampling ? objectMaterial->getDirectionPdf(path.ray, normal, newDirection) : 0.0;
+        path.usedNextEventEstimation = nextEventEstimation && objectMaterial->worksWithNextEventEstimation();
+        path.throughput = elementwiseProd(path.throughput, bounceWeight);
+        path.ray = Ray(intersectionPoint, newDirection);
+        path.bounces++;
+        path.active = applyWavefrontRussianRoulette(path);
+    }
+}
+
+void Scene::traceWavefrontPass(Picture* result, const std::vector<Sampler*>& samplers, unsigned int passBeginningSample, unsigned int passEndSample, bool verbose, double loopBeginningTime) const {  // private
+    unsigned int pictureWidth = camera.getNumberPixelsX();
+    unsigned int pictureHeight = camera.getNumberPixelsY();
+    unsigned int passSamples = passEndSample - passBeginningSample;
+    unsigned long long numberPaths = (unsigned long long)pictureWidth * pictureHeight * passSamples;  // Can exceed the range of unsigned int for big pictures
+
+    // Allocated once for all the waves
+    std::vector<WavefrontPath> paths((size_t)std::min<unsigned long long>(numberPaths, WAVEFRONT_QUEUE_SIZE));
+    std::vector<unsigned int> activePaths;
+    std::vector<unsigned int> sortedHits;
+    std::vector<unsigned char> hitKinds;
+    std::vector<std::vector<WavefrontShadowRay>> threadShadowRays(numberThreads);
+    std::vector<WavefrontShadowRay> shadowRays;
+
+    for (unsigned long long waveBeginning = 0; waveBeginning < numberPaths; waveBeginning += WAVEFRONT_QUEUE_SIZE) {
+        unsigned long long waveSize = std::min<unsigned long long>(numberPaths - waveBeginning, WAVEFRONT_QUEUE_SIZE);
+
+        // Camera rays. The samples of a pixel are next to each other, so that the pixels are written in the same order as without wavefront
+#pragma omp parallel for
+        for (int pathIndex = 0; pathIndex < (int)waveSize; pathIndex++) {  // pathIndex must be signed for OpenMP
+            Sampler* sampler = samplers[omp_get_thread_num()];
+            Sampler::setThreadSampler(sampler);
+
+            WavefrontPath& path = paths[pathIndex];
+            path = WavefrontPath();
+            unsigned int pixelIndex = (unsigned int)((waveBeginning + pathIndex) / passSamples);
+            path.pixelX = pixelIndex / pictureHeight;
+            path.pixelY = pixelIndex % pictureHeight;
+            path.sample = passBeginningSample + (unsigned int)((waveBeginning + pathIndex) % passSamples);
+
+            sampler->startPixelSample(path.pixelX, path.pixelY, path.sample);
+            double pixelX = path.pixelX + randomDouble();
+            double pixelY = path.pixelY + randomDouble();
+            path.ray = camera.getRayGoingThrough(pixelX, pixelY);
+            path.active = applyWavefrontRussianRoulette(path);
+        }
+
+        activePaths.clear();
+        for (unsigned int pathIndex = 0; pathIndex < waveSize; pathIndex++) {
+            if (paths[pathIndex].active)
+                activePaths.push_back(pathIndex);
+        }
+
+        while (!activePaths.empty()) {
+            // Extension of every active ray through the k-d tree, without any shading in between
+#pragma omp parallel for
+            for (int activePath = 0; activePath < (int)activePaths.size(); activePath++) {  // activePath must be signed for OpenMP
+                WavefrontPath& path = paths[activePaths[activePath]];
+                RayCounters& rayCounters = RenderStatistics::getThreadCounters();
+                if (path.bounces == 0)
+                    rayCounters.primaryRays++;
+                else
+                    rayCounters.secondaryRays++;
+                path.intersection = findIntersection(path.ray, path.intersection.kdTreeNode);  // nullptr for camera rays
+            }
+
+            // Counting sort of the hits by kind of material, the misses end their path
+            unsigned int bucketBeginnings[MATERIAL_KIND_NUMBER + 1] = {};
+            hitKinds.resize(activePaths.size());
+            for (unsigned int activePath = 0; activePath < activePaths.size(); activePath++) {
+                WavefrontPath& path = paths[activePaths[activePath]];
+                if (path.intersection.object == nullptr) {
+                    STATISTICS_PATH_LENGTH(path.bounces);
+                    path.active = false;
+                    continue;
+                }
+                STATISTICS_INCREMENT(hits);
+                hitKinds[activePath] = getMaterialKind(path.intersection.object->getMaterial());
+                bucketBeginnings[hitKinds[activePath] + 1]++;
+            }
+            for (unsigned int kind = 0; kind < MATERIAL_KIND_NUMBER; kind++)
+                bucketBeginnings[kind + 1] += bucketBeginnings[kind];
+
+            sortedHits.resize(bucketBeginnings[MATERIAL_KIND_NUMBER]);
+            unsigned int nextPositions[MATERIAL_KIND_NUMBER];
+            std::copy(bucketBeginnings, bucketBeginnings + MATERIAL_KIND_NUMBER, nextPositions);
+            for (unsigned int activePath = 0; activePath < activePaths.size(); activePath++) {
+                if (paths[activePaths[activePath]].active)
+                    sortedHits[nextPositions[hitKinds[activePath]]++] = activePaths[activePath];
+            }
+
+            // Shading, one kind of material after the other
+            shadeWavefrontHits<DiffuseMaterial>(paths, sortedHits.data() + bucketBeginnings[MATERIAL_KIND_DIFFUSE], bucketBeginnings[MATERIAL_KIND_DIFFUSE + 1] - bucketBeginnings[MATERIAL_KIND_DIFFUSE], samplers, threadShadowRays);
+            shadeWavefrontHits<SpecularMaterial>(paths, sortedHits.data() + bucketBeginnings[MATERIAL_KIND_SPECULAR], bucketBeginnings[MATERIAL_KIND_SPECULAR + 1] - bucketBeginnings[MATERIAL_KIND_SPECULAR], samplers, threadShadowRays);
+            shadeWavefrontHits<RefractiveMaterial>(paths, sortedHits.data() + bucketBeginnings[MATERIAL_KIND_REFRACTIVE], bucketBeginnings[MATERIAL_KIND_REFRACTIVE + 1] - bucketBeginnings[MATERIAL_KIND_REFRACTIVE], samplers, threadShadowRays);
+            shadeWavefrontHits<Material>(paths, sortedHits.data() + bucketBeginnings[MATERIAL_KIND_OTHER], bucketBeginnings[MATERIAL_KIND_OTHER + 1] - bucketBeginnings[MATERIAL_KIND_OTHER], samplers, threadShadowRays);
+
+            // Shadow rays of every path of the stage
+            shadowRays.clear();
+            for (std::vector<WavefrontShadowRay>& currentThreadShadowRays : threadShadowRays) {
+                shadowRays.insert(shadowRays.end(), currentThreadShadowRays.begin(), currentThreadShadowRays.end());
+                currentThreadShadowRays.clear();
+            }
+
+#pragma omp parallel for
+            for (int shadowRayIndex = 0; shadowRayIndex < (int)shadowRays.size(); shadowRayIndex++) {  // shadowRayIndex must be signed for OpenMP
+                WavefrontShadowRay& shadowRay = shadowRays[shadowRayIndex];
+                RenderStatistics::getThreadCounters().shadowRays++;
+                KDTreeNode::Intersection shadowRayIntersection = findIntersection(shadowRay.ray, shadowRay.kdTreeNode);
+                shadowRay.unoccluded = shadowRay.distance - 0.00001 < shadowRayIntersection.distance && shadowRayIntersection.distance < shadowRay.distance + 0.00001;
+                if (shadowRay.unoccluded)
+                    STATISTICS_INCREMENT(unoccludedShadowRays);
+                else
+                    STATISTICS_INCREMENT(occludedShadowRays);
+            }
+            for (const WavefrontShadowRay& shadowRay : shadowRays) {  // Not in parallel, as a path can have several shadow rays
+                if (shadowRay.unoccluded)
+                    paths[shadowRay.path].radiance += shadowRay.contribution;
+            }
+
+            unsigned int numberActivePaths = 0;
+            for (unsigned int pathIndex : activePaths) {
+                if (paths[pathIndex].active)
+                    activePaths[numberActivePaths++] = pathIndex;
+            }
+            activePaths.resize(numberActivePaths);
+        }
+
+        for (unsigned int pathIndex = 0; pathIndex < waveSize; pathIndex++)
+            result->addValuePix(paths[pathIndex].pixelX, paths[pathIndex].pixelY, paths[pathIndex].radiance / samplesPerPixel);  // Every pass has the same weight per sample
+
+        if (verbose)  // Counted in columns of one sample, like without wavefront
+            displayRenderingProgression(passBeginningSample*pictureWidth + (unsigned int)((waveBeginning + waveSize) / pictureHeight), samplesPerPixel*pictureWidth, loopBeginningTime);
+    }
+}
+
 void displayRenderingProgression(unsigned int numberPixelXAlreadyComputed, unsigned int pictureWidth, double loopBeginningTime) {
     // Cannot be put in a thread -> else time estimation is completely wrong at the beginning of long renders
     // Don't want to redraw the whole picture for speed
@@ -351,48 +1270,215 @@ void displayRenderingProgression(unsigned int numberPixelXAlreadyComputed, unsig
               << "s        ";
 }
 
+double computeLampPower(const Object3D* lamp) {
+    DoubleVec3D emittance = lamp->getMaterial()->getEmittance();
+    return 2.0*M_PI*lamp->getArea()*(emittance.getX() + emittance.getY() + emittance.getZ()) / 3.0;
+}
+
+double powerHeuristic(double pdf, double otherPdf) {
+    if (pdf == INFINITY)
+        return 1.0;
+    double squaredPdf = pdf*pdf;
+    double squaredPdfSum = squaredPdf + otherPdf*otherPdf;
+    if (squaredPdfSum == 0.0)
+        return 0.0;
+    return squaredPdf / squaredPdfSum;
+}
+
 
 // Render method
-Picture* Scene::render() {
-    computeObjectsAndLamps();
+std::string Scene::getIgnoredOptionsWarning() const {
+    if (!wavefrontPathTracing || bidirectionalPathTracing)
+        return "";
+
+    std::vector<std::string> ignoredOptions;
+    if (radianceCache && nextEventEstimation)
+        ignoredOptions.push_back("radiance cache");
+    if (pathGuiding)
+        ignoredOptions.push_back("path guiding");
+    if (causticPhotonMapping && nextEventEstimation)
+        ignoredOptions.push_back("caustic photon mapping");
+    if (ignoredOptions.empty())
+        return "";
+
+    std::string warning = "Warning: wavefront path tracing does not use the ";
+    for (unsigned int i = 0; i < ignoredOptions.size(); i++) {
+        if (i > 0)
+            warning += (i + 1 == ignoredOptions.size()) ? " and the " : ", the ";
+        warning += ignoredOptions[i];
+    }
+    return warning + ", which will be ignored during this render.";
+}
+
+Picture* Scene::render(bool verbose /*= true*/) {
+    // Nothing built from the objects is kept if an object group changed since the previous render
+    if (objectsGeneration != objectGroupsGeneration) {
+        computeObjectsAndLamps();
+        releaseAccelerationStructures();
+        objectsGeneration = objectGroupsGeneration;
+    }
 
     unsigned int pictureWidth = camera.getNumberPixelsX();
     unsigned int pictureHeight = camera.getNumberPixelsY();
     omp_set_num_threads(numberThreads);
-    showCMDCursor(false);
+    bool useKDTree = kdTree && !sbvh;  // The SBVH replaces the k-d tree
+
+    // The acceleration structure of the previous render is kept if it is still used with the same settings
+    bool sameKDTreeSettings = kdMaxObjectNumber == kdTreeSettingMaxObjectNumber && kdMaxDepth == kdTreeSettingMaxDepth && kdLazyBuild == kdTreeLazy && kdAutoParameters == kdTreeAutoParameters && kdCalibration == kdTreeCalibration;
+    if (kdTreeRoot != nullptr && (!useKDTree || !sameKDTreeSettings)) {
+        kdTreeArena.release();
+        kdTreeRoot = nullptr;
+        kdTreeMaxObjectNumber = 0;
+        kdTreeMaxDepth = 0;
+    }
+    if (currentSBVH != nullptr && (!sbvh || sbvhAlpha != currentSBVHAlpha)) {
+        delete currentSBVH;
+        currentSBVH = nullptr;
+    }
+    bool reuseKDTree = kdTreeRoot != nullptr;
+    bool reuseSBVH = currentSBVH != nullptr;
 
     // Print information
-    clearScreenPrintHeader();
-    displayParametersPage(false);
-    std::cout << "Objects" << std::endl;
-    std::cout << DASH_SPLITTER << std::endl;
-    std::cout << "Number of objects = " << objects.size() << std::endl;
-    std::cout << "Number of objects emitting light = " << lamps.size() << std::endl;
-    std::cout << std::endl;
-    std::cout << STAR_SPLITTER << std::endl;
-    std::cout << std::endl;
+    if (verbose) {
+        showCMDCursor(false);
+        clearScreenPrintHeader();
+        displayParametersPage(false);
+        std::cout << "Objects" << std::endl;
+        std::cout << DASH_SPLITTER << std::endl;
+        std::cout << "Number of objects = " << objects.size() << std::endl;
+        std::cout << "Number of objects emitting light = " << lamps.size() << std::endl;
+        std::cout << std::endl;
+        std::string ignoredOptionsWarning = getIgnoredOptionsWarning();
+        if (!ignoredOptionsWarning.empty())
+            std::cout << ignoredOptionsWarning << std::endl << std::endl;
+        std::cout << STAR_SPLITTER << std::endl;
+        std::cout << std::endl;
+    }
+
+    // Before the backup, so that it records the chosen values next to the settings. A kept tree was built with them.
+    if (useKDTree && !reuseKDTree && kdAutoParameters) {
+        if (verbose)
+            std::cout << "Choosing the k-d tree parameters...";
+        double parametersBeginningTime = getCurrentTimeSeconds();
+        chooseKDTreeParameters();
+        if (verbose)
+            std::cout << "\rSuccessfully chose a k-d tree maximum depth of " << kdTreeMaxDepth << " and a maximum number of objects in a leaf of " << kdTreeMaxObjectNumber << " in " << getCurrentTimeSeconds() - parametersBeginningTime << " seconds." << std::endl;
+    }
+    else if (useKDTree && !reuseKDTree) {
+        kdTreeMaxObjectNumber = kdMaxObjectNumber;
+        kdTreeMaxDepth = kdMaxDepth;
+    }
 
     if (backupParameters) {
-        std::cout << "Backing up parameters...";
+        if (verbose)
+            std::cout << "Backing up parameters...";
         double parametersBackupBeginningTime = getCurrentTimeSeconds();
         std::string parametersBackupFileName = formatFileName(backupFileName, PARAMETERS_SAVE_EXTENSION);
         saveParameters2File(parametersBackupFileName);
-        std::cout << "\rSuccessfully backed up parameters to " << parametersBackupFileName << " in " << getCurrentTimeSeconds() - parametersBackupBeginningTime << " seconds." << std::endl;
+        if (verbose)
+            std::cout << "\rSuccessfully backed up parameters to " << parametersBackupFileName << " in " << getCurrentTimeSeconds() - parametersBackupBeginningTime << " seconds." << std::endl;
     }
 
     if (backupObjectGroups) {
-        std::cout << "Backing up object groups...";
+        if (verbose)
+            std::cout << "Backing up object groups...";
         double objectGroupsBackupBeginningTime = getCurrentTimeSeconds();
         std::string objectGroupsBackupFileName = formatFileName(backupFileName, OBJECTS_SAVE_EXTENSION);
         saveObjectGroups2File(objectGroupsBackupFileName);
-        std::cout << "\rSuccessfully backed up object groups to " << objectGroupsBackupFileName << " in " << getCurrentTimeSeconds() - objectGroupsBackupBeginningTime << " seconds." << std::endl;
+        if (verbose)
+            std::cout << "\rSuccessfully backed up object groups to " << objectGroupsBackupFileName << " in " << getCurrentTimeSeconds() - objectGroupsBackupBeginningTime << " seconds." << std::endl;
     }
 
-    if (kdTree) {
-        std::cout << "Creating a k-d tree...";
+    kdTreeCreationTime = 0.0;
+    bool useKDTreeCache = useKDTree && kdTreeCache && !kdLazyBuild;  // A lazy tree is never complete
+    if (!reuseKDTree)
+        kdTreeArena.setSynchronised(useKDTree && kdLazyBuild);  // The render threads split the lazy nodes together
+    if (reuseKDTree) {
+        if (verbose)
+            std::cout << "The objects did not change, the k-d tree of the previous render is used again." << std::endl;
+    }
+    else if (useKDTreeCache) {
+        if (verbose)
+            std::cout << "Loading the k-d tree from its cache file...";
         double kdTreeBeginningTime = getCurrentTimeSeconds();
-        kdTreeRoot = new KDTreeNode(objects, kdMaxObjectNumber, kdMaxDepth);
-        std::cout << "\rSuccessfully created a k-d tree in " << getCurrentTimeSeconds() - kdTreeBeginningTime << " seconds. Its maximum depth is " << kdTreeRoot->getMaxDepth() << " and the maximum number of objects in a single leaf is " << kdTreeRoot->getMaxObjectNumberLeaf() << "." << std::endl;
+        unsigned long long kdTreeCacheKey = computeKDTreeCacheKey(objects, kdTreeMaxObjectNumber, kdTreeMaxDepth);
+        std::string kdTreeCacheFileName = getKDTreeCacheFileName(kdTreeCacheKey);
+        kdTreeRoot = loadKDTreeCache(kdTreeCacheFileName, kdTreeCacheKey, objects, kdTreeArena);
+        if (kdTreeRoot != nullptr) {
+            kdTreeCreationTime = getCurrentTimeSeconds() - kdTreeBeginningTime;
+            if (verbose)
+                std::cout << "\rSuccessfully loaded a k-d tree from " << kdTreeCacheFileName << " in " << kdTreeCreationTime << " seconds." << std::endl;
+        }
+        else {
+            if (verbose)
+                std::cout << "\rNo k-d tree was saved for these objects and parameters, it will be built and saved to " << kdTreeCacheFileName << "." << std::endl;
+            kdTreeRoot = new (kdTreeArena) KDTreeNode(objects, kdTreeMaxObjectNumber, kdTreeMaxDepth, kdTreeArena);
+            kdTreeCreationTime = getCurrentTimeSeconds() - kdTreeBeginningTime;
+            bool saved = saveKDTreeCache(*kdTreeRoot, objects, kdTreeCacheKey, kdTreeCacheFileName);
+            if (verbose && saved)
+                std::cout << "Successfully created and saved a k-d tree in " << getCurrentTimeSeconds() - kdTreeBeginningTime << " seconds." << std::endl;
+            else if (verbose)
+                std::cout << "Successfully created a k-d tree in " << kdTreeCreationTime << " seconds, but it could not be saved to " << kdTreeCacheFileName << "." << std::endl;
+        }
+    }
+    else if (useKDTree) {
+        if (verbose)
+            std::cout << "Creating a k-d tree...";
+        double kdTreeBeginningTime = getCurrentTimeSeconds();
+        kdTreeRoot = new (kdTreeArena) KDTreeNode(objects, kdTreeMaxObjectNumber, kdTreeMaxDepth, kdTreeArena, nullptr, 0, kdLazyBuild);
+        kdTreeCreationTime = getCurrentTimeSeconds() - kdTreeBeginningTime;
+        if (verbose && kdLazyBuild)
+            std::cout << "\rSuccessfully created the root of a lazy k-d tree in " << kdTreeCreationTime << " seconds. The other nodes will be built when rays first enter them." << std::endl;
+        else if (verbose)
+            std::cout << "\rSuccessfully created a k-d tree in " << kdTreeCreationTime << " seconds. Its maximum depth is " << kdTreeRoot->getMaxDepth() << " and the maximum number of objects in a single leaf is " << kdTreeRoot->getMaxObjectNumberLeaf() << "." << std::endl;
+    }
+    if (useKDTree) {
+        kdTreeSettingMaxObjectNumber = kdMaxObjectNumber;
+        kdTreeSettingMaxDepth = kdMaxDepth;
+        kdTreeLazy = kdLazyBuild;
+        kdTreeAutoParameters = kdAutoParameters;
+        kdTreeCalibration = kdCalibration;
+    }
+
+    sbvhCreationTime = 0.0;
+    if (!sbvh) {
+        sbvhDuplicatedReferences = 0;
+        sbvhSAHCost = 0.0;
+    }
+    else if (reuseSBVH) {
+        if (verbose)
+            std::cout << "The objects did not change, the SBVH of the previous render is used again." << std::endl;
+    }
+    else {
+        if (verbose)
+            std::cout << "Creating an SBVH...";
+        double sbvhBeginningTime = getCurrentTimeSeconds();
+        currentSBVH = new SBVH(objects, sbvhAlpha);
+        currentSBVHAlpha = sbvhAlpha;
+        sbvhCreationTime = getCurrentTimeSeconds() - sbvhBeginningTime;
+        sbvhDuplicatedReferences = currentSBVH->getDuplicatedReferences();
+        sbvhSAHCost = currentSBVH->getSAHCost();
+        if (verbose)
+            std::cout << "\rSuccessfully created an SBVH of " << currentSBVH->getNodeNumber() << " nodes in " << sbvhCreationTime << " seconds. The spatial splits duplicated " << sbvhDuplicatedReferences << " references and its SAH cost is " << sbvhSAHCost << "." << std::endl;
+    }
+
+    // Chosen once, instead of checking the parameters at every bounce
+    currentTraceRay = selectTraceRay();
+
+    // Bidirectional and wavefront path tracing do not use them
+    bool wavefront = wavefrontPathTracing && !bidirectionalPathTracing;
+    if (radianceCache && nextEventEstimation && !bidirectionalPathTracing && !wavefront)
+        currentRadianceCache = new RadianceCache(radianceCacheErrorThreshold, radianceCacheMaxRecords, getMinPoint(objects), getMaxPoint(objects));  // Filled during the render
+    if (pathGuiding && !bidirectionalPathTracing && !wavefront)
+        currentSDTree = new SDTree(getMinPoint(objects), getMaxPoint(objects));
+
+    if (causticPhotonMapping && nextEventEstimation && !bidirectionalPathTracing && !wavefront) {
+        if (verbose)
+            std::cout << "Tracing caustic photons...";
+        double photonsBeginningTime = getCurrentTimeSeconds();
+        currentCausticPhotonMap = traceCausticPhotons();
+        if (verbose)
+            std::cout << "\rSuccessfully traced caustic photons in " << getCurrentTimeSeconds() - photonsBeginningTime << " seconds. " << currentCausticPhotonMap->getNumberPhotons() << " of them reached a diffuse object through a specular one." << std::endl;
     }
     /*
     json jsonOutput = *kdTreeRoot;
@@ -403,50 +1489,174 @@ Picture* Scene::render() {
     */
 
     // Compute picture
-    std::cout << "Allocating memory for the picture...";
+    if (verbose)
+        std::cout << "Allocating memory for the picture...";
     double pictureMemoryAllocationBeginningTime = getCurrentTimeSeconds();
     Picture* result = new Picture(camera.getNumberPixelsX(), camera.getNumberPixelsY());
-    std::cout << "\rSuccessfully allocated memory for the picture in " << getCurrentTimeSeconds() - pictureMemoryAllocationBeginningTime  << " seconds." << std::endl << std::endl;
+    if (bidirectionalPathTracing)
+        currentLightImage = new Picture(camera.getNumberPixelsX(), camera.getNumberPixelsY());
+    if (verbose) {
+        std::cout << "\rSuccessfully allocated memory for the picture in " << getCurrentTimeSeconds() - pictureMemoryAllocationBeginningTime  << " seconds." << std::endl << std::endl;
+        std::cout << "Computing time estimation...";  // That's a lie. We're juste waiting for one iteration of the loop
+    }
+
+    // One sampler per thread, seeded by the global random engine so that setRandomSeed() makes renders reproducible
+    unsigned int samplerSeed = (unsigned int)(randomDouble() * UINT_MAX);
+    std::vector<Sampler*> samplers;
+    for (unsigned int thread = 0; thread < numberThreads; thread++)
+        samplers.push_back(createSampler(samplerType, samplesPerPixel, samplerSeed));
 
-    std::cout << "Computing time estimation...";  // That's a lie. We're juste waiting for one iteration of the loop
+    // Packets need the k-d tree, and bidirectional and wavefront path tracing generate their camera rays themselves
+    unsigned int packetSize = 1;
+    if (useKDTree && !bidirectionalPathTracing && !wavefront)
+        packetSize = std::max(1u, std::min(rayPacketSize, RAY_PACKET_MAX_SIZE));
+
+    RenderStatistics::reset(numberThreads);
     double loopBeginningTime = getCurrentTimeSeconds();
+    // Without path guiding, there is a single pass. Else, every pass has twice as many samples as the previous one, and the SD-tree learns between them
+    unsigned int passBeginningSample = 0;
+    unsigned int passSamples = (currentSDTree != nullptr) ? 1 : samplesPerPixel;
+    while (passBeginningSample < samplesPerPixel) {
+        passSamples = std::min(passSamples, samplesPerPixel - passBeginningSample);
+        unsigned int passEndSample = passBeginningSample + passSamples;
+        if (currentSDTree != nullptr)
+            currentSDTree->setTraining(passEndSample < samplesPerPixel);
+
+        if (wavefront)
+            traceWavefrontPass(result, samplers, passBeginningSample, passEndSample, verbose, loopBeginningTime);
+        else {
 // "#pragma omp parallel for schedule(dynamic)" can be put here, but it makes the time estimation go weird (as a thread can go faster than another)
-    for (unsigned int pixelX = 0; pixelX < pictureWidth; pixelX++) { 
+            for (unsigned int pixelX = 0; pixelX < pictureWidth; pixelX++) { 
 #pragma omp parallel for
-        for (int pixelY = 0; pixelY < pictureHeight; pixelY++) {  // pixelY must be signed for OpenMP
-            result->setValuePix(pixelX, pixelY, DoubleVec3D(0.0));
-            for (unsigned int sample = 0; sample < samplesPerPixel; sample++) {
-                Ray currentRay = camera.getRayGoingThrough(pixelX + randomDouble(), pixelY + randomDouble());
-                result->addValuePix(pixelX, pixelY, traceRay(currentRay) / samplesPerPixel);
+                for (int pixelY = 0; pixelY < pictureHeight; pixelY++) {  // pixelY must be signed for OpenMP
+                    // Threads work on different rows, which never share a cache line in the picture
+                    Sampler* sampler = samplers[omp_get_thread_num()];
+                    Sampler::setThreadSampler(sampler);
+
+                    DoubleVec3D pixelValue(0.0);
+                    if (packetSize > 1) {
+                        for (unsigned int packetBeginningSample = passBeginningSample; packetBeginningSample < passEndSample; packetBeginningSample += packetSize) {
+                            unsigned int numberRays = std::min(packetSize, passEndSample - packetBeginningSample);
+                            double pixelsX[RAY_PACKET_MAX_SIZE];
+                            double pixelsY[RAY_PACKET_MAX_SIZE];
+                            for (unsigned int ray = 0; ray < numberRays; ray++) {
+                                sampler->startPixelSample(pixelX, pixelY, packetBeginningSample + ray);
+                                pixelsX[ray] = pixelX + randomDouble();
+                                pixelsY[ray] = pixelY + randomDouble();
+                            }
+                            RayPacket packet = camera.getRayPacketGoingThrough(pixelsX, pixelsY, numberRays);
+                            KDTreeNode::Intersection intersections[RAY_PACKET_MAX_SIZE];
+                            kdTreeRoot->getPacketIntersections(packet, intersections);
+
+                            for (unsigned int ray = 0; ray < numberRays; ray++) {
+                                // Drawing the offsets again puts the sampler back where it was after generating this ray
+                                sampler->startPixelSample(pixelX, pixelY, packetBeginningSample + ray);
+                                randomDouble();
+                                randomDouble();
+                                pixelValue += traceRay(packet.getRay(ray), false, nullptr, 0, 0.0, DoubleVec3D(1.0), false, &intersections[ray]);
+                            }
+                        }
+                    }
+                    else {
+                        for (unsigned int sample = passBeginningSample; sample < passEndSample; sample++) {
+                            sampler->startPixelSample(pixelX, pixelY, sample);
+                            if (bidirectionalPathTracing)
+                                pixelValue += traceBidirectional(pixelX + randomDouble(), pixelY + randomDouble());
+                            else {
+                                Ray currentRay = camera.getRayGoingThrough(pixelX + randomDouble(), pixelY + randomDouble());
+                                pixelValue += traceRay(currentRay);
+                            }
+                        }
+                    }
+                    result->addValuePix(pixelX, pixelY, pixelValue / samplesPerPixel);  // Every pass has the same weight per sample
+                }
+                if (verbose)  // Counted in columns of one sample, as a pass takes a time proportional to its number of samples
+                    displayRenderingProgression(passBeginningSample*pictureWidth + (pixelX + 1)*passSamples, samplesPerPixel*pictureWidth, loopBeginningTime);
             }
         }
-        displayRenderingProgression(pixelX + 1, pictureWidth, loopBeginningTime);
+
+        if (currentSDTree != nullptr && currentSDTree->getTraining())
+            currentSDTree->learn();
+        passBeginningSample = passEndSample;
+        passSamples *= 2;
+    }
+
+    if (currentLightImage != nullptr) {
+        // Every sample traced one light subpath, which can be seen through any pixel
+        double numberLightSubpaths = (double)pictureWidth * pictureHeight * samplesPerPixel;
+        for (unsigned int pixelY = 0; pixelY < pictureHeight; pixelY++) {
+            for (unsigned int pixelX = 0; pixelX < pictureWidth; pixelX++)
+                result->addValuePix(pixelX, pixelY, currentLightImage->getValuePix(pixelX, pixelY) / numberLightSubpaths);
+        }
+        delete currentLightImage;
+        currentLightImage = nullptr;
     }
 
     double renderTime = getCurrentTimeSeconds() - loopBeginningTime;
     result->setRenderTime(renderTime);
 
-    std::cout << std::endl << std::endl;
+#pragma omp parallel
+    Sampler::setThreadSampler(nullptr);  // randomDouble() uses the global random engine again
+    for (Sampler* sampler : samplers)
+        delete sampler;
+    rayCounters = RenderStatistics::getTotal();
+
+    if (verbose) {
+        std::cout << std::endl << std::endl;
+        RenderStatistics::printTotal(renderTime);
+        if (currentRadianceCache != nullptr)
+            std::cout << "The radiance cache contains " << currentRadianceCache->getNumberRecords() << " records." << std::endl << std::endl;
+        if (currentSDTree != nullptr)
+            std::cout << "The SD-tree learned during " << currentSDTree->getNumberPasses() << " passes and has " << currentSDTree->getNumberSpatialLeaves() << " regions." << std::endl << std::endl;
+    }
+
+    if (backupParameters) {
+        // Next to the parameters, so that both can be compared between renders
+        std::string statisticsBackupFileName = formatFileName(backupFileName, STATISTICS_SAVE_EXTENSION);
+        RenderStatistics::saveTotal2File(statisticsBackupFileName);
+        if (verbose)
+            std::cout << "Successfully saved the statistics to " << statisticsBackupFileName << "." << std::endl << std::endl;
+    }
 
     if (backupPicture && renderTime > leastRenderTime4PictureBackup) {
         double beginningTime = getCurrentTimeSeconds();
-        std::cout << "Backing up the picture...";
+        if (verbose)
+            std::cout << "Backing up the picture...";
 
         std::string pictureBackupFileName = formatFileName(backupFileName, PICTURE_SAVE_EXTENSION_JSON);
+        result->save2File(pictureBackupFileName);
 
-        json jsonOutput = *result;
-        std::ofstream file;
-        file.open(pictureBackupFileName);
-        file << std::setw(4) << jsonOutput << std::endl;
-        file.close();
+        if (verbose)
+            std::cout << "\rSuccessfully backed up the picture to " << pictureBackupFileName << " in " << getCurrentTimeSeconds() - beginningTime << " seconds." << std::endl << std::endl;
+    }
 
-        std::cout << "\rSuccessfully backed up the picture to " << pictureBackupFileName << " in " << getCurrentTimeSeconds() - beginningTime << " seconds." << std::endl << std::endl;
+    kdTreeBuiltNodes = 0;
+    kdTreeUnbuiltNodes = 0;
+    if (useKDTree) {
+        kdTreeBuiltNodes = kdTreeRoot->getBuiltNodeNumber();
+        kdTreeUnbuiltNodes = kdTreeRoot->getUnbuiltNodeNumber();
+        if (verbose && kdLazyBuild)
+            std::cout << "The lazy k-d tree built " << kdTreeBuiltNodes << " nodes (" << 100.0 * kdTreeBuiltNodes / (kdTreeBuiltNodes + kdTreeUnbuiltNodes) << "% of the nodes it knows), " << kdTreeUnbuiltNodes << " subtrees were never entered by a ray." << std::endl << std::endl;
     }
+    // The k-d tree and the SBVH are kept for the next render, see the beginning of this function
 
-    if (kdTree)
-        delete kdTreeRoot;
+    if (currentRadianceCache != nullptr) {
+        delete currentRadianceCache;
+        currentRadianceCache = nullptr;
+    }
+
+    if (currentSDTree != nullptr) {
+        delete currentSDTree;
+        currentSDTree = nullptr;
+    }
 
-    showCMDCursor(true);
+    if (currentCausticPhotonMap != nullptr) {
+        delete currentCausticPhotonMap;
+        currentCausticPhotonMap = nullptr;
+    }
+
+    if (verbose)
+        showCMDCursor(true);
     return result;
 }
 
@@ -481,10 +1691,35 @@ void Scene::displayParametersPage(bool displayIndexes /*= true*/) const {
     std::cout << getCurrentIndex(index++, displayIndexes) + "Number of CPU threads = " << numberThreads << std::endl;
     std::cout << getCurrentIndex(index++, displayIndexes) + "Russian roulette = " << bool2string(russianRoulette) << std::endl;
     std::cout << getCurrentIndex(index++, displayIndexes) + "Rr stop probability = " << rrStopProbability << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Rr based on throughput = " << bool2string(rrThroughputBased) << std::endl;
     std::cout << getCurrentIndex(index++, displayIndexes) + "Next event estimation = " << bool2string(nextEventEstimation) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Multiple importance sampling = " << bool2string(multipleImportanceSampling) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Sampler = " << samplerType2string(samplerType) << std::endl;
     std::cout << getCurrentIndex(index++, displayIndexes) + "K-d tree = " << bool2string(kdTree) << std::endl;
-    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d maximum depth = " << kdMaxDepth << std::endl;
-    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d maximum object number = " << kdMaxObjectNumber << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d maximum depth = " << kdMaxDepth;
+    if (kdTreeMaxDepth != 0 && kdTreeMaxDepth != kdMaxDepth)
+        std::cout << " (" << kdTreeMaxDepth << " chosen by the last render)";
+    std::cout << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d maximum object number = " << kdMaxObjectNumber;
+    if (kdTreeMaxObjectNumber != 0 && kdTreeMaxObjectNumber != kdMaxObjectNumber)
+        std::cout << " (" << kdTreeMaxObjectNumber << " chosen by the last render)";
+    std::cout << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d automatic parameters = " << bool2string(kdAutoParameters) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d calibration = " << bool2string(kdCalibration) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d lazy build = " << bool2string(kdLazyBuild) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "K-d tree cache = " << bool2string(kdTreeCache) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "SBVH = " << bool2string(sbvh) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "SBVH alpha = " << sbvhAlpha << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Radiance cache = " << bool2string(radianceCache) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Radiance cache error threshold = " << radianceCacheErrorThreshold << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Radiance cache maximum records = " << radianceCacheMaxRecords << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Path guiding = " << bool2string(pathGuiding) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Caustic photon mapping = " << bool2string(causticPhotonMapping) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Caustic photons = " << causticPhotons << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Caustic photon radius = " << causticPhotonRadius << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Bidirectional path tracing = " << bool2string(bidirectionalPathTracing) << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Ray packet size = " << rayPacketSize << std::endl;
+    std::cout << getCurrentIndex(index++, displayIndexes) + "Wavefront path tracing = " << bool2string(wavefrontPathTracing) << std::endl;
     std::cout << std::endl;
 
     std::cout << "Backup parameters" << std::endl;
@@ -4,10 +4,19 @@
 #include <omp.h>
 
 #include "DoubleMatrix33.h"
+#include "KDTreeCache.h"
 #include "KDTreeNode.h"
+#include "PathVertex.h"
 #include "Object3DGroup.h"
 #include "PerspectiveCamera.h"
+#include "PhotonMap.h"
 #include "Picture.h"
+#include "RadianceCache.h"
+#include "SBVH.h"
+#include "SDTree.h"
+#include "RenderStatistics.h"
+#include "Sampler.h"
+#include "WavefrontPath.h"
 
 #include <fbxsdk.h>
 #include <fbxsdk/fileio/fbxiosettings.h>
@@ -18,6 +27,9 @@
     \file Scene.h
     \brief Defines the Scene class and some functions around it.
 
+    \var constexpr unsigned int KD_CALIBRATION_PATHS
+    \brief Number of paths traced with every candidate k-d tree during the calibration. They go through pixels spread evenly on the picture.
+
     \class Scene
     \brief Stores object groups and a camera for the render.
 
@@ -31,12 +43,16 @@
     \brief Copy constructor.
     \param scene The scene that will be copied.
 
+    \fn Scene::~Scene()
+    \brief Destructor. Deletes the k-d tree and the SBVH kept from the last render.
+
     \fn std::vector<Object3DGroup> Scene::getObjectGroups()
     \brief Getter for the object groups.
     \return This scene's object groups.
 
     \fn std::vector<Object3DGroup>& Scene::getObjectGroupsReference()
     \brief Getter for a reference to the object groups.
+    \details The groups must be modified through the methods of this scene, such as Scene::modifyObjectGroup(), which tell the next render that the objects changed. The changes made through the reference are not seen by a render that keeps the objects of the previous one.
     \return A reference to this scene's object groups.
 
     \fn std::vector<Object3D*> Scene::getObjects()
@@ -45,6 +61,12 @@
     \return This scene's objects.
     \sa split()
 
+    \fn MemoryArena& Scene::getGeometryArena()
+    \brief Getter for the arena in which imported objects are allocated.
+    \details Objects and materials created by the fbx importer and the json loader are allocated contiguously in this arena. Their object groups know it, see Object3DGroup::getArena(). It is released by Scene::resetAndDeleteObjectGroups().
+    \return A reference to this scene's geometry arena.
+    \sa MemoryArena
+
     \fn std::vector<Object3D*> Scene::getLamps()
     \brief Getter for the lamps.
     \details Calls computeObjectsAndLamps().
@@ -81,11 +103,28 @@
     \return The russian roulette stop probability.
     \sa Scene::Scene(), Scene::getRussianRoulette()
 
+    \fn bool Scene::getRrThroughputBased()
+    \brief Getter for the throughput-based russian roulette.
+    \details If true, a path is stopped with a probability of 1 minus the largest coordinate of its throughput (the product of the weights of its previous bounces), but at least with the russian roulette stop probability. Hence, dark paths are stopped sooner than bright ones.
+    \return Whether the russian roulette depends on the throughput of the path.
+    \sa Scene::getRrStopProbability()
+
     \fn bool Scene::getNextEventEstimation()
     \brief Getter for the next event estimation.
     \details See my TM's report for further information on this algorithm.
     \return Whether the next event estimation algorithm will be used during the render.
 
+    \fn bool Scene::getMultipleImportanceSampling()
+    \brief Getter for the multiple importance sampling.
+    \details Only has an effect if the next event estimation is used.
+    \return Whether the lamps hit by the rays sampled by the materials are weighted against the next event estimation with the power heuristic, instead of being ignored.
+    \sa Scene::getNextEventEstimation(), powerHeuristic()
+
+    \fn SamplerType Scene::getSamplerType()
+    \brief Getter for the sampler type.
+    \return The sampler that will give the random numbers during the render.
+    \sa Sampler
+
     \fn unsigned int Scene::getNumberThreads()
     \brief Getter for the number of CPU threads.
     \return The number of threads that will be used on the CPU during the render.
@@ -108,6 +147,103 @@
     \return The maximum number of recursive steps of the k-d tree.
     \sa Scene::getKDTree(), Scene::getKDMaxObjectNumber()
 
+    \fn bool Scene::getKDAutoParameters()
+    \brief Getter for the automatic k-d tree parameters.
+    \details If true, render() builds the k-d tree with a maximum depth of 8 + 1.3*log2(N), rounded, where N is the number of objects, instead of Scene::getKDMaxDepth(). A fixed depth would else give leaves that hold a huge number of objects in big scenes. The setting itself is not changed, the chosen values are given by Scene::getKDTreeMaxDepth() and Scene::getKDTreeMaxObjectNumber().
+    \return Whether the maximum depth of the k-d tree will be derived from the number of objects.
+    \sa Scene::getKDMaxDepth(), Scene::getKDCalibration()
+
+    \fn bool Scene::getKDCalibration()
+    \brief Getter for the k-d tree calibration.
+    \details Only used with the automatic k-d tree parameters. If true, render() also builds k-d trees with depths around the automatic one and leaf sizes around Scene::getKDMaxObjectNumber(), times KD_CALIBRATION_PATHS paths spread on the picture with each of them, and keeps the fastest parameters.
+    \return Whether the k-d tree parameters will be calibrated before the render.
+    \sa Scene::getKDAutoParameters()
+
+    \fn bool Scene::getKDLazyBuild()
+    \brief Getter for the lazy construction of the k-d tree.
+    \details If true, render() only creates the root of the k-d tree, and every node is split the first time a ray enters it. The first pixels come sooner, and the objects that no ray gets close to, such as the parts of a huge scene outside a tight camera, are never split. The tree that is built is the same as the full one, apart from a few useless leaves that the full one removes.
+    \return Whether the k-d tree will be built lazily.
+    \sa KDTreeNode, Scene::getKDTreeBuiltNodes()
+
+    \fn bool Scene::getKDTreeCache()
+    \brief Getter for the k-d tree cache.
+    \details If true, render() looks for a file named after the key of the k-d tree it is about to build (see computeKDTreeCacheKey()), and loads the tree from it instead of building it. Else, the tree is built and saved to this file. Scenes rendered again with other cameras, lamps or materials then skip the construction. A lazy k-d tree is never complete, so it is neither loaded nor saved.
+    \return Whether the k-d tree will be saved to and loaded from cache files.
+    \sa KDTreeCache.h
+
+    \fn bool Scene::getSBVH()
+    \brief Getter for the SBVH.
+    \details If true, a bounding volume hierarchy with spatial splits is built before the render and replaces the k-d tree. It suits scenes mixing huge and tiny triangles, such as imported buildings, where the k-d tree would duplicate the huge ones in many leaves. Ray packets and the backwards traversal from the last node need the k-d tree, so they are not used with it.
+    \return Whether an SBVH will be used during the render.
+    \sa SBVH, Scene::getSBVHAlpha()
+
+    \fn double Scene::getSBVHAlpha()
+    \brief Getter for the overlap budget of the SBVH.
+    \details Spatial splits are only looked for in the nodes whose best object split gives children overlapping by more than alpha times the surface of the root. Smaller values give more spatial splits, hence faster traversals but more duplicated references.
+    \return The overlap budget of the SBVH.
+    \sa Scene::getSBVH()
+
+    \fn bool Scene::getRadianceCache()
+    \brief Getter for the radiance cache.
+    \details When a path hits a diffuse object right after a first diffuse bounce, the indirect light is interpolated from the radiance cache instead of continuing the path. The direct light is still computed with the next event estimation, so the cache is only used if the next event estimation is. This is biased, but much faster in diffuse scenes, which is useful for previews.
+    \return Whether a radiance cache will be used during the render.
+    \sa RadianceCache, Scene::getRadianceCacheErrorThreshold(), Scene::getRadianceCacheMaxRecords()
+
+    \fn double Scene::getRadianceCacheErrorThreshold()
+    \brief Getter for the error threshold of the radiance cache.
+    \details Smaller values give more accurate pictures, but need more records, which are long to compute.
+    \return The largest error with which a record of the radiance cache can be used.
+    \sa Scene::getRadianceCache()
+
+    \fn unsigned int Scene::getRadianceCacheMaxRecords()
+    \brief Getter for the maximum number of records of the radiance cache.
+    \details Once the cache is full, the paths are continued where no record can be used.
+    \return The maximum number of records of the radiance cache.
+    \sa Scene::getRadianceCache()
+
+    \fn bool Scene::getPathGuiding()
+    \brief Getter for the path guiding.
+    \details If true, the render is split into passes with doubling numbers of samples per pixel. The paths learn the radiance arriving in every region of the scene, and the bounces on diffuse objects are sampled from a mixture of the material and of what was learned during the previous passes. This helps a lot when the light comes through small openings.
+    \return Whether path guiding will be used during the render.
+    \sa SDTree
+
+    \fn bool Scene::getCausticPhotonMapping()
+    \brief Getter for the caustic photon mapping.
+    \details If true, photons are traced from the lamps before the render, and the ones that reach a diffuse object through specular or refractive objects are stored in a photon map. Then, the caustics on a diffuse object are estimated from the photons around it, instead of waiting for a path to hit a lamp through the specular objects. This is biased (the caustics are a bit blurred), but converges much faster. Only has an effect if the next event estimation is used.
+    \return Whether caustics will be computed with a photon map during the render.
+    \sa PhotonMap, Scene::getCausticPhotons(), Scene::getCausticPhotonRadius()
+
+    \fn unsigned int Scene::getCausticPhotons()
+    \brief Getter for the number of caustic photons.
+    \return The number of photons that will be emitted by the lamps. Only the ones reaching a diffuse object through specular objects are stored.
+    \sa Scene::getCausticPhotonMapping()
+
+    \fn double Scene::getCausticPhotonRadius()
+    \brief Getter for the radius of the caustic photon estimation.
+    \details A smaller radius gives sharper but noisier caustics.
+    \return The distance up to which the photons are used around a point.
+    \sa Scene::getCausticPhotonMapping()
+
+    \fn bool Scene::getBidirectionalPathTracing()
+    \brief Getter for the bidirectional path tracing.
+    \details If true, every sample traces a subpath from the camera and one from a lamp, and links all their vertices together. The contributions are weighted with multiple importance sampling (with the balance heuristic). The vertices of the light subpath seen by the camera are added to the pixel in which they are seen, which makes caustics and light coming through small openings converge much faster.
+    The next event estimation, the multiple importance sampling, the radiance cache, the path guiding and the caustic photon mapping are not used by bidirectional path tracing. Without russian roulette, the paths stop after minBounces bounces.
+    \return Whether the render will use bidirectional path tracing instead of path tracing.
+    \sa PathVertex, Scene::traceBidirectional()
+
+    \fn unsigned int Scene::getRayPacketSize()
+    \brief Getter for the size of the packets of primary rays.
+    \details If it is greater than 1, the rays of consecutive samples of a pixel are generated together and go through the k-d tree as a packet, before each of them continues its path alone. This is only done with a k-d tree, and not with bidirectional path tracing. 4, 8 and 16 are the usual sizes; bigger values are used as RAY_PACKET_MAX_SIZE.
+    \return The number of primary rays that are traced together, 1 if they are traced one by one.
+    \sa RayPacket, KDTreeNode::getPacketIntersections()
+
+    \fn bool Scene::getWavefrontPathTracing()
+    \brief Getter for the wavefront path tracing.
+    \details If true, the paths are not traced one after the other. A wave of paths is kept in a queue: all their rays go through the k-d tree, then the hits are sorted by kind of material and shaded, and finally all the shadow rays are traced. This is repeated until every path of the wave has ended. The result is the same as with traceRay(), but each stage runs the same code on many paths in a row.
+    The radiance cache, the path guiding and the caustic photon mapping are not used by wavefront path tracing, and bidirectional path tracing has the priority over it. The ray packets are not used either.
+    \return Whether the paths will be traced in waves instead of one by one.
+    \sa WavefrontPath, Scene::traceWavefrontPass(), Scene::getIgnoredOptionsWarning()
+
     \fn std::string Scene::getBackupFileName()
     \brief Getter for the name of the file in which backups will be made.
     \details Every backup will be done with the same file name, but using a different file extension.
@@ -132,6 +268,52 @@
     \return The least render time after which the picture is backed up.
     \sa Scene::getBackupPicture()
 
+    \fn double Scene::getKDTreeCreationTime()
+    \brief Getter for the time it took to create the k-d tree during the last render.
+    \return The creation time in seconds, or 0 if no k-d tree was created. With the lazy construction, only the root is created before the render. A k-d tree kept from the previous render is not created again.
+
+    \fn unsigned int Scene::getKDTreeMaxObjectNumber()
+    \brief Getter for the maximum number of objects in a leaf with which the current k-d tree was built.
+    \details It is Scene::getKDMaxObjectNumber(), unless the calibration chose another one.
+    \return The chosen maximum number of objects in a k-d tree leaf, or 0 if there is no k-d tree.
+    \sa Scene::getKDCalibration()
+
+    \fn unsigned int Scene::getKDTreeMaxDepth()
+    \brief Getter for the maximum depth with which the current k-d tree was built.
+    \details It is Scene::getKDMaxDepth(), unless it was chosen from the number of objects.
+    \return The chosen maximum depth of the k-d tree, or 0 if there is no k-d tree.
+    \sa Scene::getKDAutoParameters()
+
+    \fn unsigned int Scene::getKDTreeBuiltNodes()
+    \brief Getter for the number of k-d tree nodes that were built during the last render.
+    \return The number of built nodes, or 0 if no k-d tree was used.
+    \sa Scene::getKDLazyBuild(), KDTreeNode::getBuiltNodeNumber()
+
+    \fn unsigned int Scene::getKDTreeUnbuiltNodes()
+    \brief Getter for the number of nodes of the lazy k-d tree that no ray entered during the last render.
+    \details Each of them is a subtree that was never split.
+    \return The number of unbuilt nodes, 0 if the tree was not lazy or if no k-d tree was used.
+    \sa Scene::getKDLazyBuild(), KDTreeNode::getUnbuiltNodeNumber()
+
+    \fn double Scene::getSBVHCreationTime()
+    \brief Getter for the time it took to create the SBVH during the last render.
+    \return The creation time in seconds, or 0 if no SBVH was created. An SBVH kept from the previous render is not created again.
+
+    \fn unsigned int Scene::getSBVHDuplicatedReferences()
+    \brief Getter for the number of references that the spatial splits of the SBVH added during the last render.
+    \return The number of duplicated references, or 0 if no SBVH was used.
+    \sa SBVH::getDuplicatedReferences()
+
+    \fn double Scene::getSBVHSAHCost()
+    \brief Getter for the cost of the SBVH of the last render with the surface area heuristic.
+    \return The SAH cost, or 0 if no SBVH was used.
+    \sa SBVH::getSAHCost()
+
+    \fn RayCounters Scene::getRayCounters()
+    \brief Getter for the numbers of rays traced during the last render.
+    \return The counters of all threads, merged.
+    \sa RenderStatistics
+
     \fn void Scene::setObjectGroups(std::vector<Object3DGroup> groups)
     \brief Setter for the object groups.
     \param groups The new object groups of this scene.
@@ -168,11 +350,26 @@
     \param rrStopProbability The new russian roulette stop probability that will be used during the render.
     \sa Scene::Scene().
 
+    \fn void Scene::setRrThroughputBased(bool rrThroughputBased)
+    \brief Setter for the throughput-based russian roulette.
+    \param rrThroughputBased Whether the russian roulette will depend on the throughput of the path.
+    \sa Scene::getRrThroughputBased()
+
     \fn void Scene::setNextEventEstimation(bool nextEventEstimation)
     \brief Setter for the next event estimation.
     \details See my TM's report for further information on this algorithm.
     \param nextEventEstimation Whether the next event estimation algorithm will be used during the render.
 
+    \fn void Scene::setMultipleImportanceSampling(bool multipleImportanceSampling)
+    \brief Setter for the multiple importance sampling.
+    \details Only has an effect if the next event estimation is used.
+    \param multipleImportanceSampling Whether the lamps hit by the rays sampled by the materials will be weighted against the next event estimation with the power heuristic, instead of being ignored.
+
+    \fn void Scene::setSamplerType(SamplerType samplerType)
+    \brief Setter for the sampler type.
+    \param samplerType The sampler that will give the random numbers during the render.
+    \sa Sampler
+
     \fn void Scene::setNumberThreads(unsigned int numberThreads)
     \brief Setter for the number of CPU threads.
     \param numberThreads The new number of threads that will be used on the CPU during the render.
@@ -195,6 +392,86 @@
     \param kdMaxDepth The new maximum number of recursive steps of the k-d tree.
     \sa Scene::setKDTree(bool kdTree), Scene::setKDMaxObjectNumber(unsigned int kdMaxObjectNumber)
 
+    \fn void Scene::setKDAutoParameters(bool kdAutoParameters)
+    \brief Setter for the automatic k-d tree parameters.
+    \param kdAutoParameters Whether the maximum depth of the k-d tree will be derived from the number of objects.
+    \sa Scene::getKDAutoParameters()
+
+    \fn void Scene::setKDCalibration(bool kdCalibration)
+    \brief Setter for the k-d tree calibration.
+    \param kdCalibration Whether the k-d tree parameters will be calibrated before the render.
+    \sa Scene::getKDCalibration()
+
+    \fn void Scene::setKDLazyBuild(bool kdLazyBuild)
+    \brief Setter for the lazy construction of the k-d tree.
+    \param kdLazyBuild Whether the k-d tree nodes will only be split when a ray first enters them.
+    \sa Scene::getKDLazyBuild()
+
+    \fn void Scene::setKDTreeCache(bool kdTreeCache)
+    \brief Setter for the k-d tree cache.
+    \param kdTreeCache Whether the k-d tree will be saved to and loaded from cache files.
+    \sa Scene::getKDTreeCache()
+
+    \fn void Scene::setSBVH(bool sbvh)
+    \brief Setter for the SBVH.
+    \param sbvh Whether an SBVH will be used during the render, instead of the k-d tree.
+    \sa Scene::getSBVH()
+
+    \fn void Scene::setSBVHAlpha(double sbvhAlpha)
+    \brief Setter for the overlap budget of the SBVH.
+    \param sbvhAlpha The new overlap budget, between 0 (spatial splits are looked for everywhere) and 1 (never).
+    \sa Scene::getSBVHAlpha()
+
+    \fn void Scene::setRadianceCache(bool radianceCache)
+    \brief Setter for the radiance cache.
+    \param radianceCache Whether a radiance cache will be used during the render.
+    \sa Scene::getRadianceCache()
+
+    \fn void Scene::setRadianceCacheErrorThreshold(double radianceCacheErrorThreshold)
+    \brief Setter for the error threshold of the radiance cache.
+    \param radianceCacheErrorThreshold The new largest error with which a record of the radiance cache can be used.
+    \sa Scene::getRadianceCacheErrorThreshold()
+
+    \fn void Scene::setRadianceCacheMaxRecords(unsigned int radianceCacheMaxRecords)
+    \brief Setter for the maximum number of records of the radiance cache.
+    \param radianceCacheMaxRecords The new maximum number of records of the radiance cache.
+    \sa Scene::getRadianceCacheMaxRecords()
+
+    \fn void Scene::setPathGuiding(bool pathGuiding)
+    \brief Setter for the path guiding.
+    \param pathGuiding Whether path guiding will be used during the render.
+    \sa Scene::getPathGuiding()
+
+    \fn void Scene::setCausticPhotonMapping(bool causticPhotonMapping)
+    \brief Setter for the caustic photon mapping.
+    \param causticPhotonMapping Whether caustics will be computed with a photon map during the render.
+    \sa Scene::getCausticPhotonMapping()
+
+    \fn void Scene::setCausticPhotons(unsigned int causticPhotons)
+    \brief Setter for the number of caustic photons.
+    \param causticPhotons The new number of photons that will be emitted by the lamps.
+    \sa Scene::getCausticPhotons()
+
+    \fn void Scene::setCausticPhotonRadius(double causticPhotonRadius)
+    \brief Setter for the radius of the caustic photon estimation.
+    \param causticPhotonRadius The new distance up to which the photons are used around a point.
+    \sa Scene::getCausticPhotonRadius()
+
+    \fn void Scene::setBidirectionalPathTracing(bool bidirectionalPathTracing)
+    \brief Setter for the bidirectional path tracing.
+    \param bidirectionalPathTracing Whether the render will use bidirectional path tracing instead of path tracing.
+    \sa Scene::getBidirectionalPathTracing()
+
+    \fn void Scene::setRayPacketSize(unsigned int rayPacketSize)
+    \brief Setter for the size of the packets of primary rays.
+    \param rayPacketSize The number of primary rays that will be traced together, 1 to trace them one by one.
+    \sa Scene::getRayPacketSize()
+
+    \fn void Scene::setWavefrontPathTracing(bool wavefrontPathTracing)
+    \brief Setter for the wavefront path tracing.
+    \param wavefrontPathTracing Whether the paths will be traced in waves instead of one by one.
+    \sa Scene::getWavefrontPathTracing()
+
     \fn void Scene::setBackupFileName(std::string backupFileName);
     \brief Setter for the new name of the file in which backups will be made.
     \details Every backup will be done with the same file name, but using a different file extension.
@@ -202,7 +479,7 @@
 
     \fn void Scene::setBackupParameters(bool backupParameters);
     \brief Setter for the option to backup the parameters.
-    \param backupParameters Whether the parameters will be backed up before the render.
+    \param backupParameters Whether the parameters will be backed up before the render. If so, the statistics of the render are also saved next to them after the render.
 
     \fn void Scene::setBackupObjectGroups(bool backupObjectGroups);
     \brief Setter for the option to backup the object groups.
@@ -223,19 +500,205 @@
     \brief Adds an object group to the current ones.
     \param group The object group that will be added.
 
+    \fn void Scene::modifyObjectGroup(unsigned int index)
+    \brief Lets the user modify an object group interactively.
+    \param index The index of the object group.
+    \sa Object3DGroup::modify()
+
+    \fn void Scene::deleteObjectGroup(unsigned int index)
+    \brief Deletes an object group and its objects.
+    \param index The index of the object group.
+    \sa Object3DGroup::resetAndDeleteObjects()
+
+    \fn void Scene::mergeObjectGroups(unsigned int index1, unsigned int index2, const std::string& name)
+    \brief Replaces two object groups by a group containing the objects of both.
+    \details The merged group is put after the other groups. If only one of them is in the geometry arena, both are moved to it first.
+    \param index1 The index of the first object group.
+    \param index2 The index of the second object group. Must be different from the first one.
+    \param name The name of the merged group.
+    \sa Object3DGroup::merge()
+
     \fn void Scene::resetAndDeleteObjectGroups()
     \brief Deletes all object groups and their objects.
-    \sa Object3DGroup::resetAndDeleteObjects()
+    \details Only the groups on the heap delete their objects one by one. The destructors of the objects in the geometry arena are not called, the arena is released in one go.
+    \sa Object3DGroup::resetAndDeleteObjects(), Scene::getGeometryArena()
+
+    \fn void Scene::addObjectGroupsFromJson(const json& j)
+    \brief Adds the object groups stored in json to the current ones.
+    \details The objects and their materials are allocated in the geometry arena.
+    \param j Json input, in the format written by Scene::saveObjectGroups2File().
+    \sa importObject3DGroupFromJson(), Scene::getGeometryArena()
+
+    \fn KDTreeNode::Intersection Scene::findIntersection(const Ray& ray, const KDTreeNode* lastNode)
+    \brief Computes the intersection of a ray with the objects, with the k-d tree if it is used.
+    \param ray The ray.
+    \param lastNode The k-d tree node in which the origin of the ray is, nullptr if it is unknown.
+    \return The intersection.
+    \sa Scene::bruteForceIntersection(), KDTreeNode::getIntersectionForward(), KDTreeNode::getIntersectionWithRopes()
+
+    \fn KDTreeNode::Intersection Scene::findIntersection<useKDTree>(const Ray& ray, const KDTreeNode* lastNode)
+    \brief Computes the intersection of a ray with the objects, the use of the k-d tree being known at compile time.
+    \details Used by the variants of Scene::traceRay(), which do not need to check the parameters for every ray.
+    \param ray The ray.
+    \param lastNode The k-d tree node in which the origin of the ray is. It must not be nullptr if useKDTree is true: the root can be given instead.
+    \return The intersection.
+
+    \typedef Scene::TraceRayFunction
+    \brief A pointer to one of the variants of Scene::traceRay().
+
+    \fn void Scene::chooseKDTreeParameters()
+    \brief Chooses the maximum depth of the k-d tree from the number of objects and, if asked, calibrates the depth and the leaf size.
+    \details The chosen values are stored in kdTreeMaxDepth and kdTreeMaxObjectNumber, the settings are not changed. The calibration tries the depths from 6 below the automatic one to 2 above it, then half and twice the leaf size of the settings with the best depth. It uses its own sampler, so that the render is not changed by it.
+    \sa Scene::getKDAutoParameters(), Scene::getKDCalibration()
+
+    \fn double Scene::timeKDTreeCalibrationPaths(unsigned int maxObjectNumber, unsigned int maxDepth)
+    \brief Builds a k-d tree with the given parameters and measures the time taken by the calibration paths.
+    \details The tree is freed before returning.
+    \param maxObjectNumber The maximum number of objects in a leaf.
+    \param maxDepth The maximum depth.
+    \return The time taken to trace KD_CALIBRATION_PATHS paths, in seconds.
+
+    \fn Scene::TraceRayFunction Scene::selectTraceRay()
+    \brief Chooses the variant of Scene::traceRay() that matches the k-d tree, next event estimation and russian roulette parameters.
+    \return A pointer to the variant.
+
+    \fn DoubleVec3D Scene::traceRay(const Ray& ray, double usedNextEventEstimation = false, const KDTreeNode* lastNode = nullptr, unsigned int bounces = 0, double lastDirectionPdf = 0.0, const DoubleVec3D& throughput = DoubleVec3D(1.0), bool causticChain = false, const KDTreeNode::Intersection* knownIntersection = nullptr)
+    \brief Computes the radiance coming back along a ray, with the variant of Scene::traceRay() chosen by render().
+    \details If the k-d tree is used and lastNode is nullptr, the variant starts from the root.
+    \sa Scene::selectTraceRay()
+
+    \fn DoubleVec3D Scene::traceRay<useKDTree, useNextEventEstimation, useRussianRoulette>(const Ray& ray, double usedNextEventEstimation, const KDTreeNode* lastNode, unsigned int bounces, double lastDirectionPdf, const DoubleVec3D& throughput, bool causticChain, const KDTreeNode::Intersection* knownIntersection)
+    \brief Computes the radiance coming back along a ray with path tracing, recursively.
+    \details The k-d tree, next event estimation and russian roulette parameters are template parameters, so that each of the eight variants only contains the code it needs. The recursive calls stay in the same variant.
+    \param ray The ray.
+    \param usedNextEventEstimation Whether next event estimation was used at the origin of the ray, so that the emittance of the lamps is not counted twice.
+    \param lastNode The k-d tree node in which the origin of the ray is.
+    \param bounces The number of bounces done before this ray.
+    \param lastDirectionPdf The probability density with which the direction of the ray was sampled, for multiple importance sampling.
+    \param throughput The throughput of the path up to this ray, used by the russian roulette.
+    \param causticChain Whether the path went through specular or refractive objects only since the last diffuse one.
+    \param knownIntersection The intersection of the ray if it is already known, as for the rays traced as packets. nullptr else.
+    \return The radiance.
+
+    \fn PhotonMap* Scene::traceCausticPhotons()
+    \brief Traces photons from the lamps and stores the ones that reach a diffuse object through specular or refractive objects.
+    \details The lamps emit photons proportionally to their power. The photons are traced in parallel, with the sampler of the render.
+    \return A pointer to the new photon map. It must be deleted by the caller.
+    \sa Scene::getCausticPhotonMapping()
+
+    \fn Object3D* Scene::sampleLamp(double& pdf)
+    \brief Chooses a lamp proportionally to its power.
+    \param pdf Filled with the probability with which the lamp was chosen.
+    \return The lamp.
+    \warning There must be at least one lamp with a power strictly greater than 0.
+    \sa computeLampPower()
+
+    \fn double Scene::getLampPdf(const Object3D* lamp)
+    \brief Computes the probability with which Scene::sampleLamp() chooses an object.
+    \param lamp The object.
+    \return The probability, 0 if the object does not emit light.
+
+    \fn DoubleVec3D Scene::traceBidirectional(double pixelX, double pixelY)
+    \brief Computes a sample of a pixel with bidirectional path tracing.
+    \details Every strategy of Veach's bidirectional path tracing is used, except the one where a light subpath would hit the camera, as it is a point. The contributions of the light subpath linked to the camera are added to Scene::currentLightImage, the other ones are returned.
+    \param pixelX The *x* coordinate, in pixels, through which the camera subpath starts.
+    \param pixelY The *y* coordinate, in pixels, through which the camera subpath starts.
+    \return The radiance arriving through the point of the pixel, without light tracing.
+    \sa Scene::getBidirectionalPathTracing()
+
+    \fn void Scene::generateSubpath(const Ray& ray, const DoubleVec3D& beta, double directionPdf, bool lightSubpath, unsigned int maxVertices, std::vector<PathVertex>& path)
+    \brief Extends a subpath by following the directions sampled by the materials.
+    \param ray The ray leaving the last vertex of the subpath.
+    \param beta The throughput of the subpath, including the last bounce.
+    \param directionPdf The probability density, with respect to solid angle, with which the direction of ray was sampled.
+    \param lightSubpath Whether the subpath starts on a lamp. Else, it starts from the camera.
+    \param maxVertices The maximum number of vertices of the subpath, including the first one.
+    \param path The subpath, which must already contain its first vertex. The new vertices are added at its end.
+
+    \fn DoubleVec3D Scene::connectBidirectional(const std::vector<PathVertex>& lightPath, const std::vector<PathVertex>& cameraPath, unsigned int s, unsigned int t, double& pixelX, double& pixelY)
+    \brief Computes the contribution of the path made of the first vertices of a light subpath and of a camera subpath.
+    \param lightPath The light subpath.
+    \param cameraPath The camera subpath.
+    \param s The number of vertices taken from the light subpath. If it is 0, the camera subpath must have hit a lamp.
+    \param t The number of vertices taken from the camera subpath. If it is 1, the light subpath is linked to the camera.
+    \param pixelX If t is 1, filled with the *x* coordinate of the pixel through which the light subpath is seen.
+    \param pixelY If t is 1, filled with the *y* coordinate of the pixel through which the light subpath is seen.
+    \return The contribution, without its multiple importance sampling weight. 0 if the two vertices cannot be linked or do not see each other.
+
+    \fn double Scene::computeBidirectionalMisWeight(std::vector<PathVertex>& lightPath, std::vector<PathVertex>& cameraPath, unsigned int s, unsigned int t)
+    \brief Computes the weight of a strategy of bidirectional path tracing with the balance heuristic.
+    \details The ratios between the probability densities of the strategies are computed by walking along the path, as described by Veach. The subpaths are modified during the computation, but are put back as they were.
+    \param lightPath The light subpath.
+    \param cameraPath The camera subpath.
+    \param s The number of vertices taken from the light subpath.
+    \param t The number of vertices taken from the camera subpath.
+    \return The weight, between 0 and 1.
+
+    \fn double Scene::getLightDirectionPdf(const PathVertex& lightVertex, const PathVertex& next)
+    \brief Computes the probability density with which a point on a lamp emits light towards a vertex.
+    \details The lamps emit on both sides, with a cosine-weighted distribution.
+    \param lightVertex The point on the lamp.
+    \param next The vertex that receives the light.
+    \return The probability density, with respect to the area around next.
+
+    \fn bool Scene::applyWavefrontRussianRoulette(WavefrontPath& path)
+    \brief Applies the russian roulette to the current ray of a path of the wavefront path tracer, like at the beginning of traceRay().
+    \param path The path. If it continues, its throughput is divided by the probability to continue.
+    \return Whether the path continues.
+
+    \fn void Scene::shadeWavefrontHits(std::vector<WavefrontPath>& paths, const unsigned int* hits, unsigned int numberHits, const std::vector<Sampler*>& samplers, std::vector<std::vector<WavefrontShadowRay>>& threadShadowRays)
+    \brief Shades the hits of the wavefront path tracer whose materials are of the same kind.
+    \details Adds the emittance to the paths, generates their shadow rays and samples their new directions. MaterialType is the class of the materials: as DiffuseMaterial, SpecularMaterial and RefractiveMaterial are final, their methods are not called through the virtual table. Material is used for the other materials.
+    \param paths The paths of the wave.
+    \param hits The indices of the paths to shade.
+    \param numberHits The number of paths to shade.
+    \param samplers The samplers of the threads.
+    \param threadShadowRays The shadow rays generated by each thread, which will be traced afterwards.
+    \sa getMaterialKind()
+
+    \fn void Scene::traceWavefrontPass(Picture* result, const std::vector<Sampler*>& samplers, unsigned int passBeginningSample, unsigned int passEndSample, bool verbose, double loopBeginningTime)
+    \brief Computes some samples of every pixel with wavefront path tracing.
+    \details The samples are split into waves of WAVEFRONT_QUEUE_SIZE paths. Each stage of a wave is run in parallel over the paths. The sampler is resumed for each bounce, so the numbers are the ones traceRay() would get.
+    \param result The picture to which the samples are added.
+    \param samplers The samplers of the threads.
+    \param passBeginningSample The index of the first sample.
+    \param passEndSample The index after the last sample.
+    \param verbose Whether the progression is printed.
+    \param loopBeginningTime The time at which the render loop started, for the time estimation.
+    \sa Scene::getWavefrontPathTracing()
+
+    \fn bool Scene::computeRadianceCacheRecord(const DoubleVec3D& point, const DoubleUnitVec3D& normal, const KDTreeNode* lastNode, unsigned int bounces, DoubleVec3D& radiance)
+    \brief Computes the radiance arriving at a point and adds it to the radiance cache.
+    \details Traces RADIANCE_CACHE_RECORD_SAMPLES paths in cosine-weighted directions, with independent random numbers. Those paths never use the radiance cache.
+    \param point The point at which the radiance is computed.
+    \param normal The normal of the surface at this point.
+    \param lastNode The k-d tree node in which the point is, nullptr if there is none.
+    \param bounces The number of bounces of the path that reached the point.
+    \param radiance Filled with the computed radiance.
+    \return False if the cache was already full, in which case nothing is computed. True else.
+
+    \fn void Scene::releaseAccelerationStructures()
+    \brief Deletes the k-d tree and the SBVH kept from the last render, if there are some.
 
     \fn void Scene::computeObjectsAndLamps()
     \brief Computes all the objects.
-    \details Also stores a vector of all objects having an emitance strictly greater than 1, to go faster with the next event estimation algorithm.
+    \details Also stores a vector of all objects having an emitance strictly greater than 1, to go faster with the next event estimation algorithm, and the cumulated powers of these lamps, to choose them with Scene::sampleLamp(). The objects are also copied as SpherePrimitive and TrianglePrimitive, which are intersected when there is no k-d tree.
 
     \fn void Scene::defaultScene()
     \brief Sets this scene's objects to default ones.
     \details The look is similar to the Cornell box.
     \sa initInterface()
 
+    \fn json Scene::getParametersJson() const
+    \brief Converts the parameters to json.
+    \details The k-d tree parameters chosen by the last render are also written, under KDChosenMaxDepth and KDChosenMaxObjectNumber. They are not read back, see Scene::getKDTreeMaxDepth().
+    \return The parameters, in the format written by Scene::saveParameters2File().
+
+    \fn void Scene::setParametersFromJson(const json& j)
+    \brief Overwrites the current parameters with the ones stored in json.
+    \param j Json input, in the format written by Scene::saveParameters2File().
+    \throw json::exception If the json input does not contain every parameter.
+
     \fn void Scene::saveParameters2File(std::string fileName) const
     \brief Saves parameters to a file.
     \param fileName The name of the file to which the prameters will be saved. It is recommended that this file extension ends with PARAMETERS_SAVE_EXTENSION.
@@ -248,16 +711,23 @@
 
     \fn bool Scene::importFBXFile(const char* filePath, Material* material, std::string name)
     \brief Imports a fbx file as triangles.
-    \details Uses the FBX SDK library.
+    \details Uses the FBX SDK library. The triangles and their materials are allocated in the geometry arena.
     \param filePath The path to the fbx file.
     \param material The material that will be used for all the triangles which will be imported.
     \param name The name of the object group in which all triangles will be stored.
     \return True if the importation was successful, false else.
     \sa importTrianglesFromFbxNode()
 
-    \fn Picture* Scene::render()
+    \fn std::string Scene::getIgnoredOptionsWarning()
+    \brief Tells which of the chosen options the render will not use.
+    \details Wavefront path tracing does not use the radiance cache, the path guiding and the caustic photon mapping. Printed by Scene::render() when it is verbose.
+    \return A warning naming the ignored options, an empty string if there is none.
+    \sa Scene::getWavefrontPathTracing()
+
+    \fn Picture* Scene::render(bool verbose = true)
     \brief Start the render of the picture.
-    \details This uses the path tracing algorithm (I guess this information was not useful, as it is in the title) and some optimisations such as next event estimation and russian roulette path termination.
+    \details This uses the path tracing algorithm (I guess this information was not useful, as it is in the title) and some optimisations such as next event estimation and russian roulette path termination. With path guiding, the samples are computed in several passes, and the SD-tree learns between them. With caustic photon mapping, photons are traced from the lamps before the samples. With bidirectional path tracing, the light subpaths seen by the camera are gathered in a separate picture, which is added at the end. With ray packets, the primary rays of consecutive samples of a pixel go through the k-d tree together. With wavefront path tracing, the paths are traced in waves instead of one by one. With an SBVH, it is built instead of the k-d tree. The objects, the k-d tree and the SBVH are kept until the object groups or the parameters of the structure change, so that a render after moving the camera starts at once.
+    \param verbose If true, the screen is cleared and the parameters and the progression are printed. If false, nothing is printed, which is what a batch render wants.
     \return A pointer to the rendered picture.
 
     \fn void Scene::displayParametersPage(bool displayIndexes = true)
@@ -271,11 +741,12 @@
     \details This is one of the main pages.
     \sa Scene::displayParametersPage()
 
-    \fn bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<Object3D*>& objects)
+    \fn bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<Object3D*>& objects, MemoryArena& arena)
     \brief Imports recursively all triangles present in a FBXNode.
     \param node The node from which we want to import the mesh.
     \param material The material with which the triangles will be instanciated.
     \param objects A reference to a vector of objects in which the triangles will be added.
+    \param arena The arena in which the triangles and the copies of the material will be allocated.
     \warning The material is always deeply copied when instanciating a triangle. Do not forget to delete it after calling this method.
     \sa Scene::importFBXFile()
 
@@ -286,14 +757,54 @@
     \param pictureWidth The width of the picture we are rendering.
     \param loopBeginningTime The number of seconds between 1st January 1970 and the beginning of the render.
     \sa Scene::render()
+
+    \fn double computeLampPower(const Object3D* lamp)
+    \brief Computes the power of a lamp.
+    \details The lamps emit on both sides, so this is 2*pi*area times the average of the emittance.
+    \param lamp The lamp.
+    \return The power of the lamp.
+
+    \fn double powerHeuristic(double pdf, double otherPdf)
+    \brief Computes the weight of a sample with the power heuristic of Veach (with an exponent of 2).
+    \details Used by multiple importance sampling, when one sample is taken with each of the two strategies.
+    \param pdf The probability density of the sample with the strategy that generated it.
+    \param otherPdf The probability density of the same sample with the other strategy.
+    \return The weight of the sample, between 0 and 1.
+    \sa Scene::getMultipleImportanceSampling()
 */
 
+constexpr unsigned int KD_CALIBRATION_PATHS = 1024;
+
 class Scene {
 private:
+    typedef DoubleVec3D (Scene::*TraceRayFunction)(const Ray&, double, const KDTreeNode*, unsigned int, double, const DoubleVec3D&, bool, const KDTreeNode::Intersection*) const;
+
     std::vector<Object3DGroup> objectGroups;
     std::vector<Object3D*> objects;
     std::vector<Object3D*> lamps;
+    std::vector<SpherePrimitive> spherePrimitives;  // Copies of the objects, tested by Scene::bruteForceIntersection()
+    std::vector<TrianglePrimitive> trianglePrimitives;
+    std::vector<double> lampPowersCdf;  // Cumulated powers of the lamps
     KDTreeNode* kdTreeRoot = nullptr;
+    RadianceCache* currentRadianceCache = nullptr;
+    SDTree* currentSDTree = nullptr;
+    PhotonMap* currentCausticPhotonMap = nullptr;
+    SBVH* currentSBVH = nullptr;
+    unsigned int objectGroupsGeneration = 1;  // Incremented by every change of the object groups
+    unsigned int objectsGeneration = 0;  // objectGroupsGeneration when the objects were last computed, 0 if they never were
+    unsigned int kdTreeMaxObjectNumber = 0;  // Parameters with which kdTreeRoot was built, chosen by render() from the settings below
+    unsigned int kdTreeMaxDepth = 0;
+    unsigned int kdTreeSettingMaxObjectNumber = 0;  // Settings when kdTreeRoot was built
+    unsigned int kdTreeSettingMaxDepth = 0;
+    bool kdTreeLazy = false;
+    bool kdTreeAutoParameters = false;
+    bool kdTreeCalibration = false;
+    double currentSBVHAlpha = 0.0;
+    Picture* currentLightImage = nullptr;  // Receives the light subpaths seen by the camera
+    TraceRayFunction currentTraceRay = nullptr;  // Chosen by render() from the parameters
+
+    MemoryArena geometryArena;
+    MemoryArena kdTreeArena;
 
     PerspectiveCamera camera;
     unsigned int samplesPerPixel;
@@ -301,11 +812,30 @@ private:
 
     bool russianRoulette = true;
     double rrStopProbability = 0.1;  // Linked to russianRoulette   /  stopProb=1 <=> russianRoulette=false
+    bool rrThroughputBased = true;
     bool nextEventEstimation = true;
+    bool multipleImportanceSampling = true;
+    SamplerType samplerType = SAMPLER_SOBOL;
     unsigned int numberThreads = omp_get_max_threads();
     bool kdTree = true;
     unsigned int kdMaxObjectNumber = 10;
     unsigned int kdMaxDepth = 10;
+    bool kdAutoParameters = true;  // kdMaxDepth is then replaced by the chosen kdTreeMaxDepth
+    bool kdCalibration = false;  // Linked to kdAutoParameters
+    bool kdLazyBuild = false;
+    bool kdTreeCache = false;
+    bool sbvh = false;
+    double sbvhAlpha = 0.00001;  // Linked to sbvh
+    bool radianceCache = false;
+    double radianceCacheErrorThreshold = 0.3;
+    unsigned int radianceCacheMaxRecords = 100000;
+    bool pathGuiding = false;
+    bool causticPhotonMapping = false;
+    unsigned int causticPhotons = 1000000;
+    double causticPhotonRadius = 0.05;
+    bool bidirectionalPathTracing = false;
+    unsigned int rayPacketSize = 8;
+    bool wavefrontPathTracing = false;
 
     std::string backupFileName = "backup";
     bool backupParameters = true;
@@ -313,17 +843,49 @@ private:
     bool backupPicture = true;
     double leastRenderTime4PictureBackup = 180.0;  // Three minutes
 
+    double kdTreeCreationTime = 0.0;
+    unsigned int kdTreeBuiltNodes = 0;
+    unsigned int kdTreeUnbuiltNodes = 0;
+    double sbvhCreationTime = 0.0;
+    unsigned int sbvhDuplicatedReferences = 0;
+    double sbvhSAHCost = 0.0;
+    RayCounters rayCounters;
+
     KDTreeNode::Intersection bruteForceIntersection(const Ray& ray) const;
-    DoubleVec3D traceRay(const Ray& ray, double usedNextEventEstimation = false, const KDTreeNode* lastNode = nullptr, unsigned int bounces = 0) const;
+    KDTreeNode::Intersection findIntersection(const Ray& ray, const KDTreeNode* lastNode) const;
+    template <bool useKDTree>
+    KDTreeNode::Intersection findIntersection(const Ray& ray, const KDTreeNode* lastNode) const;
+    void chooseKDTreeParameters();
+    double timeKDTreeCalibrationPaths(unsigned int maxObjectNumber, unsigned int maxDepth);
+    void releaseAccelerationStructures();
+    TraceRayFunction selectTraceRay() const;
+    DoubleVec3D traceRay(const Ray& ray, double usedNextEventEstimation = false, const KDTreeNode* lastNode = nullptr, unsigned int bounces = 0, double lastDirectionPdf = 0.0, const DoubleVec3D& throughput = DoubleVec3D(1.0), bool causticChain = false, const KDTreeNode::Intersection* knownIntersection = nullptr) const;
+    template <bool useKDTree, bool useNextEventEstimation, bool useRussianRoulette>
+    DoubleVec3D traceRay(const Ray& ray, double usedNextEventEstimation, const KDTreeNode* lastNode, unsigned int bounces, double lastDirectionPdf, const DoubleVec3D& throughput, bool causticChain, const KDTreeNode::Intersection* knownIntersection) const;
+    PhotonMap* traceCausticPhotons() const;
+    Object3D* sampleLamp(double& pdf) const;
+    double getLampPdf(const Object3D* lamp) const;
+    DoubleVec3D traceBidirectional(double pixelX, double pixelY) const;
+    void generateSubpath(const Ray& ray, const DoubleVec3D& beta, double directionPdf, bool lightSubpath, unsigned int maxVertices, std::vector<PathVertex>& path) const;
+    DoubleVec3D connectBidirectional(const std::vector<PathVertex>& lightPath, const std::vector<PathVertex>& cameraPath, unsigned int s, unsigned int t, double& pixelX, double& pixelY) const;
+    double computeBidirectionalMisWeight(std::vector<PathVertex>& lightPath, std::vector<PathVertex>& cameraPath, unsigned int s, unsigned int t) const;
+    double getLightDirectionPdf(const PathVertex& lightVertex, const PathVertex& next) const;
+    bool applyWavefrontRussianRoulette(WavefrontPath& path) const;
+    template <class MaterialType>
+    void shadeWavefrontHits(std::vector<WavefrontPath>& paths, const unsigned int* hits, unsigned int numberHits, const std::vector<Sampler*>& samplers, std::vector<std::vector<WavefrontShadowRay>>& threadShadowRays) const;
+    void traceWavefrontPass(Picture* result, const std::vector<Sampler*>& samplers, unsigned int passBeginningSample, unsigned int passEndSample, bool verbose, double loopBeginningTime) const;
+    bool computeRadianceCacheRecord(const DoubleVec3D& point, const DoubleUnitVec3D& normal, const KDTreeNode* lastNode, unsigned int bounces, DoubleVec3D& radiance) const;
     std::string getCurrentIndex(int currentIndex, bool displayIndex) const;
 
 public:
     Scene(PerspectiveCamera camera = PerspectiveCamera(), unsigned int samplesPerPixel = 8, unsigned int minBounces = 5);
     Scene(const Scene& scene);
+    ~Scene();
 
     std::vector<Object3DGroup> getObjectGroups() const;
     std::vector<Object3DGroup>& getObjectGroupsReference();  // Reference -> can modify it -> != const
     std::vector<Object3D*> getObjects();
+    MemoryArena& getGeometryArena();
     std::vector<Object3D*> getLamps();
     PerspectiveCamera getCamera() const;
     PerspectiveCamera& getCameraReference();
@@ -331,16 +893,44 @@ public:
     unsigned int getMinBounces() const;
     bool getRussianRoulette() const;
     double getRrStopProbability() const;
+    bool getRrThroughputBased() const;
     bool getNextEventEstimation() const;
+    bool getMultipleImportanceSampling() const;
+    SamplerType getSamplerType() const;
     unsigned int getNumberThreads() const;
     bool getKDTree() const;
     unsigned int getKDMaxObjectNumber() const;
     unsigned int getKDMaxDepth() const;
+    bool getKDAutoParameters() const;
+    bool getKDCalibration() const;
+    bool getKDLazyBuild() const;
+    bool getKDTreeCache() const;
+    bool getSBVH() const;
+    double getSBVHAlpha() const;
+    bool getRadianceCache() const;
+    double getRadianceCacheErrorThreshold() const;
+    unsigned int getRadianceCacheMaxRecords() const;
+    bool getPathGuiding() const;
+    bool getCausticPhotonMapping() const;
+    unsigned int getCausticPhotons() const;
+    double getCausticPhotonRadius() const;
+    bool getBidirectionalPathTracing() const;
+    unsigned int getRayPacketSize() const;
+    bool getWavefrontPathTracing() const;
     std::string getBackupFileName() const;
     bool getBackupParameters() const;
     bool getBackupObjectGroups() const;
     bool getBackupPicture() const;
     double getLeastRenderTime4PictureBackup() const;
+    double getKDTreeCreationTime() const;
+    unsigned int getKDTreeMaxObjectNumber() const;
+    unsigned int getKDTreeMaxDepth() const;
+    unsigned int getKDTreeBuiltNodes() const;
+    unsigned int getKDTreeUnbuiltNodes() const;
+    double getSBVHCreationTime() const;
+    unsigned int getSBVHDuplicatedReferences() const;
+    double getSBVHSAHCost() const;
+    RayCounters getRayCounters() const;
 
     void setObjectGroups(std::vector<Object3DGroup> groups);
     void setCamera(PerspectiveCamera camera);
@@ -349,11 +939,30 @@ public:
     void setRussianRoulette(bool russianRoulette);
     void setRussianRoulette(bool russianRoulette, double rrStopProbability);
     void setRrStopProbability(double rrStopProbability);
+    void setRrThroughputBased(bool rrThroughputBased);
     void setNextEventEstimation(bool nextEventEstimation);
+    void setMultipleImportanceSampling(bool multipleImportanceSampling);
+    void setSamplerType(SamplerType samplerType);
     void setNumberThreads(unsigned int numberThreads);
     void setKDTree(bool kdTree);
     void setKDMaxObjectNumber(unsigned int kdMaxObjectNumber);
     void setKDMaxDepth(unsigned int kdMaxDepth);
+    void setKDAutoParameters(bool kdAutoParameters);
+    void setKDCalibration(bool kdCalibration);
+    void setKDLazyBuild(bool kdLazyBuild);
+    void setKDTreeCache(bool kdTreeCache);
+    void setSBVH(bool sbvh);
+    void setSBVHAlpha(double sbvhAlpha);
+    void setRadianceCache(bool radianceCache);
+    void setRadianceCacheErrorThreshold(double radianceCacheErrorThreshold);
+    void setRadianceCacheMaxRecords(unsigned int radianceCacheMaxRecords);
+    void setPathGuiding(bool pathGuiding);
+    void setCausticPhotonMapping(bool causticPhotonMapping);
+    void setCausticPhotons(unsigned int causticPhotons);
+    void setCausticPhotonRadius(double causticPhotonRadius);
+    void setBidirectionalPathTracing(bool bidirectionalPathTracing);
+    void setRayPacketSize(unsigned int rayPacketSize);
+    void setWavefrontPathTracing(bool wavefrontPathTracing);
     void setBackupFileName(std::string backupFileName);
     void setBackupParameters(bool backupParameters);
     void setBackupObjectGroups(bool backupObjectGroups);
@@ -361,23 +970,32 @@ public:
     void setLeastRenderTime4PictureBackup(double leastRenderTime4PictureBackup);
 
     void addObjectGroup(const Object3DGroup& group);
+    void modifyObjectGroup(unsigned int index);
+    void deleteObjectGroup(unsigned int index);
+    void mergeObjectGroups(unsigned int index1, unsigned int index2, const std::string& name);
     void resetAndDeleteObjectGroups();
+    void addObjectGroupsFromJson(const json& j);
     void computeObjectsAndLamps();
     void defaultScene();
 
+    json getParametersJson() const;
+    void setParametersFromJson(const json& j);
     void saveParameters2File(std::string fileName) const;
     void saveObjectGroups2File(std::string fileName) const;
 
     bool importFBXFile(const char* filePath, Material* material, std::string name);
 
-    Picture* render();
+    std::string getIgnoredOptionsWarning() const;
+    Picture* render(bool verbose = true);
 
     void displayParametersPage(bool displayIndexes = true) const;
     void displayObjectsPage() const;
 };
 
-bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<Object3D*>& objects);
+bool importTrianglesFromFbxNode(FbxNode* node, Material* material, std::vector<Object3D*>& objects, MemoryArena& arena);
 
 void displayRenderingProgression(unsigned int numberPixelXAlreadyComputed, unsigned int pictureWidth, double loopBeginningTime);
+double computeLampPower(const Object3D* lamp);
+double powerHeuristic(double pdf, double otherPdf);
 
 #endif
@@ -0,0 +1,81 @@
+#include "SobolSampler.h"
+
+// Constructor
+SobolSampler::SobolSampler(unsigned int samplesPerPixel, unsigned int seed)
+    : Sampler(samplesPerPixel, seed) {
+    getDirections(0);  // Computes the table before the render starts
+}
+
+
+// Private method
+const unsigned int* SobolSampler::getDirections(unsigned int dimension) {
+    static const std::vector<unsigned int> directions = []() {
+        // Joe and Kuo "Constructing Sobol sequences with better two-dimensional projections" (2008), file new-joe-kuo-6.21201
+        // The first dimension is the van der Corput sequence, then {degree s, coefficients a, initial numbers m}
+        const unsigned int degrees[SAMPLER_DIMENSIONS_PER_GROUP] = { 0, 1, 2, 3 };
+        const unsigned int coefficients[SAMPLER_DIMENSIONS_PER_GROUP] = { 0, 0, 1, 1 };
+        const unsigned int initialNumbers[SAMPLER_DIMENSIONS_PER_GROUP][3] = { {}, {1}, {1, 3}, {1, 3, 1} };
+
+        std::vector<unsigned int> result(SAMPLER_DIMENSIONS_PER_GROUP * 32);
+        for (unsigned int bit = 0; bit < 32; bit++)
+            result[bit] = 1u << (31 - bit);
+
+        for (unsigned int dimension = 1; dimension < SAMPLER_DIMENSIONS_PER_GROUP; dimension++) {
+            unsigned int* dimensionDirections = &result[dimension * 32];
+            unsigned int degree = degrees[dimension];
+            for (unsigned int bit = 0; bit < degree; bit++)
+                dimensionDirections[bit] = initialNumbers[dimension][bit] << (31 - bit);
+            for (unsigned int bit = degree; bit < 32; bit++) {
+                dimensionDirections[bit] = dimensionDirections[bit - degree] ^ (dimensionDirections[bit - degree] >> degree);
+                for (unsigned int k = 1; k < degree; k++)
+                    dimensionDirections[bit] ^= ((coefficients[dimension] >> (degree - 1 - k)) & 1) * dimensionDirections[bit - k];
+            }
+        }
+        return result;
+    }();
+    return &directions[dimension * 32];
+}
+
+
+// Virtual methods
+void SobolSampler::onGroupStarted() {
+    groupSeed = hashCombine(pixelSeed, hashUnsignedInt(currentGroup));
+    shuffledIndex = nestedUniformScramble(sampleIndex, groupSeed);  // Different points for each group
+}
+
+double SobolSampler::computeDouble(unsigned int dimension) {
+    unsigned int point = sobol(shuffledIndex, getDirections(dimension));
+    return unsignedInt2Double(nestedUniformScramble(point, hashCombine(groupSeed, hashUnsignedInt(dimension))));
+}
+
+std::string SobolSampler::getType() const { return "Sobol"; }
+
+
+// Other functions
+unsigned int sobol(unsigned int index, const unsigned int* directions) {
+    unsigned int result = 0;
+    for (unsigned int bit = 0; index != 0; index >>= 1, bit++) {
+        if (index & 1)
+            result ^= directions[bit];
+    }
+    return result;
+}
+
+unsigned int reverseBits(unsigned int value) {
+    value = ((value >> 1) & 0x55555555u) | ((value & 0x55555555u) << 1);
+    value = ((value >> 2) & 0x33333333u) | ((value & 0x33333333u) << 2);
+    value = ((value >> 4) & 0x0f0f0f0fu) | ((value & 0x0f0f0f0fu) << 4);
+    value = ((value >> 8) & 0x00ff00ffu) | ((value & 0x00ff00ffu) << 8);
+    return (value >> 16) | (value << 16);
+}
+
+unsigned int nestedUniformScramble(unsigned int value, unsigned int seed) {
+    // Using Brent Burley "Practical Hash-based Owen Scrambling" (2020)
+    value = reverseBits(value);
+    value += seed;  // Laine-Karras permutation
+    value ^= value * 0x6c50b47cu;
+    value ^= value * 0xb82f1e52u;
+    value ^= value * 0xc7afe638u;
+    value ^= value * 0x8d22f6e6u;
+    return reverseBits(value);
+}
@@ -0,0 +1,76 @@
+#ifndef DEF_SOBOLSAMPLER
+#define DEF_SOBOLSAMPLER
+
+#include "Sampler.h"
+
+/*!
+    \file SobolSampler.h
+    \brief Defines the SobolSampler class.
+
+    \class SobolSampler
+    \brief Sampler using an Owen-scrambled four-dimensional Sobol sequence.
+    \details Uses Brent Burley "Practical Hash-based Owen Scrambling" (2020). Each group of dimensions uses the four first dimensions of the Sobol sequence, but the order of the points and their digits are scrambled differently for every group and every pixel. This keeps the good distribution of the Sobol sequence inside a group, while the groups are not correlated.
+
+    \fn SobolSampler::SobolSampler(unsigned int samplesPerPixel, unsigned int seed)
+    \brief Main constructor.
+    \param samplesPerPixel The number of samples per pixel of the render. The sequence is best distributed with a power of two.
+    \param seed The seed of the render.
+
+    \fn std::string SobolSampler::getType()
+    \brief Returns "Sobol".
+    \return "Sobol".
+
+    \fn double SobolSampler::computeDouble(unsigned int dimension)
+    \brief Computes the number of a dimension of the current group.
+    \param dimension The dimension in the current group.
+    \return The scrambled point of the Sobol sequence.
+
+    \fn void SobolSampler::onGroupStarted()
+    \brief Computes the seed of the group and the shuffled index of the point, which do not depend on the dimension.
+
+    \fn static const unsigned int* SobolSampler::getDirections(unsigned int dimension)
+    \brief Gives the 32 direction numbers of a dimension of the Sobol sequence.
+    \details Computed with the primitive polynomials and initial numbers of Joe and Kuo (2008).
+    \param dimension The dimension, smaller than SAMPLER_DIMENSIONS_PER_GROUP.
+    \return A pointer to the direction numbers.
+
+    \fn unsigned int sobol(unsigned int index, const unsigned int* directions)
+    \brief Computes a point of the Sobol sequence in one dimension.
+    \param index The index of the point.
+    \param directions The direction numbers of the dimension.
+    \return The point, as 32 bits.
+
+    \fn unsigned int reverseBits(unsigned int value)
+    \brief Reverses the order of the bits.
+    \param value The bits that will be reversed.
+    \return The reversed bits.
+
+    \fn unsigned int nestedUniformScramble(unsigned int value, unsigned int seed)
+    \brief Owen-scrambles 32 bits, using the Laine-Karras hash.
+    \param value The bits that will be scrambled.
+    \param seed Chooses the scrambling.
+    \return The scrambled bits.
+*/
+
+class SobolSampler : public Sampler {
+private:
+    unsigned int groupSeed = 0;
+    unsigned int shuffledIndex = 0;
+
+    static const unsigned int* getDirections(unsigned int dimension);
+
+protected:
+    double computeDouble(unsigned int dimension);
+    void onGroupStarted();
+
+public:
+    SobolSampler(unsigned int samplesPerPixel, unsigned int seed);
+
+    std::string getType() const;
+};
+
+unsigned int sobol(unsigned int index, const unsigned int* directions);
+unsigned int reverseBits(unsigned int value);
+unsigned int nestedUniformScramble(unsigned int value, unsigned int seed);
+
+#endif
@@ -13,6 +13,10 @@ Material* SpecularMaterial::deepCopy() const {
     return new SpecularMaterial(getEmittance());
 }
 
+Material* SpecularMaterial::deepCopy(MemoryArena& arena) const {
+    return new (arena) SpecularMaterial(getEmittance());
+}
+
 DoubleUnitVec3D SpecularMaterial::getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) const {
     DoubleUnitVec3D previousRayDirection = previousRay.getDirection();
     return previousRayDirection - normal*dotProd(previousRayDirection, normal)*2;
@@ -22,6 +26,10 @@ DoubleVec3D SpecularMaterial::computeCurrentRadiance(const DoubleVec3D& recursiv
     return recursiveRadiance;
 }
 
+double SpecularMaterial::getDirectionPdf(const Ray&, const DoubleUnitVec3D&, const DoubleUnitVec3D&) const {
+    return 0.0;
+}
+
 bool SpecularMaterial::worksWithNextEventEstimation() const {
     return false;
 }
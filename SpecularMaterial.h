@@ -22,6 +22,11 @@
     \brief Makes a deep copy of this material.
     \return A pointer to a deeply copied version of this material.
 
+    \fn Material* SpecularMaterial::deepCopy(MemoryArena& arena)
+    \brief Makes a deep copy of this material in an arena.
+    \param arena The arena in which the copy will be allocated.
+    \return A pointer to a deeply copied version of this material.
+
     \fn DoubleUnitVec3D SpecularMaterial::getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal)
     \brief Computes the new ray direction.
     \param previousRay The ray that hits this material.
@@ -35,6 +40,13 @@
     \param nextEventEstimation Whether the radiance is obtained using the next event estimation algorithm.
     \return The new radiance.
 
+    \fn double SpecularMaterial::getDirectionPdf(const Ray& previousRay, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection)
+    \brief Computes the probability density with which getNewDirection() returns a direction.
+    \param previousRay The ray that hits this material.
+    \param normal The normal at the intersection.
+    \param newDirection The direction of the next ray.
+    \return 0, since the reflected direction is a Dirac distribution.
+
     \fn bool SpecularMaterial::worksWithNextEventEstimation()
     \brief Returns whether this material works with next event estimation.
     \return False.
@@ -58,15 +70,17 @@
     \param j The json input.
 */
 
-class SpecularMaterial : public Material {
+class SpecularMaterial final : public Material {
 public:
     SpecularMaterial(DoubleVec3D emittance = 0);
     SpecularMaterial(const SpecularMaterial& material);
 
     Material* deepCopy() const;
+    Material* deepCopy(MemoryArena& arena) const;
 
     DoubleUnitVec3D getNewDirection(const Ray& previousRay, const DoubleUnitVec3D& normal) const;
     DoubleVec3D computeCurrentRadiance(const DoubleVec3D& recursiveRadiance, double cosAngleNewDirectionNormal, bool nextEventEstimation = false) const;
+    double getDirectionPdf(const Ray& previousRay, const DoubleUnitVec3D& normal, const DoubleUnitVec3D& newDirection) const;
     bool worksWithNextEventEstimation() const;
 
     std::ostream& getDescription(std::ostream& stream) const;
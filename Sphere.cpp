@@ -1,5 +1,7 @@
 #include "Sphere.h"
 
+#include "Primitive.h"
+
 // Constructors
 Sphere::Sphere()
     : Object3D(), center(0), radius(1) {
@@ -34,27 +36,12 @@ Object3D* Sphere::deepCopy() const {
     return new Sphere(center, radius, getMaterial()->deepCopy());
 }
 
+Object3D* Sphere::deepCopy(MemoryArena& arena) const {
+    return new (arena) Sphere(center, radius, getMaterial()->deepCopy(arena));
+}
+
 double Sphere::smallestPositiveIntersection(const Ray& ray) const {
-    // Returns -1 if no solution
-    // Using quadratic equation formula to solve (meaning of a, b, c)
-    // a = dotProd(rayDir, rayDir) but = 1
-    DoubleVec3D differenceOriginCenter = ray.getOrigin() - center;
-    double b = 2 * dotProd(ray.getDirection(), differenceOriginCenter);
-    double c = dotProd(differenceOriginCenter, differenceOriginCenter) - radius * radius;
-
-    double discriminant = b*b - 4*c;
-    if (discriminant < 0.0)
-        return -1.0;
-    else if (discriminant == 0.0)
-        return -b/2;
-    else {
-        double sqrt_discriminant = sqrt(discriminant);
-        double twiceSolution1 = -b - sqrt_discriminant;
-        if (twiceSolution1 > 0.0)
-            return twiceSolution1/2; // smallest solution and is positive
-        else
-            return (-b + sqrt_discriminant)/2; // biggest solution but maybe positive
-    }
+    return intersectSphere(ray, center, radius);
 }    
 
 DoubleUnitVec3D Sphere::getNormal(const DoubleVec3D& point) const {
@@ -67,6 +54,46 @@ DoubleVec3D Sphere::getRandomPoint() const {
     return center + radius*point;
 }
 
+DoubleVec3D Sphere::sampleLightPoint(const DoubleVec3D& origin, double& pdf) const {
+    // Using section 14.2.2 of Pharr et al. "Physically Based Rendering" (third edition)
+    DoubleVec3D originToCenter = center - origin;
+    double squaredDistance = dotProd(originToCenter, originToCenter);
+    if (squaredDistance <= radius*radius)  // Inside the sphere -> everything can be seen
+        return Object3D::sampleLightPoint(origin, pdf);
+
+    double distance = sqrt(squaredDistance);
+    double sinSquaredMaxAngle = radius*radius / squaredDistance;
+    double cosMaxAngle = sqrt(std::max(0.0, 1 - sinSquaredMaxAngle));
+    double oneMinusCosMaxAngle = sinSquaredMaxAngle / (1 + cosMaxAngle);  // Does not cancel out for small or distant spheres
+    pdf = 1.0 / (2*M_PI*oneMinusCosMaxAngle);
+
+    // Uniform direction in the cone
+    double cosAngle = 1 - randomDouble()*oneMinusCosMaxAngle;
+    double sinSquaredAngle = std::max(0.0, 1 - cosAngle*cosAngle);
+    double sinAngle = sqrt(sinSquaredAngle);
+    double rotationAngle = 2*M_PI*randomDouble();
+
+    DoubleUnitVec3D coneAxis(originToCenter / distance, true);
+    DoubleUnitVec3D tangent, bitangent;
+    buildOrthonormalBasis(coneAxis, tangent, bitangent);
+    DoubleVec3D direction = tangent*(sinAngle*cos(rotationAngle)) + bitangent*(sinAngle*sin(rotationAngle)) + coneAxis*cosAngle;
+
+    // First intersection between this direction and the sphere
+    double distanceToPoint = distance*cosAngle - sqrt(std::max(0.0, radius*radius - squaredDistance*sinSquaredAngle));
+    return origin + distanceToPoint*direction;
+}
+
+double Sphere::getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject) const {
+    DoubleVec3D originToCenter = center - origin;
+    double squaredDistance = dotProd(originToCenter, originToCenter);
+    if (squaredDistance <= radius*radius)
+        return Object3D::getLightPdf(origin, pointOnObject);
+
+    double sinSquaredMaxAngle = radius*radius / squaredDistance;
+    double cosMaxAngle = sqrt(std::max(0.0, 1 - sinSquaredMaxAngle));
+    return 1.0 / (2*M_PI*sinSquaredMaxAngle / (1 + cosMaxAngle));
+}
+
 DoubleVec3D Sphere::getMinCoord() const {
     return center - DoubleVec3D(radius);
 }
@@ -92,4 +119,5 @@ json Sphere::getLocationJson() const {
 void Sphere::setLocationJson(const json& j) {
     center = j["Center"].get<DoubleVec3D>();
     radius = j["Radius"].get<double>();
+    computeArea();
 }
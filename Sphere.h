@@ -53,6 +53,12 @@
     \brief Makes a deep copy of this object.
     \return A pointer to a deeply copied version of this object.
 
+    \fn Object3D* Sphere::deepCopy(MemoryArena& arena)
+    \brief Makes a deep copy of this object in an arena.
+    \details The material is copied in the same arena.
+    \param arena The arena in which the copy will be allocated.
+    \return A pointer to a deeply copied version of this object.
+
     \fn double Sphere::smallestPositiveIntersection(const Ray& ray)
     \brief Computes the smallest positive intersection between the ray and this object.
     \param ray The ray with wich we want to compute the intersection.
@@ -69,6 +75,20 @@
     \return A random point on this object.
     \sa randomVectorOnUnitRadiusSphere()
 
+    \fn DoubleVec3D Sphere::sampleLightPoint(const DoubleVec3D& origin, double& pdf)
+    \brief Computes a random point on the part of the sphere that can be seen from origin.
+    \details Samples uniformly a direction in the cone that contains the sphere as seen from origin, and returns the first intersection between this direction and the sphere. If origin is inside the sphere, falls back to Sphere::getRandomPoint().
+    \param origin The point from which the lamp is sampled.
+    \param pdf Set to the probability density of the point, with respect to solid angle.
+    \return A random point on the visible spherical cap.
+    \sa Sphere::getLightPdf()
+
+    \fn double Sphere::getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject)
+    \brief Computes the probability density with which Sphere::sampleLightPoint() returns a point.
+    \param origin The point from which the lamp is sampled.
+    \param pointOnObject The sampled point, which must be visible from origin.
+    \return One over the solid angle of the sphere seen from origin, or the density of the area sampling if origin is inside the sphere.
+
     \fn DoubleVec3D Sphere::getMinCoord()
     \brief Returns the minimum coordinate of a cuboid containing this object.
     \details This is computed using the following formula: center - DoubleVec3D(radius).
@@ -97,7 +117,9 @@
 
     \fn void Sphere::setLocationJson(const json& j)
     \brief Sets this object's location according to json.
+    \details Calls Sphere::computeArea().
     \param j The json input.
+    \sa Sphere::computeArea()
 */
 
 class Sphere : public Object3D {
@@ -118,10 +140,13 @@ public:
 
     void computeArea();
     Object3D* deepCopy() const;
+    Object3D* deepCopy(MemoryArena& arena) const;
 
     double smallestPositiveIntersection(const Ray& ray) const;
     DoubleUnitVec3D getNormal(const DoubleVec3D& point) const;
     DoubleVec3D getRandomPoint() const;
+    DoubleVec3D sampleLightPoint(const DoubleVec3D& origin, double& pdf) const;
+    double getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject) const;
     DoubleVec3D getMinCoord() const;
     DoubleVec3D getMaxCoord() const;
 
@@ -0,0 +1,49 @@
+#include "StratifiedSampler.h"
+
+// Constructor
+StratifiedSampler::StratifiedSampler(unsigned int samplesPerPixel, unsigned int seed)
+    : Sampler(samplesPerPixel, seed) {}
+
+
+// Virtual methods
+double StratifiedSampler::computeDouble(unsigned int dimension) {
+    unsigned int dimensionSeed = hashCombine(pixelSeed, hashUnsignedInt(currentGroup*SAMPLER_DIMENSIONS_PER_GROUP + dimension));
+    unsigned int stratum = permuteIndex(sampleIndex % samplesPerPixel, samplesPerPixel, dimensionSeed);
+    return (stratum + getIndependentDouble()) / samplesPerPixel;
+}
+
+std::string StratifiedSampler::getType() const { return "Stratified"; }
+
+
+// Other function
+unsigned int permuteIndex(unsigned int index, unsigned int length, unsigned int seed) {
+    // Using Andrew Kensler "Correlated Multi-Jittered Sampling" (2013), listing 3
+    unsigned int mask = length - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+    mask |= mask >> 16;
+
+    do {  // Cycle walking, until the result is smaller than length
+        index ^= seed;
+        index *= 0xe170893du;
+        index ^= seed >> 16;
+        index ^= (index & mask) >> 4;
+        index ^= seed >> 8;
+        index *= 0x0929eb3fu;
+        index ^= seed >> 23;
+        index ^= (index & mask) >> 1;
+        index *= 1 | seed >> 27;
+        index *= 0x6935fa69u;
+        index ^= (index & mask) >> 11;
+        index *= 0x74dcb303u;
+        index ^= (index & mask) >> 2;
+        index *= 0x9e501cc3u;
+        index ^= (index & mask) >> 2;
+        index *= 0xc860a3dfu;
+        index &= mask;
+        index ^= index >> 5;
+    } while (index >= length);
+    return (index + seed) % length;
+}
@@ -0,0 +1,49 @@
+#ifndef DEF_STRATIFIEDSAMPLER
+#define DEF_STRATIFIEDSAMPLER
+
+#include "Sampler.h"
+
+/*!
+    \file StratifiedSampler.h
+    \brief Defines the StratifiedSampler class.
+
+    \class StratifiedSampler
+    \brief Sampler stratifying every dimension.
+    \details Each dimension is split into as many strata as there are samples per pixel, and each sample of a pixel gets a random number in its own stratum. The strata are shuffled differently for every dimension and every pixel, so that the dimensions are not correlated (this is also known as latin hypercube sampling).
+
+    \fn StratifiedSampler::StratifiedSampler(unsigned int samplesPerPixel, unsigned int seed)
+    \brief Main constructor.
+    \param samplesPerPixel The number of samples per pixel of the render, which is also the number of strata.
+    \param seed The seed of the render.
+
+    \fn std::string StratifiedSampler::getType()
+    \brief Returns "Stratified".
+    \return "Stratified".
+
+    \fn double StratifiedSampler::computeDouble(unsigned int dimension)
+    \brief Computes the number of a dimension of the current group.
+    \param dimension The dimension in the current group.
+    \return A random double in the stratum of the current sample.
+
+    \fn unsigned int permuteIndex(unsigned int index, unsigned int length, unsigned int seed)
+    \brief Shuffles indexes without storing the permutation.
+    \details Uses the hash-based permutation of Andrew Kensler "Correlated Multi-Jittered Sampling" (2013).
+    \param index The index that will be permuted, smaller than length.
+    \param length The number of indexes.
+    \param seed Chooses the permutation.
+    \return The permuted index, smaller than length.
+*/
+
+class StratifiedSampler : public Sampler {
+protected:
+    double computeDouble(unsigned int dimension);
+
+public:
+    StratifiedSampler(unsigned int samplesPerPixel, unsigned int seed);
+
+    std::string getType() const;
+};
+
+unsigned int permuteIndex(unsigned int index, unsigned int length, unsigned int seed);
+
+#endif
@@ -1,5 +1,7 @@
 #include "Triangle.h"
 
+#include "Primitive.h"
+
 // Constructors
 Triangle::Triangle()
     : Object3D(), vertex0(1, 0, 0), vertex1(0, 1, 0), vertex2(0, 0, 1) {
@@ -32,6 +34,30 @@ void Triangle::setVertex1(const DoubleVec3D& vertex) { vertex1 = vertex; compute
 void Triangle::setVertex2(const DoubleVec3D& vertex) { vertex2 = vertex; computeArea(); }
 
 
+// Private method
+double Triangle::computeSphericalTriangle(const DoubleVec3D& origin, DoubleUnitVec3D& directionA, DoubleUnitVec3D& directionB, DoubleUnitVec3D& directionC, double& angleA) const {
+    directionA = vertex0 - origin;  // Normalised
+    directionB = vertex1 - origin;
+    directionC = vertex2 - origin;
+
+    // The angle at a vertex is the angle between the two great circles going through it
+    DoubleVec3D normalAB = crossProd(directionA, directionB);
+    DoubleVec3D normalBC = crossProd(directionB, directionC);
+    DoubleVec3D normalCA = crossProd(directionC, directionA);
+    double lengthAB = length(normalAB);
+    double lengthBC = length(normalBC);
+    double lengthCA = length(normalCA);
+    if (lengthAB == 0.0 || lengthBC == 0.0 || lengthCA == 0.0)  // Degenerate, origin is aligned with an edge
+        return 0.0;
+
+    auto angleBetween = [](double cosAngle) { return acos(std::max(-1.0, std::min(1.0, cosAngle))); };
+    angleA = angleBetween(-dotProd(normalAB, normalCA) / (lengthAB*lengthCA));
+    double angleB = angleBetween(-dotProd(normalBC, normalAB) / (lengthBC*lengthAB));
+    double angleC = angleBetween(-dotProd(normalCA, normalBC) / (lengthCA*lengthBC));
+    return angleA + angleB + angleC - M_PI;  // Girard's theorem
+}
+
+
 // Virtual methods
 void Triangle::computeArea() {
     DoubleVec3D edge1 = vertex1 - vertex0;
@@ -43,25 +69,12 @@ Object3D* Triangle::deepCopy() const {
     return new Triangle(vertex0, vertex1, vertex2, getMaterial()->deepCopy());
 }
 
+Object3D* Triangle::deepCopy(MemoryArena& arena) const {
+    return new (arena) Triangle(vertex0, vertex1, vertex2, getMaterial()->deepCopy(arena));
+}
+
 double Triangle::smallestPositiveIntersection(const Ray& ray) const {
-    // Using Mller-Trumbore intersection algorithm (using notations from https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm (accessed on 3rd July 2020)
-    // Return -1 if no intersection
-    DoubleVec3D edge1 = vertex1 - vertex0;
-    DoubleVec3D edge2 = vertex2 - vertex0;
-    DoubleVec3D h = crossProd(ray.getDirection(), edge2);
-    double a = dotProd(edge1, h);
-    if (a > -DBL_EPSILON && a < DBL_EPSILON)
-        return -1;  // Triangle and ray are parallel
-    double f = 1.0 / a;
-    DoubleVec3D s = ray.getOrigin() - vertex0;
-    double barycentricCoordU = f * dotProd(s, h);
-    if (barycentricCoordU < 0.0 || barycentricCoordU > 1.0)  // conditions for barycentric coordinates
-        return -1;
-    DoubleVec3D q = crossProd(s, edge1);
-    double barycentricCoordV = f * dotProd(ray.getDirection(), q);
-    if (barycentricCoordV < 0.0 || barycentricCoordU + barycentricCoordV > 1.0)  // conditions for barycentric coordinates
-        return -1;
-    return f * dotProd(edge2, q);
+    return intersectTriangle(ray, vertex0, vertex1 - vertex0, vertex2 - vertex0);
 }
 
 DoubleUnitVec3D Triangle::getNormal(const DoubleVec3D& point) const {
@@ -78,6 +91,47 @@ DoubleVec3D Triangle::getRandomPoint() const {
     return (1 - rand1)*vertex0 + rand1*(1 - rand2)*vertex1 + rand1*rand2*vertex2;
 }
 
+DoubleVec3D Triangle::sampleLightPoint(const DoubleVec3D& origin, double& pdf) const {
+    // Using James Arvo "Stratified Sampling of Spherical Triangles" (1995), with its notations
+    DoubleUnitVec3D directionA, directionB, directionC;
+    double alpha;
+    double solidAngle = computeSphericalTriangle(origin, directionA, directionB, directionC, alpha);
+    if (!(TRIANGLE_MIN_SPHERICAL_SAMPLING_SOLID_ANGLE < solidAngle && solidAngle < TRIANGLE_MAX_SPHERICAL_SAMPLING_SOLID_ANGLE))
+        return Object3D::sampleLightPoint(origin, pdf);
+    pdf = 1.0 / solidAngle;
+
+    // Sub-triangle of area sampledArea, which gives the new vertex sampledC on the arc from A to C
+    double sampledArea = randomDouble() * solidAngle;
+    double s = sin(sampledArea - alpha);
+    double t = cos(sampledArea - alpha);
+    double u = t - cos(alpha);
+    double v = s + sin(alpha)*dotProd(directionA, directionB);  // cos(c)
+    double q = ((v*t - u*s)*cos(alpha) - v) / ((v*s + u*t)*sin(alpha));
+    q = std::max(-1.0, std::min(1.0, q));
+    DoubleUnitVec3D tangentAC(directionC - dotProd(directionC, directionA)*directionA);
+    DoubleUnitVec3D sampledC(q*directionA + sqrt(1 - q*q)*tangentAC, true);
+
+    // Direction on the arc from B to sampledC
+    double z = 1 - randomDouble()*(1 - dotProd(sampledC, directionB));
+    z = std::max(-1.0, std::min(1.0, z));
+    DoubleUnitVec3D tangentBC(sampledC - dotProd(sampledC, directionB)*directionB);
+    DoubleUnitVec3D direction(z*directionB + sqrt(1 - z*z)*tangentBC, true);
+
+    // Intersection with the plane of the triangle
+    DoubleVec3D normal = crossProd(vertex1 - vertex0, vertex2 - vertex0);
+    double distance = dotProd(normal, vertex0 - origin) / dotProd(normal, direction);
+    return origin + distance*direction;
+}
+
+double Triangle::getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject) const {
+    DoubleUnitVec3D directionA, directionB, directionC;
+    double alpha;
+    double solidAngle = computeSphericalTriangle(origin, directionA, directionB, directionC, alpha);
+    if (!(TRIANGLE_MIN_SPHERICAL_SAMPLING_SOLID_ANGLE < solidAngle && solidAngle < TRIANGLE_MAX_SPHERICAL_SAMPLING_SOLID_ANGLE))
+        return Object3D::getLightPdf(origin, pointOnObject);
+    return 1.0 / solidAngle;
+}
+
 
 DoubleVec3D Triangle::getMinCoord() const {
     double minX = std::min(vertex0.getX(), std::min(vertex1.getX(), vertex2.getX()));
@@ -114,5 +168,6 @@ void Triangle::setLocationJson(const json& j) {
     vertex0 = j["Vertex0"].get<DoubleVec3D>();
     vertex1 = j["Vertex1"].get<DoubleVec3D>();
     vertex2 = j["Vertex2"].get<DoubleVec3D>();
+    computeArea();
 }
 
@@ -7,6 +7,12 @@
     \file Triangle.h
     \brief Defines the Triangle class.
 
+    \var constexpr double TRIANGLE_MIN_SPHERICAL_SAMPLING_SOLID_ANGLE
+    \brief Solid angle under which tiny or distant triangle lamps are sampled by area, since area sampling is then as good and the spherical triangle is not precise.
+
+    \var constexpr double TRIANGLE_MAX_SPHERICAL_SAMPLING_SOLID_ANGLE
+    \brief Solid angle over which triangle lamps are sampled by area, since the spherical triangle is then almost a hemisphere and is not precise.
+
     \class Triangle
     \brief A triangle defined by its three vertices.
     \details The order of its vertices is important. See the main constructor for more information.
@@ -70,6 +76,12 @@
     \brief Makes a deep copy of this object.
     \return A pointer to a deeply copied version of this object.
 
+    \fn Object3D* Triangle::deepCopy(MemoryArena& arena)
+    \brief Makes a deep copy of this object in an arena.
+    \details The material is copied in the same arena.
+    \param arena The arena in which the copy will be allocated.
+    \return A pointer to a deeply copied version of this object.
+
     \fn double Triangle::smallestPositiveIntersection(const Ray& ray)
     \brief Computes the smallest positive intersection between the ray and this object.
     \param ray The ray with wich we want to compute the intersection.
@@ -85,6 +97,29 @@
     \details Every point has the same probability to show up.
     \return A random point on this object.
 
+    \fn double Triangle::computeSphericalTriangle(const DoubleVec3D& origin, DoubleUnitVec3D& directionA, DoubleUnitVec3D& directionB, DoubleUnitVec3D& directionC, double& angleA)
+    \brief Projects this triangle on the unit sphere centered on origin.
+    \param origin The center of the unit sphere.
+    \param directionA Set to the direction from origin to vertex0.
+    \param directionB Set to the direction from origin to vertex1.
+    \param directionC Set to the direction from origin to vertex2.
+    \param angleA Set to the angle of the spherical triangle at directionA.
+    \return The area of the spherical triangle, which is the solid angle of this triangle seen from origin.
+
+    \fn DoubleVec3D Triangle::sampleLightPoint(const DoubleVec3D& origin, double& pdf)
+    \brief Computes a random point on the triangle, uniformly with respect to the solid angle seen from origin.
+    \details Uses the algorithm of Arvo (1995) to sample the spherical triangle, and then intersects the sampled direction with this triangle. If the solid angle is smaller than TRIANGLE_MIN_SPHERICAL_SAMPLING_SOLID_ANGLE or larger than TRIANGLE_MAX_SPHERICAL_SAMPLING_SOLID_ANGLE, the computation is not precise enough and falls back to Triangle::getRandomPoint().
+    \param origin The point from which the lamp is sampled.
+    \param pdf Set to the probability density of the point, with respect to solid angle.
+    \return A random point on this object.
+    \sa Triangle::getLightPdf()
+
+    \fn double Triangle::getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject)
+    \brief Computes the probability density with which Triangle::sampleLightPoint() returns a point.
+    \param origin The point from which the lamp is sampled.
+    \param pointOnObject The sampled point on this object.
+    \return One over the solid angle of the triangle seen from origin, or the density of the area sampling if it is used instead.
+
     \fn DoubleVec3D Triangle::getMinCoord()
     \brief Returns the minimum coordinate of a cuboid containing this object.
     \details For each axis, picks the smallest coordinate among the three vertices.
@@ -113,13 +148,20 @@
 
     \fn void Triangle::setLocationJson(const json& j)
     \brief Sets this object's location according to json.
+    \details Calls Triangle::computeArea().
     \param j The json input.
+    \sa Triangle::computeArea()
 */
 
+constexpr double TRIANGLE_MIN_SPHERICAL_SAMPLING_SOLID_ANGLE = 3e-4;
+constexpr double TRIANGLE_MAX_SPHERICAL_SAMPLING_SOLID_ANGLE = 6.22;
+
 class Triangle : public Object3D {
 private:
     DoubleVec3D vertex0, vertex1, vertex2;
 
+    double computeSphericalTriangle(const DoubleVec3D& origin, DoubleUnitVec3D& directionA, DoubleUnitVec3D& directionB, DoubleUnitVec3D& directionC, double& angleA) const;
+
 public:
     Triangle();
     Triangle(const DoubleVec3D& vertex0, const DoubleVec3D& vertex1, const DoubleVec3D& vertex2, Material* material);
@@ -136,10 +178,13 @@ public:
 
     void computeArea();
     Object3D* deepCopy() const;
+    Object3D* deepCopy(MemoryArena& arena) const;
 
     double smallestPositiveIntersection(const Ray& ray) const;
     DoubleUnitVec3D getNormal(const DoubleVec3D& point) const;
     DoubleVec3D getRandomPoint() const;
+    DoubleVec3D sampleLightPoint(const DoubleVec3D& origin, double& pdf) const;
+    double getLightPdf(const DoubleVec3D& origin, const DoubleVec3D& pointOnObject) const;
     DoubleVec3D getMinCoord() const;
     DoubleVec3D getMaxCoord() const;
 
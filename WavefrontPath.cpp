@@ -0,0 +1,18 @@
+#include "WavefrontPath.h"
+
+// Constructor
+WavefrontPath::WavefrontPath()
+    : throughput(1.0), radiance(0.0) {}
+
+
+// Function
+MaterialKind getMaterialKind(const Material* material) {
+    const std::type_info& type = typeid(*material);
+    if (type == typeid(DiffuseMaterial))
+        return MATERIAL_KIND_DIFFUSE;
+    if (type == typeid(SpecularMaterial))
+        return MATERIAL_KIND_SPECULAR;
+    if (type == typeid(RefractiveMaterial))
+        return MATERIAL_KIND_REFRACTIVE;
+    return MATERIAL_KIND_OTHER;
+}
@@ -0,0 +1,123 @@
+#ifndef DEF_WAVEFRONTPATH
+#define DEF_WAVEFRONTPATH
+
+#include <typeinfo>
+
+#include "KDTreeNode.h"
+
+/*!
+    \file WavefrontPath.h
+    \brief Defines the WavefrontPath and WavefrontShadowRay structs, the MaterialKind enum and a function around it.
+
+    \var constexpr unsigned int WAVEFRONT_QUEUE_SIZE
+    \brief Number of paths traced together by the wavefront path tracer. The pass is split into waves of this many paths.
+
+    \enum MaterialKind
+    \brief The kinds of materials by which the hits are sorted before being shaded. MATERIAL_KIND_OTHER is for materials that are none of the known ones.
+
+    \struct WavefrontPath
+    \brief The state of a path of the wavefront path tracer, between two stages.
+    \details It contains what traceRay() gives to its recursive call, plus the pixel sample to which the path belongs and the radiance it has gathered so far.
+    \sa Scene::getWavefrontPathTracing()
+
+    \var Ray WavefrontPath::ray
+    \brief The ray that will be extended during the next stage.
+
+    \var KDTreeNode::Intersection WavefrontPath::intersection
+    \brief The intersection of the ray, once it has been extended.
+
+    \var DoubleVec3D WavefrontPath::throughput
+    \brief The product of the weights of the bounces and of the russian roulette factors up to the current ray.
+
+    \var DoubleVec3D WavefrontPath::radiance
+    \brief The radiance gathered by the path so far.
+
+    \var unsigned int WavefrontPath::pixelX
+    \brief The *x* coordinate of the pixel of the path.
+
+    \var unsigned int WavefrontPath::pixelY
+    \brief The *y* coordinate of the pixel of the path.
+
+    \var unsigned int WavefrontPath::sample
+    \brief The index of the sample of the pixel.
+
+    \var unsigned int WavefrontPath::bounces
+    \brief The number of bounces done before the current ray.
+
+    \var double WavefrontPath::lastDirectionPdf
+    \brief The probability density with which the direction of the current ray was sampled, used for multiple importance sampling.
+
+    \var bool WavefrontPath::usedNextEventEstimation
+    \brief Whether next event estimation was used at the origin of the current ray.
+
+    \var bool WavefrontPath::active
+    \brief Whether the path still has a ray to extend.
+
+    \fn WavefrontPath::WavefrontPath()
+    \brief Default constructor. The path is not active.
+
+    \struct WavefrontShadowRay
+    \brief A shadow ray generated by the wavefront path tracer, traced with all the other ones of its stage.
+
+    \var Ray WavefrontShadowRay::ray
+    \brief The ray, going from the point of the path towards the point sampled on the lamp.
+
+    \var double WavefrontShadowRay::distance
+    \brief The distance to the point sampled on the lamp.
+
+    \var const KDTreeNode* WavefrontShadowRay::kdTreeNode
+    \brief The k-d tree node in which the origin of the ray is, nullptr if it is unknown.
+
+    \var DoubleVec3D WavefrontShadowRay::contribution
+    \brief The radiance added to the path if the lamp is not occluded.
+
+    \var unsigned int WavefrontShadowRay::path
+    \brief The index of the path in the wave.
+
+    \var bool WavefrontShadowRay::unoccluded
+    \brief Whether the ray reaches the lamp, once it has been traced.
+
+    \fn MaterialKind getMaterialKind(const Material* material)
+    \brief Finds the kind of a material, from its dynamic type.
+    \param material The material.
+    \return The kind of the material, MATERIAL_KIND_OTHER if it is none of the known ones.
+*/
+
+constexpr unsigned int WAVEFRONT_QUEUE_SIZE = 65536;
+
+enum MaterialKind {
+    MATERIAL_KIND_DIFFUSE,
+    MATERIAL_KIND_SPECULAR,
+    MATERIAL_KIND_REFRACTIVE,
+    MATERIAL_KIND_OTHER,
+    MATERIAL_KIND_NUMBER
+};
+
+struct WavefrontPath {
+    Ray ray;
+    KDTreeNode::Intersection intersection;
+    DoubleVec3D throughput;
+    DoubleVec3D radiance;
+    unsigned int pixelX = 0;
+    unsigned int pixelY = 0;
+    unsigned int sample = 0;
+    unsigned int bounces = 0;
+    double lastDirectionPdf = 0.0;
+    bool usedNextEventEstimation = false;
+    bool active = false;
+
+    WavefrontPath();
+};
+
+struct WavefrontShadowRay {
+    Ray ray;
+    double distance;
+    const KDTreeNode* kdTreeNode;
+    DoubleVec3D contribution;
+    unsigned int path;
+    bool unoccluded = false;
+};
+
+MaterialKind getMaterialKind(const Material* material);
+
+#endif
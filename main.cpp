@@ -1,8 +1,11 @@
+#include "CommandLine.h"
 #include "Interface.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1)
+        return renderFromCommandLine(argc, argv);
+
     initInterface();
 
     return 0;
 }
-